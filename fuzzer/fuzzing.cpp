@@ -10,6 +10,7 @@
 #include "doc/docundostack.hpp"
 #include "fakeit_standalone.hpp"
 #include "logger.hpp"
+#include <QUuid>
 #include <mlt++/MltFactory.h>
 #include <mlt++/MltProducer.h>
 #include <mlt++/MltProfile.h>
@@ -109,9 +110,10 @@ bool isIthParamARef(const rttr::method &method, size_t i)
 } // namespace
 } // namespace
 
-void fuzz(const std::string &input)
+void fuzz(const std::string &input, const ReplayOptions &options)
 {
     Logger::init();
+    Logger::setEnabled(options.trace);
     Logger::clear();
     std::stringstream ss;
     ss << input;
@@ -120,7 +122,6 @@ void fuzz(const std::string &input)
     auto binModel = pCore->projectItemModel();
     binModel->clean();
     std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
-    std::shared_ptr<MarkerListModel> guideModel = std::make_shared<MarkerListModel>(undoStack);
     KdenliveDoc::next_id = 0;
 
     Mock<ProjectManager> pmMock;
@@ -243,21 +244,36 @@ void fuzz(const std::string &input)
         id = modulo(id, (int)all_tracks[timeline].size());
         return all_tracks[timeline][id];
     };
+    // Run one operation, notifying the observer
+    auto execute = [&options](const std::string &operation, auto &&fn) {
+        if (options.observer) {
+            options.observer(operation, false);
+        }
+        fn();
+        if (options.observer) {
+            options.observer(operation, true);
+        }
+    };
     std::string c;
 
     while (ss >> c) {
         if (c == "u") {
-            std::cout << "UNDOING" << std::endl;
-            undoStack->undo();
+            if (options.verbose) {
+                std::cout << "UNDOING" << std::endl;
+            }
+            execute("undo", [&]() { undoStack->undo(); });
         } else if (c == "r") {
-            std::cout << "REDOING" << std::endl;
-            undoStack->redo();
-        } else if (Logger::back_translation_table.count(c) > 0) {
-            // std::cout << "found=" << c;
-            c = Logger::back_translation_table[c];
-            // std::cout << " translated=" << c << std::endl;
+            if (options.verbose) {
+                std::cout << "REDOING" << std::endl;
+            }
+            execute("redo", [&]() { undoStack->redo(); });
+        } else if (Logger::back_translation_table.count(c) > 0 || Logger::translation_table.count(c) > 0) {
+            // Operations are either given by their short code, or by their full name
+            if (Logger::back_translation_table.count(c) > 0) {
+                c = Logger::back_translation_table[c];
+            }
             if (c == "constr_TimelineModel") {
-                all_timelines.emplace_back(TimelineItemModel::construct(&profile, guideModel, undoStack));
+                execute(c, [&]() { all_timelines.emplace_back(TimelineItemModel::construct(QUuid::createUuid(), undoStack)); });
             } else if (c == "constr_ClipModel") {
                 auto timeline = get_timeline();
                 int id = 0, state_id;
@@ -276,7 +292,7 @@ void fuzz(const std::string &input)
                 }
                 state = static_cast<PlaylistState::ClipState>(state_id);
                 if (timeline && valid) {
-                    ClipModel::construct(timeline, binClip, -1, state, speed);
+                    execute(c, [&]() { ClipModel::construct(timeline, binClip, -1, state, speed); });
                 }
             } else if (c == "constr_TrackModel") {
                 auto timeline = get_timeline();
@@ -290,16 +306,16 @@ void fuzz(const std::string &input)
                 if (pos < -1) pos = 0;
                 pos = std::min((int)all_tracks[timeline].size(), pos);
                 if (timeline) {
-                    TrackModel::construct(timeline, -1, pos, QString::fromStdString(name), audio);
+                    execute(c, [&]() { TrackModel::construct(timeline, -1, pos, QString::fromStdString(name), audio); });
                 }
             } else if (c == "constr_test_producer") {
                 std::string color;
                 int length = 0;
                 bool limited = false;
                 ss >> color >> length >> limited;
-                createProducer(profile, color, binModel, length, limited);
+                execute(c, [&]() { createProducer(profile, color, binModel, length, limited); });
             } else if (c == "constr_test_producer_sound") {
-                createProducerWithSound(profile, binModel);
+                execute(c, [&]() { createProducerWithSound(profile, binModel); });
             } else {
                 // std::cout << "executing " << c << std::endl;
                 rttr::type target_type = rttr::type::get<int>();
@@ -365,6 +381,18 @@ void fuzz(const std::string &input)
                             valid = valid && (groupId >= 0);
                             arguments.emplace_back(groupId);
                             // std::cout << "got clipId" << clipId << std::endl;
+                        } else if (arg_name == "binClipId") {
+                            std::string binId;
+                            ss >> binId;
+                            QString binClip = QString::fromStdString(binId);
+                            if (!pCore->projectItemModel()->hasClip(binClip)) {
+                                if (pCore->projectItemModel()->getAllClipIds().size() == 0) {
+                                    valid = false;
+                                } else {
+                                    binClip = pCore->projectItemModel()->getAllClipIds()[0];
+                                }
+                            }
+                            arguments.emplace_back(binClip);
                         } else if (arg_name == "logUndo") {
                             bool a = false;
                             ss >> a;
@@ -452,7 +480,9 @@ void fuzz(const std::string &input)
                         }
                     }
                     if (valid) {
-                        std::cout << "VALID!!! " << target_method.get_name().to_string() << std::endl;
+                        if (options.verbose) {
+                            std::cout << "VALID!!! " << target_method.get_name().to_string() << std::endl;
+                        }
                         std::vector<rttr::argument> args;
                         args.reserve(arguments.size());
                         for (auto &a : arguments) {
@@ -462,19 +492,24 @@ void fuzz(const std::string &input)
                         for (const auto &p : target_method.get_parameter_infos()) {
                             // std::cout << "expected=" << p.get_type().get_name().to_string() << std::endl;
                         }
-                        rttr::variant res = target_method.invoke_variadic(ptr, args);
-                        if (res.is_valid()) {
-                            std::cout << "SUCCESS!!!" << std::endl;
-                        } else {
-                            std::cout << "!!!FAILLLLLL!!!" << std::endl;
+                        rttr::variant res;
+                        execute(c, [&]() { res = target_method.invoke_variadic(ptr, args); });
+                        if (options.verbose) {
+                            if (res.is_valid()) {
+                                std::cout << "SUCCESS!!!" << std::endl;
+                            } else {
+                                std::cout << "!!!FAILLLLLL!!!" << std::endl;
+                            }
                         }
                     }
                 }
             }
         }
         update_elems();
-        for (const auto &t : all_timelines) {
-            assert(t->checkConsistency());
+        if (options.checkConsistency) {
+            for (const auto &t : all_timelines) {
+                assert(t->checkConsistency());
+            }
         }
     }
     undoStack->clear();
@@ -489,7 +524,9 @@ void fuzz(const std::string &input)
     pCore->m_projectManager = nullptr;
     Core::m_self.reset();
     MltConnection::m_self.reset();
-    std::cout << "---------------------------------------------------------------------------------------------------------------------------------------------"
-                 "---------------"
-              << std::endl;
+    if (options.verbose) {
+        std::cout << "---------------------------------------------------------------------------------------------------------------------------------------------"
+                     "---------------"
+                  << std::endl;
+    }
 }
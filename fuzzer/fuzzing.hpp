@@ -7,6 +7,22 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
-void fuzz(const std::string &input);
+/** @brief Options of a replay. The defaults are the ones used by the fuzzer */
+struct ReplayOptions
+{
+    /** @brief Check the consistency of all timelines after each operation */
+    bool checkConsistency{true};
+    /** @brief Print the replayed operations on the standard output */
+    bool verbose{true};
+    /** @brief Record the replayed operations with the model logger, so that they can be dumped with Logger::print_trace() */
+    bool trace{true};
+    /** @brief If set, called right before (finished = false) and right after (finished = true) the execution of each operation */
+    std::function<void(const std::string &operation, bool finished)> observer;
+};
+
+/** @brief Replays a trace in the format written by Logger::print_trace().
+ * Operations can be given either by their short code or by their full name, for example "requestClipMove" */
+void fuzz(const std::string &input, const ReplayOptions &options = ReplayOptions());
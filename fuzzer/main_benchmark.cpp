@@ -0,0 +1,331 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    This file is part of Kdenlive. See www.kdenlive.org.
+
+    SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+/* Replays editing sessions written in the model logger format against the timeline model, and reports the time spent and the
+   number of memory allocations of each operation as JSON. Besides the built-in sessions, traces recorded with Logger::print_trace()
+   (fuzz_case_*.txt) can be passed on the command line.
+   Timings are only meaningful in a release build without sanitizers, so don't enable BUILD_FUZZING together with this target. */
+
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "fuzzing.hpp"
+#include "mltconnection.h"
+#include <../config-kdenlive.h>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mlt++/MltFactory.h>
+#include <mlt++/MltRepository.h>
+#include <new>
+#include <sstream>
+
+// Count all allocations of the process, so that we can report the allocations of each operation
+static std::atomic<quint64> allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+// Length of the clips of the sessions, in frames
+const int clipLength = 20;
+
+/* Items are referred to by their index in the sorted list of existing items, see fuzz().
+   A negative reference is never a valid id, so it is always resolved as an index, counting from the end */
+int ref(int index, int count)
+{
+    return index - count;
+}
+
+// A timeline with one color clip in the bin and the given number of video tracks
+std::string prelude(int tracks)
+{
+    std::stringstream ss;
+    ss << "constr_TimelineModel\n";
+    ss << "constr_test_producer red " << clipLength << " 0\n";
+    for (int i = 0; i < tracks; ++i) {
+        ss << "requestTrackInsertion 0 -1 $$ 0\n";
+    }
+    return ss.str();
+}
+
+// Insert count clips on a track, starting at a position with the given spacing
+void insertClips(std::stringstream &ss, int track, int tracks, int count, int start, int spacing)
+{
+    for (int i = 0; i < count; ++i) {
+        ss << "requestClipInsertion 0 0 " << ref(track, tracks) << " " << (start + i * spacing) << " 1 1 0\n";
+    }
+}
+
+// 2000 clips inserted on 4 tracks, then grouped per track
+std::string largePaste()
+{
+    const int tracks = 4;
+    const int perTrack = 500;
+    std::stringstream ss;
+    ss << prelude(tracks);
+    for (int t = 0; t < tracks; ++t) {
+        insertClips(ss, t, tracks, perTrack, 0, clipLength);
+    }
+    const int clips = tracks * perTrack;
+    for (int t = 0; t < tracks; ++t) {
+        ss << "requestClipsGroup 0 " << perTrack;
+        for (int i = 0; i < perTrack; ++i) {
+            ss << " " << ref(t * perTrack + i, clips);
+        }
+        ss << " 1 0\n";
+    }
+    return ss.str();
+}
+
+// Delete 300 clips in the middle of a 1000 clips track, and close the resulting gaps
+std::string rippleDelete()
+{
+    int clips = 1000;
+    std::stringstream ss;
+    ss << prelude(1);
+    insertClips(ss, 0, 1, clips, 0, clipLength);
+    for (int i = 0; i < 300; ++i) {
+        const int index = clips / 2;
+        ss << "requestItemDeletion 0 " << ref(index, clips) << " 1\n";
+        clips--;
+        ss << "requestDeleteBlankAt 0 " << ref(0, 1) << " " << (index * clipLength) << " 0\n";
+    }
+    return ss.str();
+}
+
+// Drag a group of 200 clips back and forth, with another busy track
+std::string groupDrag()
+{
+    const int grouped = 200;
+    std::stringstream ss;
+    ss << prelude(2);
+    insertClips(ss, 0, 2, grouped, 0, clipLength);
+    insertClips(ss, 0, 2, 300, 10000, clipLength);
+    insertClips(ss, 1, 2, 500, 0, clipLength);
+    const int clips = grouped + 300 + 500;
+    ss << "requestClipsGroup 0 " << grouped;
+    for (int i = 0; i < grouped; ++i) {
+        ss << " " << ref(i, clips);
+    }
+    ss << " 1 0\n";
+    for (int i = 0; i < 200; ++i) {
+        const int delta = i < 100 ? clipLength : -clipLength;
+        ss << "requestGroupMove 0 " << ref(0, clips) << " " << ref(0, 1) << " 0 " << delta << " 0 1 1 0\n";
+    }
+    return ss.str();
+}
+
+// 300 clip moves, then the whole history is undone and redone several times
+std::string undoStorm()
+{
+    const int clips = 500;
+    const int moves = 300;
+    std::stringstream ss;
+    ss << prelude(1);
+    insertClips(ss, 0, 1, clips, 0, 2 * clipLength);
+    for (int i = 0; i < moves; ++i) {
+        ss << "requestClipMove 0 " << ref(i, clips) << " " << ref(0, 1) << " " << (i * 2 * clipLength + clipLength / 2) << " 0 1 1 1 0\n";
+    }
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < moves; ++i) {
+            ss << "u\n";
+        }
+        for (int i = 0; i < moves; ++i) {
+            ss << "r\n";
+        }
+    }
+    return ss.str();
+}
+
+// Resize, speed change and cut of 300 clips
+std::string trimAndSpeed()
+{
+    int clips = 300;
+    std::stringstream ss;
+    ss << prelude(1);
+    insertClips(ss, 0, 1, clips, 0, 2 * clipLength);
+    for (int i = 0; i < 300; ++i) {
+        ss << "requestItemResize 0 " << ref(i, clips) << " " << (clipLength + clipLength / 2) << " 1 1 -1 1\n";
+        ss << "requestClipTimeWarp 0 " << ref(i, clips) << " 2 0 1\n";
+        ss << "requestClipTimeWarp 0 " << ref(i, clips) << " 1 0 1\n";
+        ss << "requestClipCut 0 " << ref(i, clips) << " " << (i * 2 * clipLength + clipLength / 2) << "\n";
+        // The cut creates a new clip, with a higher id
+        clips++;
+    }
+    return ss.str();
+}
+
+struct OperationStats
+{
+    qint64 count{0};
+    qint64 totalNs{0};
+    qint64 minNs{std::numeric_limits<qint64>::max()};
+    qint64 maxNs{0};
+    quint64 allocations{0};
+};
+
+QJsonObject replay(const QString &name, const std::string &session, int repeat)
+{
+    std::map<std::string, OperationStats> stats;
+    QElapsedTimer timer;
+    quint64 allocationsBefore = 0;
+    ReplayOptions options;
+    options.checkConsistency = false;
+    options.verbose = false;
+    options.trace = false;
+    options.observer = [&](const std::string &operation, bool finished) {
+        if (!finished) {
+            allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            timer.start();
+            return;
+        }
+        const qint64 elapsed = timer.nsecsElapsed();
+        OperationStats &op = stats[operation];
+        op.count++;
+        op.totalNs += elapsed;
+        op.minNs = std::min(op.minNs, elapsed);
+        op.maxNs = std::max(op.maxNs, elapsed);
+        op.allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+    };
+
+    QElapsedTimer sessionTimer;
+    qint64 sessionNs = 0;
+    for (int i = 0; i < repeat; ++i) {
+        // fuzz() destroys the core when it is done
+        Core::build(LinuxPackageType::Unknown, true);
+        MltConnection::construct(QString());
+        pCore->projectItemModel()->buildPlaylist(QUuid());
+        sessionTimer.start();
+        fuzz(session, options);
+        sessionNs += sessionTimer.nsecsElapsed();
+    }
+
+    QJsonObject operations;
+    qint64 totalNs = 0;
+    qint64 totalCount = 0;
+    quint64 totalAllocations = 0;
+    for (const auto &op : stats) {
+        const OperationStats &s = op.second;
+        QJsonObject entry;
+        entry.insert(QLatin1String("count"), s.count / repeat);
+        entry.insert(QLatin1String("total_ns"), s.totalNs / repeat);
+        entry.insert(QLatin1String("mean_ns"), s.totalNs / s.count);
+        entry.insert(QLatin1String("min_ns"), s.minNs);
+        entry.insert(QLatin1String("max_ns"), s.maxNs);
+        entry.insert(QLatin1String("allocations"), qint64(s.allocations / quint64(repeat)));
+        entry.insert(QLatin1String("mean_allocations"), double(s.allocations) / double(s.count));
+        operations.insert(QString::fromStdString(op.first), entry);
+        totalNs += s.totalNs;
+        totalCount += s.count;
+        totalAllocations += s.allocations;
+    }
+    QJsonObject result;
+    result.insert(QLatin1String("name"), name);
+    result.insert(QLatin1String("repeat"), repeat);
+    result.insert(QLatin1String("operations_count"), totalCount / repeat);
+    result.insert(QLatin1String("operations_ns"), totalNs / repeat);
+    result.insert(QLatin1String("wall_ns"), sessionNs / repeat);
+    result.insert(QLatin1String("allocations"), qint64(totalAllocations / quint64(repeat)));
+    result.insert(QLatin1String("operations"), operations);
+    std::cerr << name.toStdString() << ": " << (totalCount / repeat) << " operations in " << (totalNs / repeat / 1000000) << " ms, "
+              << (totalAllocations / quint64(repeat)) << " allocations" << std::endl;
+    return result;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    QHashSeed::setDeterministicGlobalSeed();
+    QApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("kdenlive"));
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replay editing sessions against the Kdenlive timeline model and report their cost"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("traces"), QStringLiteral("Recorded traces to replay in addition to the built-in sessions."),
+                                 QStringLiteral("[trace...]"));
+    QCommandLineOption outputOption(QStringLiteral("output"), QStringLiteral("Write the JSON results to this file instead of the standard output."),
+                                    QStringLiteral("file"));
+    QCommandLineOption repeatOption(QStringLiteral("repeat"), QStringLiteral("Number of replays of each session."), QStringLiteral("count"),
+                                    QStringLiteral("3"));
+    QCommandLineOption sessionOption(QStringLiteral("session"), QStringLiteral("Only replay the built-in sessions with this name, can be repeated."),
+                                     QStringLiteral("name"));
+    parser.addOption(outputOption);
+    parser.addOption(repeatOption);
+    parser.addOption(sessionOption);
+    parser.process(app);
+
+    std::unique_ptr<Mlt::Repository> repo(Mlt::Factory::init(nullptr));
+    qputenv("MLT_TESTS", QByteArray("1"));
+
+    const int repeat = std::max(1, parser.value(repeatOption).toInt());
+    const QStringList selected = parser.values(sessionOption);
+    const std::vector<std::pair<QString, std::string (*)()>> builtins = {{QStringLiteral("large_paste"), &largePaste},
+                                                                          {QStringLiteral("ripple_delete"), &rippleDelete},
+                                                                          {QStringLiteral("group_drag"), &groupDrag},
+                                                                          {QStringLiteral("undo_storm"), &undoStorm},
+                                                                          {QStringLiteral("trim_and_speed"), &trimAndSpeed}};
+    QJsonArray sessions;
+    for (const auto &session : builtins) {
+        if (selected.isEmpty() || selected.contains(session.first)) {
+            sessions.append(replay(session.first, session.second(), repeat));
+        }
+    }
+    const QStringList traces = parser.positionalArguments();
+    for (const QString &path : traces) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::cerr << "Cannot read trace " << path.toStdString() << std::endl;
+            return 1;
+        }
+        sessions.append(replay(QFileInfo(path).fileName(), file.readAll().toStdString(), repeat));
+    }
+
+    QJsonObject results;
+    results.insert(QLatin1String("version"), QStringLiteral(KDENLIVE_VERSION));
+    results.insert(QLatin1String("qt"), QString::fromLatin1(qVersion()));
+    results.insert(QLatin1String("mlt"), QString::fromLatin1(mlt_version_get_string()));
+    results.insert(QLatin1String("cpu"), QSysInfo::currentCpuArchitecture());
+    results.insert(QLatin1String("sessions"), sessions);
+    const QByteArray json = QJsonDocument(results).toJson();
+    if (parser.isSet(outputOption)) {
+        QFile output(parser.value(outputOption));
+        if (!output.open(QIODevice::WriteOnly) || output.write(json) != json.size()) {
+            std::cerr << "Cannot write results to " << parser.value(outputOption).toStdString() << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << json.constData();
+    }
+    return 0;
+}
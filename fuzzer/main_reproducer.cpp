@@ -31,7 +31,7 @@ int main(int argc, char **argv)
     signal(SIGSEGV, signalHandler);
     QApplication app(argc, argv);
     qputenv("MLT_TESTS", QByteArray("1"));
-    Core::build(false);
+    Core::build(LinuxPackageType::Unknown, true);
     std::stringstream ss;
     std::string str;
     while (getline(std::cin, str)) {
@@ -6,13 +6,18 @@
 
 #include "../src/lib/localeHandling.h"
 #include "mlt++/Mlt.h"
+#include "renderdaemon.h"
 #include "renderjob.h"
+#include "renderworker.h"
 #include <../config-kdenlive.h>
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QDebug>
 #include <QDir>
 #include <QDomDocument>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTemporaryFile>
 #include <QtGlobal>
 
@@ -31,7 +36,7 @@ int main(int argc, char **argv)
     parser.addHelpOption();
     parser.addVersionOption();
 
-    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\" or \"preview-chunks\".");
+    parser.addPositionalArgument("mode", "Render mode. Either \"delivery\", \"concat\", \"daemon\", \"worker\" or \"preview-chunks\".");
     parser.parse(QCoreApplication::arguments());
     QStringList args = parser.positionalArguments();
     const QString mode = args.isEmpty() ? QString() : args.first();
@@ -168,6 +173,9 @@ int main(int argc, char **argv)
         QCommandLineOption debugOption("debug", "Enable debug mode, doesn't delete log file on render success.");
         parser.addOption(debugOption);
 
+        QCommandLineOption manifestOption("manifest", "Segments manifest, if this render is a segment of a segmented render.", "file");
+        parser.addOption(manifestOption);
+
         parser.process(app);
         args = parser.positionalArguments();
 
@@ -237,6 +245,9 @@ int main(int argc, char **argv)
         bool debugMode = parser.isSet(debugOption);
 
         auto *rJob = new RenderJob(render, playlist, target, pid, in, out, subtitleFile, debugMode, &app);
+        if (parser.isSet(manifestOption)) {
+            rJob->setManifest(parser.value(manifestOption));
+        }
         QObject::connect(rJob, &RenderJob::renderingFinished, rJob, [&]() {
             rJob->deleteLater();
             qApp->quit();
@@ -246,6 +257,144 @@ int main(int argc, char **argv)
         return app.exec();
     }
 
+    if (mode == "concat") {
+        parser.clearPositionalArguments();
+        parser.addPositionalArgument("concat", "Mode: Join the segments of a segmented render without re-encoding.");
+        parser.addPositionalArgument("ffmpeg", "Path to FFmpeg.");
+        parser.addPositionalArgument("manifest", "Segments manifest (JSON).");
+
+        QCommandLineOption pidOption("pid", "Process ID to send back progress.", "pid", QString::number(-1));
+        parser.addOption(pidOption);
+
+        QCommandLineOption subtitleOption("subtitle", "Subtitle file.", "file");
+        parser.addOption(subtitleOption);
+
+        QCommandLineOption debugOption("debug", "Enable debug mode, doesn't delete log file and segments on success.");
+        parser.addOption(debugOption);
+
+        QCommandLineOption outputOption("output", "The joined file, used to report errors if the manifest cannot be read.", "file");
+        parser.addOption(outputOption);
+
+        parser.process(app);
+        args = parser.positionalArguments();
+
+        if (args.count() != 3) {
+            qCritical() << "Error: wrong number of arguments specified\n";
+            parser.showHelp(1);
+            // the command above will quit the app with return 1;
+        }
+
+        // mode
+        args.removeFirst();
+        QString ffmpeg = args.takeFirst();
+        QString manifestPath = args.takeFirst();
+        QJsonObject manifest;
+        QString error;
+        QFile f(manifestPath);
+        if (!f.open(QIODevice::ReadOnly)) {
+            qWarning() << "Failed to open file" << f.fileName() << "for reading";
+            error = QStringLiteral("Cannot read the segments manifest %1.").arg(manifestPath);
+        } else {
+            manifest = QJsonDocument::fromJson(f.readAll()).object();
+            f.close();
+        }
+        QString target = manifest.value(QLatin1String("output")).toString();
+        if (target.isEmpty()) {
+            if (error.isEmpty()) {
+                qWarning() << "Invalid segments manifest" << f.fileName();
+                error = QStringLiteral("Invalid segments manifest %1.").arg(manifestPath);
+            }
+            target = parser.value(outputOption);
+        }
+        QStringList segments;
+        const QJsonArray segmentList = manifest.value(QLatin1String("segments")).toArray();
+        for (const auto &segment : segmentList) {
+            if (!segment.toObject().value(QLatin1String("done")).toBool() && error.isEmpty()) {
+                qWarning() << "Segment" << segment.toObject().value(QLatin1String("file")).toString() << "is not complete";
+                error = QStringLiteral("Segment %1 is not complete, cannot join the segmented render.").arg(segment.toObject().value(QLatin1String("file")).toString());
+            }
+            segments << segment.toObject().value(QLatin1String("file")).toString();
+        }
+        int in = manifest.value(QLatin1String("in")).toInt();
+        int out = manifest.value(QLatin1String("out")).toInt();
+        int pid = parser.value(pidOption).toInt();
+        QString subtitleFile = parser.value(subtitleOption);
+        bool debugMode = parser.isSet(debugOption);
+
+        if (target.isEmpty()) {
+            // We cannot tell Kdenlive which job failed
+            qWarning() << error;
+            return 1;
+        }
+        // The job is created even if the manifest is unusable, it reports the error to Kdenlive
+        auto *rJob = new RenderJob(ffmpeg, manifestPath, target, pid, in, out, subtitleFile, debugMode, &app);
+        if (error.isEmpty()) {
+            rJob->setSegments(segments, manifest.value(QLatin1String("audio")).toString());
+        } else {
+            rJob->setError(error);
+        }
+        QObject::connect(rJob, &RenderJob::renderingFinished, rJob, [&]() {
+            rJob->deleteLater();
+            qApp->quit();
+        });
+        QMetaObject::invokeMethod(rJob, "start", Qt::QueuedConnection);
+        return app.exec();
+    }
+
+    if (mode == "daemon") {
+        parser.clearPositionalArguments();
+        parser.addPositionalArgument("daemon", "Mode: Wait for render requests sent as JSON on a local socket.");
+
+        QCommandLineOption socketOption("socket", "Name of the local socket accepting render requests.", "name", QStringLiteral("org.kde.kdenlive-render"));
+        parser.addOption(socketOption);
+
+        QCommandLineOption jobsOption("jobs", "Maximum number of concurrent render jobs, each one uses a persistent worker process.", "count",
+                                      QString::number(1));
+        parser.addOption(jobsOption);
+
+        QCommandLineOption debugOption("debug", "Enable debug mode, render playlists are kept and workers print their output.");
+        parser.addOption(debugOption);
+
+        parser.process(app);
+        args = parser.positionalArguments();
+        if (args.count() != 1) {
+            qCritical() << "Error: wrong number of arguments specified\n";
+            parser.showHelp(1);
+            // the command above will quit the app with return 1;
+        }
+        RenderDaemon daemon(parser.value(socketOption), parser.value(jobsOption).toInt(), parser.isSet(debugOption));
+        if (!daemon.isListening()) {
+            return 1;
+        }
+        return app.exec();
+    }
+
+    if (mode == "worker") {
+        parser.clearPositionalArguments();
+        parser.addPositionalArgument("worker", "Mode: Render the requests of a render daemon, started by the daemon.");
+
+        QCommandLineOption serverOption("server", "Name of the local socket of the daemon.", "name");
+        parser.addOption(serverOption);
+
+        QCommandLineOption idOption("id", "Worker id given by the daemon.", "id");
+        parser.addOption(idOption);
+
+        parser.process(app);
+        if (!parser.isSet(serverOption) || !parser.isSet(idOption)) {
+            qCritical() << "Error: the daemon socket and worker id are required\n";
+            parser.showHelp(1);
+            // the command above will quit the app with return 1;
+        }
+        // MLT is only initialized once for all the renders of this worker
+        Mlt::Factory::init();
+        LocaleHandling::resetAllLocale();
+        RenderWorker worker(parser.value(idOption).toInt());
+        if (!worker.connectToDaemon(parser.value(serverOption))) {
+            return 1;
+        }
+        return app.exec();
+    }
+
     qCritical() << "Error: unknown mode" << mode << "\n";
     parser.showHelp(1);
     // the command above will quit the app with return 1;
@@ -0,0 +1,392 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "renderdaemon.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QDomDocument>
+#include <QDomNamedNodeMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <algorithm>
+
+RenderDaemon::RenderDaemon(const QString &serverName, int maxJobs, bool debugMode, QObject *parent)
+    : QObject(parent)
+    , m_maxJobs(qMax(1, maxJobs))
+    , m_debugMode(debugMode)
+{
+    m_clientServer.setSocketOptions(QLocalServer::UserAccessOption);
+    m_workerServer.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_clientServer.listen(serverName)) {
+        qWarning() << "Render daemon failed to listen on" << serverName << m_clientServer.errorString();
+        return;
+    }
+    const QString workerName = QStringLiteral("%1-workers-%2").arg(serverName).arg(QCoreApplication::applicationPid());
+    if (!m_workerServer.listen(workerName)) {
+        qWarning() << "Render daemon failed to listen on" << workerName << m_workerServer.errorString();
+        m_clientServer.close();
+        return;
+    }
+    connect(&m_clientServer, &QLocalServer::newConnection, this, &RenderDaemon::clientConnected);
+    connect(&m_workerServer, &QLocalServer::newConnection, this, &RenderDaemon::workerConnected);
+    qDebug() << "Render daemon listening on" << m_clientServer.fullServerName() << "with" << m_maxJobs << "workers";
+}
+
+RenderDaemon::~RenderDaemon()
+{
+    for (auto &worker : m_workers) {
+        if (worker.second.process) {
+            worker.second.process->disconnect(this);
+            worker.second.process->kill();
+            worker.second.process->waitForFinished(1000);
+        }
+    }
+    if (!m_debugMode) {
+        for (const Job &job : m_jobs) {
+            QFile::remove(job.playlist);
+        }
+    }
+}
+
+bool RenderDaemon::isListening() const
+{
+    return m_clientServer.isListening() && m_workerServer.isListening();
+}
+
+QString RenderDaemon::workerServerName() const
+{
+    return m_workerServer.serverName();
+}
+
+void RenderDaemon::clientConnected()
+{
+    while (QLocalSocket *client = m_clientServer.nextPendingConnection()) {
+        connect(client, &QLocalSocket::readyRead, this,
+                [this, client]() { readJson(client, [this, client](const QJsonObject &json) { handleRequest(json, client); }); });
+        connect(client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+    }
+}
+
+void RenderDaemon::workerConnected()
+{
+    while (QLocalSocket *socket = m_workerServer.nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this,
+                [this, socket]() { readJson(socket, [this, socket](const QJsonObject &json) { handleWorkerMessage(json, socket); }); });
+        connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+            auto it = std::find_if(m_workers.begin(), m_workers.end(), [socket](const auto &worker) { return worker.second.socket == socket; });
+            if (it != m_workers.end()) {
+                workerExited(it->first, tr("Render worker disconnected"));
+            }
+            socket->deleteLater();
+        });
+    }
+}
+
+void RenderDaemon::readJson(QLocalSocket *socket, const std::function<void(const QJsonObject &)> &handler)
+{
+    QTextStream text(socket);
+    QString block, line;
+    while (text.readLineInto(&line)) {
+        block.append(line);
+        if (line == QLatin1String("}")) { // end of json object
+            QJsonParseError error;
+            const QJsonObject json = QJsonDocument::fromJson(block.toUtf8(), &error).object();
+            block.clear();
+            if (error.error != QJsonParseError::NoError) {
+                qWarning() << "Render daemon receive error: " << error.errorString();
+                continue;
+            }
+            handler(json);
+        }
+    }
+}
+
+void RenderDaemon::send(QLocalSocket *socket, const QString &method, const QJsonObject &args)
+{
+    if (!socket || socket->state() != QLocalSocket::ConnectedState) {
+        return;
+    }
+    QJsonObject message;
+    message[method] = args;
+    socket->write(QJsonDocument(message).toJson());
+    socket->flush();
+}
+
+void RenderDaemon::handleRequest(const QJsonObject &json, QLocalSocket *client)
+{
+    if (json.contains(QLatin1String("abort"))) {
+        abortJob(json.value(QLatin1String("abort")).toObject().value(QLatin1String("id")).toString(), client);
+    }
+    if (!json.contains(QLatin1String("render"))) {
+        return;
+    }
+    const QJsonObject request = json.value(QLatin1String("render")).toObject();
+    Job job;
+    job.id = request.value(QLatin1String("id")).toString();
+    if (job.id.isEmpty()) {
+        job.id = QString::number(++m_lastId);
+    }
+    job.client = client;
+    const QString error = preparePlaylist(request, job);
+    if (!error.isEmpty()) {
+        QJsonObject args;
+        args[QLatin1String("id")] = job.id;
+        args[QLatin1String("message")] = error;
+        send(client, QStringLiteral("error"), args);
+        return;
+    }
+    m_jobs.push_back(job);
+    QJsonObject args;
+    args[QLatin1String("id")] = job.id;
+    args[QLatin1String("output")] = job.output;
+    args[QLatin1String("position")] = int(std::count_if(m_jobs.cbegin(), m_jobs.cend(), [](const Job &j) { return j.worker < 0; }));
+    send(client, QStringLiteral("queued"), args);
+    processQueue();
+}
+
+QString RenderDaemon::preparePlaylist(const QJsonObject &request, Job &job)
+{
+    const QString source = request.value(QLatin1String("source")).toString();
+    QFile file(source);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return tr("Cannot read project %1").arg(source);
+    }
+    QDomDocument doc;
+    if (!doc.setContent(&file)) {
+        return tr("Cannot parse project %1").arg(source);
+    }
+    file.close();
+    QDomElement root = doc.documentElement();
+    if (root.tagName() != QLatin1String("mlt")) {
+        return tr("%1 is not a MLT playlist").arg(source);
+    }
+    if (!root.hasAttribute(QStringLiteral("root"))) {
+        // The playlist is moved to the temporary folder, keep relative resources working
+        root.setAttribute(QStringLiteral("root"), QFileInfo(source).absolutePath());
+    }
+    // The workers create the consumer themselves, from the consumer of the playlist and the preset
+    job.service = QStringLiteral("avformat");
+    QString output = request.value(QLatin1String("output")).toString();
+    QDomElement consumer = root.firstChildElement(QStringLiteral("consumer"));
+    if (!consumer.isNull()) {
+        const QDomNamedNodeMap attributes = consumer.attributes();
+        for (int i = 0; i < attributes.count(); ++i) {
+            const QDomAttr attribute = attributes.item(i).toAttr();
+            job.properties[attribute.name()] = attribute.value();
+        }
+        root.removeChild(consumer);
+    }
+    // The preset uses the same syntax as the Kdenlive render presets: space separated key=value pairs
+    const QStringList params = request.value(QLatin1String("preset")).toString().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    for (const QString &param : params) {
+        if (param.contains(QLatin1Char('='))) {
+            job.properties[param.section(QLatin1Char('='), 0, 0)] = param.section(QLatin1Char('='), 1);
+        }
+    }
+    if (job.properties.contains(QLatin1String("mlt_service"))) {
+        job.service = job.properties.take(QLatin1String("mlt_service")).toString();
+    }
+    job.in = request.contains(QLatin1String("in")) ? request.value(QLatin1String("in")).toInt()
+                                                   : job.properties.value(QLatin1String("in")).toString(QStringLiteral("-1")).toInt();
+    job.out = request.contains(QLatin1String("out")) ? request.value(QLatin1String("out")).toInt()
+                                                     : job.properties.value(QLatin1String("out")).toString(QStringLiteral("-1")).toInt();
+    job.properties.remove(QLatin1String("in"));
+    job.properties.remove(QLatin1String("out"));
+    if (output.isEmpty()) {
+        output = job.properties.value(QLatin1String("target")).toString();
+    }
+    job.properties.remove(QLatin1String("target"));
+    if (output.isEmpty()) {
+        return tr("No output file for %1").arg(source);
+    }
+    job.output = QFileInfo(output).absoluteFilePath();
+    if (findJob(job.output) != m_jobs.end()) {
+        return tr("%1 is already being rendered").arg(job.output);
+    }
+    QTemporaryFile tmp(QDir::temp().absoluteFilePath(QStringLiteral("kdenlive-XXXXXX.mlt")));
+    tmp.setAutoRemove(false);
+    if (!tmp.open()) {
+        return tr("Cannot create a temporary playlist");
+    }
+    tmp.write(doc.toByteArray());
+    tmp.close();
+    job.playlist = tmp.fileName();
+    return QString();
+}
+
+void RenderDaemon::startWorker(int id)
+{
+    const QStringList args = {QStringLiteral("worker"), QStringLiteral("--server"), workerServerName(), QStringLiteral("--id"), QString::number(id)};
+    auto *process = new QProcess(this);
+    if (m_debugMode) {
+        process->setProcessChannelMode(QProcess::ForwardedChannels);
+    } else {
+        process->setStandardOutputFile(QProcess::nullDevice());
+        process->setStandardErrorFile(QProcess::nullDevice());
+    }
+    m_workers[id].process = process;
+    connect(process, &QProcess::finished, this, [this, id](int exitCode, QProcess::ExitStatus status) {
+        workerExited(id, tr("Render worker exited unexpectedly (exit code %1)").arg(status == QProcess::CrashExit ? -1 : exitCode));
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, id](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            workerExited(id, tr("Cannot start a render worker"));
+        }
+    });
+    process->start(QCoreApplication::applicationFilePath(), args);
+}
+
+void RenderDaemon::workerExited(int id, const QString &error)
+{
+    auto worker = m_workers.find(id);
+    if (worker == m_workers.end()) {
+        return;
+    }
+    if (worker->second.process) {
+        worker->second.process->disconnect(this);
+        worker->second.process->kill();
+        worker->second.process->deleteLater();
+    }
+    if (worker->second.socket) {
+        worker->second.socket->disconnect(this);
+        worker->second.socket->abort();
+        worker->second.socket->deleteLater();
+    }
+    const QString output = worker->second.output;
+    m_workers.erase(worker);
+    if (!output.isEmpty()) {
+        auto job = findJob(output);
+        if (job != m_jobs.end()) {
+            finishJob(job, -2, error);
+        }
+    }
+    processQueue();
+}
+
+void RenderDaemon::processQueue()
+{
+    // Workers that are starting will take the first queued jobs
+    int starting = int(std::count_if(m_workers.cbegin(), m_workers.cend(), [](const auto &worker) { return worker.second.socket.isNull(); }));
+    for (Job &job : m_jobs) {
+        if (job.worker >= 0) {
+            continue;
+        }
+        auto idle = std::find_if(m_workers.begin(), m_workers.end(),
+                                 [](const auto &worker) { return !worker.second.socket.isNull() && worker.second.output.isEmpty(); });
+        if (idle != m_workers.end()) {
+            job.worker = idle->first;
+            idle->second.output = job.output;
+            QJsonObject args;
+            args[QLatin1String("playlist")] = job.playlist;
+            args[QLatin1String("output")] = job.output;
+            args[QLatin1String("service")] = job.service;
+            args[QLatin1String("properties")] = job.properties;
+            args[QLatin1String("in")] = job.in;
+            args[QLatin1String("out")] = job.out;
+            send(idle->second.socket, QStringLiteral("render"), args);
+            continue;
+        }
+        if (starting > 0) {
+            starting--;
+            continue;
+        }
+        if (int(m_workers.size()) >= m_maxJobs) {
+            break;
+        }
+        const int id = ++m_lastWorkerId;
+        m_workers[id] = Worker();
+        startWorker(id);
+    }
+}
+
+void RenderDaemon::handleWorkerMessage(const QJsonObject &json, QLocalSocket *socket)
+{
+    if (json.contains(QLatin1String("worker"))) {
+        // A worker is ready
+        auto worker = m_workers.find(json.value(QLatin1String("worker")).toObject().value(QLatin1String("id")).toInt());
+        if (worker == m_workers.end()) {
+            socket->abort();
+            return;
+        }
+        worker->second.socket = socket;
+        processQueue();
+    }
+    if (json.contains(QLatin1String("setRenderingProgress"))) {
+        const QJsonObject obj = json.value(QLatin1String("setRenderingProgress")).toObject();
+        auto it = findJob(obj.value(QLatin1String("url")).toString());
+        if (it != m_jobs.end()) {
+            QJsonObject args;
+            args[QLatin1String("id")] = it->id;
+            args[QLatin1String("progress")] = obj.value(QLatin1String("progress")).toInt();
+            args[QLatin1String("frame")] = obj.value(QLatin1String("frame")).toInt();
+            send(it->client, QStringLiteral("progress"), args);
+        }
+    }
+    if (json.contains(QLatin1String("setRenderingFinished"))) {
+        const QJsonObject obj = json.value(QLatin1String("setRenderingFinished")).toObject();
+        auto it = findJob(obj.value(QLatin1String("url")).toString());
+        if (it != m_jobs.end()) {
+            auto worker = m_workers.find(it->worker);
+            if (worker != m_workers.end()) {
+                worker->second.output.clear();
+            }
+            finishJob(it, obj.value(QLatin1String("status")).toInt(), obj.value(QLatin1String("error")).toString());
+            processQueue();
+        }
+    }
+}
+
+void RenderDaemon::finishJob(std::list<Job>::iterator job, int status, const QString &error)
+{
+    QJsonObject args;
+    args[QLatin1String("id")] = job->id;
+    args[QLatin1String("output")] = job->output;
+    // Same status codes as the render server: -1 success, -2 failure, -3 aborted
+    args[QLatin1String("status")] = status;
+    args[QLatin1String("result")] = status == -1 ? QStringLiteral("done") : (status == -3 ? QStringLiteral("aborted") : QStringLiteral("failed"));
+    if (!error.isEmpty()) {
+        args[QLatin1String("error")] = error;
+    }
+    send(job->client, QStringLiteral("finished"), args);
+    if (!m_debugMode) {
+        QFile::remove(job->playlist);
+    }
+    m_jobs.erase(job);
+}
+
+void RenderDaemon::abortJob(const QString &id, QLocalSocket *client)
+{
+    for (auto it = m_jobs.begin(); it != m_jobs.end(); ++it) {
+        if (it->id != id || it->client != client) {
+            continue;
+        }
+        auto worker = m_workers.find(it->worker);
+        if (worker == m_workers.end()) {
+            // Not started yet, simply drop it
+            finishJob(it, -3, QString());
+        } else {
+            // The worker reports the end of the job
+            QJsonObject args;
+            args[QLatin1String("url")] = it->output;
+            send(worker->second.socket, QStringLiteral("abort"), args);
+        }
+        return;
+    }
+    QJsonObject args;
+    args[QLatin1String("id")] = id;
+    args[QLatin1String("message")] = tr("Unknown job %1").arg(id);
+    send(client, QStringLiteral("error"), args);
+}
+
+std::list<RenderDaemon::Job>::iterator RenderDaemon::findJob(const QString &output)
+{
+    return std::find_if(m_jobs.begin(), m_jobs.end(), [&output](const Job &job) { return job.output == output; });
+}
@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <functional>
+#include <list>
+#include <map>
+
+/** @class RenderDaemon
+    @brief Headless render service, accepting render requests from scripts on a local socket.
+    Clients send JSON objects like {"render": {"id": "job1", "source": "project.kdenlive", "output": "out.mp4", "in": 0, "out": 250,
+    "preset": "f=mp4 vcodec=libx264 acodec=aac"}} or {"abort": {"id": "job1"}}, and the daemon streams progress ("queued", "progress",
+    "finished" or "error" objects) back to the requesting client.
+    Requests are rendered by at most maxJobs persistent worker processes (kdenlive_render worker), which initialize MLT once and
+    then render one request after the other. Workers report to the daemon using the same messages as the render jobs sent to the
+    Kdenlive render server. A crashing worker only fails its current request, a new worker is started for the next ones.
+ */
+class RenderDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    RenderDaemon(const QString &serverName, int maxJobs, bool debugMode, QObject *parent = nullptr);
+    ~RenderDaemon() override;
+    /** @brief Returns true if the daemon is listening for clients and workers */
+    bool isListening() const;
+    /** @brief The name of the local server the workers connect to */
+    QString workerServerName() const;
+
+    /** @brief Parse the complete json objects available on @param socket and pass them to @param handler. Also used by the workers */
+    static void readJson(QLocalSocket *socket, const std::function<void(const QJsonObject &)> &handler);
+    /** @brief Send {@param method: @param args} on @param socket. Also used by the workers */
+    static void send(QLocalSocket *socket, const QString &method, const QJsonObject &args);
+
+protected:
+    /** @brief Start the worker process @param id, it has to connect to workerServerName() and introduce itself with {"worker": {"id": id}} */
+    virtual void startWorker(int id);
+    /** @brief The worker @param id is gone, its current request fails with @param error */
+    void workerExited(int id, const QString &error);
+
+private Q_SLOTS:
+    void clientConnected();
+    void workerConnected();
+
+private:
+    struct Job
+    {
+        QString id;
+        QPointer<QLocalSocket> client;
+        QString playlist;
+        QString output;
+        /// The consumer service and properties
+        QString service;
+        QJsonObject properties;
+        int in{-1};
+        int out{-1};
+        /// The worker rendering this job, -1 while it is queued
+        int worker{-1};
+    };
+    struct Worker
+    {
+        QProcess *process{nullptr};
+        /// Null until the worker is ready
+        QPointer<QLocalSocket> socket;
+        /// Output of the job being rendered, empty if the worker is idle
+        QString output;
+    };
+
+    void handleRequest(const QJsonObject &json, QLocalSocket *client);
+    void handleWorkerMessage(const QJsonObject &json, QLocalSocket *socket);
+    /** @brief Write the playlist that will be rendered for @param request, returns an error message on failure */
+    QString preparePlaylist(const QJsonObject &request, Job &job);
+    /** @brief Dispatch the queued jobs to the idle workers, and start workers if needed */
+    void processQueue();
+    /** @brief Report the result of the job to its client and remove it */
+    void finishJob(std::list<Job>::iterator job, int status, const QString &error);
+    void abortJob(const QString &id, QLocalSocket *client);
+    std::list<Job>::iterator findJob(const QString &output);
+
+    QLocalServer m_clientServer;
+    QLocalServer m_workerServer;
+    int m_maxJobs;
+    bool m_debugMode;
+    std::list<Job> m_jobs;
+    std::map<int, Worker> m_workers;
+    int m_lastId{0};
+    int m_lastWorkerId{0};
+};
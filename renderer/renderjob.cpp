@@ -10,8 +10,11 @@
 #include <QDebug>
 #include <QDir>
 #include <QElapsedTimer>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QLockFile>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QStringList>
 #include <utility>
@@ -62,6 +65,71 @@ RenderJob::~RenderJob()
     m_logfile.close();
 }
 
+void RenderJob::setSegments(const QStringList &segments, const QString &audioFile)
+{
+    m_segments = segments;
+    // Write the list of segments for the ffmpeg concat demuxer
+    QFileInfo manifest(m_scenelist);
+    QFile listFile(manifest.absoluteDir().absoluteFilePath(QStringLiteral("concat.txt")));
+    if (listFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        QTextStream stream(&listFile);
+        for (QString segment : segments) {
+            stream << QStringLiteral("file '%1'\n").arg(segment.replace(QLatin1Char('\''), QStringLiteral("'\\''")));
+        }
+        listFile.close();
+    }
+    m_args = {QStringLiteral("-y"), QStringLiteral("-v"), QStringLiteral("error"), QStringLiteral("-stats"), QStringLiteral("-f"),
+              QStringLiteral("concat"), QStringLiteral("-safe"), QStringLiteral("0"), QStringLiteral("-i"), listFile.fileName()};
+    if (!audioFile.isEmpty()) {
+        m_args << QStringLiteral("-i") << audioFile << QStringLiteral("-map") << QStringLiteral("0:v") << QStringLiteral("-map") << QStringLiteral("1:a");
+    }
+    m_args << QStringLiteral("-c") << QStringLiteral("copy") << m_dest;
+}
+
+void RenderJob::setManifest(const QString &manifest)
+{
+    m_manifest = manifest;
+}
+
+void RenderJob::setError(const QString &error)
+{
+    m_errorMessage = error;
+}
+
+void RenderJob::markSegmentDone()
+{
+    // Several segments can finish at the same time
+    QLockFile lock(m_manifest + QStringLiteral(".lock"));
+    if (!lock.lock()) {
+        return;
+    }
+    QFile file(m_manifest);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    if (manifest.value(QLatin1String("audio")).toString() == m_dest) {
+        manifest[QLatin1String("audioDone")] = true;
+    } else {
+        QJsonArray segments = manifest.value(QLatin1String("segments")).toArray();
+        for (int i = 0; i < segments.count(); ++i) {
+            QJsonObject segment = segments.at(i).toObject();
+            if (segment.value(QLatin1String("file")).toString() == m_dest) {
+                segment[QLatin1String("done")] = true;
+                segments.replace(i, segment);
+                break;
+            }
+        }
+        manifest[QLatin1String("segments")] = segments;
+    }
+    QSaveFile saveFile(m_manifest);
+    if (saveFile.open(QIODevice::WriteOnly)) {
+        saveFile.write(QJsonDocument(manifest).toJson());
+        saveFile.commit();
+    }
+}
+
 void RenderJob::slotAbort(const QString &url)
 {
     if (m_dest == url) {
@@ -143,6 +211,35 @@ void RenderJob::receivedStderr()
     }
 }
 
+void RenderJob::receivedConcatProgress()
+{
+    // ffmpeg stats are separated by carriage returns
+    m_outputData.append(QString::fromLocal8Bit(m_renderProcess.readAllStandardError()));
+    m_outputData.replace(QLatin1Char('\r'), QLatin1Char('\n'));
+    int ix = m_outputData.lastIndexOf(QLatin1Char('\n'));
+    if (ix < 0) {
+        return;
+    }
+    const QStringList lines = m_outputData.left(ix).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    m_outputData.remove(0, ix + 1);
+    for (const QString &line : lines) {
+        const QString result = line.simplified();
+        if (!result.startsWith(QLatin1String("frame="))) {
+            m_errorMessage.append(result + QStringLiteral("<br>"));
+            m_logstream << result << "\n";
+            continue;
+        }
+        bool ok = false;
+        int frame = result.section(QLatin1Char('='), 1).simplified().section(QLatin1Char(' '), 0, 0).toInt(&ok);
+        if (!ok || frame <= m_frame || m_frameout <= m_framein) {
+            continue;
+        }
+        m_frame = frame;
+        m_progress = qBound(0, 100 * frame / (m_frameout - m_framein), 99);
+        updateProgress();
+    }
+}
+
 void RenderJob::updateProgress()
 {
     if (m_kdenlivesocket->state() == QLocalSocket::ConnectedState) {
@@ -204,8 +301,28 @@ void RenderJob::start()
         }
         connect(m_kdenlivesocket, &QLocalSocket::readyRead, this, &RenderJob::gotMessage);
     }
-    // Because of the logging, we connect to stderr in all cases.
-    connect(&m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
+    if (!m_errorMessage.isEmpty()) {
+        m_logstream << m_errorMessage << "\n";
+        m_logstream.flush();
+        sendFinish(-2, m_errorMessage);
+        Q_EMIT renderingFinished();
+        return;
+    }
+    if (!m_segments.isEmpty()) {
+        for (const QString &segment : std::as_const(m_segments)) {
+            if (!QFile::exists(segment)) {
+                m_errorMessage = tr("Missing segment %1, cannot join the segmented render.").arg(segment);
+                m_logstream << m_errorMessage << "\n";
+                sendFinish(-2, m_errorMessage);
+                Q_EMIT renderingFinished();
+                return;
+            }
+        }
+        connect(&m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedConcatProgress);
+    } else {
+        // Because of the logging, we connect to stderr in all cases.
+        connect(&m_renderProcess, &QProcess::readyReadStandardError, this, &RenderJob::receivedStderr);
+    }
     m_logstream << "Started render process: " << m_prog << ' ' << m_args.join(QLatin1Char(' ')) << "\n";
     m_renderProcess.start(m_prog, m_args);
     if (m_debugMode) {
@@ -253,8 +370,15 @@ void RenderJob::slotIsOver(int exitCode, QProcess::ExitStatus status)
             int error = -1;
             QString errorMessage;
             if (QFile::exists(m_dest)) {
+                if (!m_manifest.isEmpty()) {
+                    markSegmentDone();
+                }
                 if (!m_debugMode) {
                     m_logfile.remove();
+                    if (!m_segments.isEmpty()) {
+                        // Segments were joined, remove them
+                        QFileInfo(m_scenelist).absoluteDir().removeRecursively();
+                    }
                 }
             } else {
                 // Rendering finished but missing file
@@ -24,6 +24,14 @@ public:
     RenderJob(const QString &render, const QString &scenelist, const QString &target, int pid = -1, int in = -1, int out = -1,
               const QString &subtitleFile = QString(), bool debugMode = false, QObject *parent = nullptr);
     ~RenderJob() override;
+    /** @brief Join the rendered video @param segments and @param audioFile with a stream copy instead of rendering a playlist.
+     *  In this mode, the render program is ffmpeg and the scenelist is the segments manifest.
+     */
+    void setSegments(const QStringList &segments, const QString &audioFile);
+    /** @brief This job renders a part of a segmented render, mark it as complete in the segments @param manifest on success */
+    void setManifest(const QString &manifest);
+    /** @brief The job cannot run, it reports @param error to Kdenlive as soon as it is started */
+    void setError(const QString &error);
 
 public Q_SLOTS:
     void start();
@@ -31,6 +39,7 @@ public Q_SLOTS:
 private Q_SLOTS:
     void slotIsOver(int exitCode, QProcess::ExitStatus status);
     void receivedStderr();
+    void receivedConcatProgress();
     void slotAbort();
     void slotAbort(const QString &url);
     void slotCheckSubtitleProcess(int exitCode, QProcess::ExitStatus exitStatus);
@@ -67,6 +76,12 @@ private:
     /** @brief Used to write to the log file. */
     QTextStream m_logstream;
     QString m_outputData;
+    /** @brief The video segments to join, empty if we are rendering a playlist */
+    QStringList m_segments;
+    /** @brief The manifest of the segmented render this job belongs to */
+    QString m_manifest;
+    /** @brief Record in the manifest that our output file is complete, so that an interrupted render can be resumed */
+    void markSegmentDone();
     void fromServer();
     void sendFinish(int status, const QString &error);
     void updateProgress();
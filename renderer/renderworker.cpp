@@ -0,0 +1,180 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "renderworker.h"
+#include "renderdaemon.h"
+
+#include "mlt++/Mlt.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QLocale>
+
+RenderWorker::RenderWorker(int id, QObject *parent)
+    : QObject(parent)
+    , m_id(id)
+{
+    m_progressTimer.setInterval(500);
+    connect(&m_progressTimer, &QTimer::timeout, this, &RenderWorker::checkProgress);
+    connect(&m_socket, &QLocalSocket::readyRead, this,
+            [this]() { RenderDaemon::readJson(&m_socket, [this](const QJsonObject &json) { handleMessage(json); }); });
+    // Nothing left to do once the daemon is gone
+    connect(&m_socket, &QLocalSocket::disconnected, this, [this]() {
+        if (m_consumer) {
+            m_aborted = true;
+            m_consumer->stop();
+            QFile::remove(m_output);
+        }
+        qApp->quit();
+    });
+}
+
+RenderWorker::~RenderWorker()
+{
+    m_progressTimer.stop();
+    if (m_consumer) {
+        m_consumer->stop();
+    }
+}
+
+bool RenderWorker::connectToDaemon(const QString &serverName)
+{
+    m_socket.connectToServer(serverName);
+    if (!m_socket.waitForConnected(5000)) {
+        qWarning() << "Render worker cannot connect to" << serverName << m_socket.errorString();
+        return false;
+    }
+    QJsonObject args;
+    args[QLatin1String("id")] = m_id;
+    RenderDaemon::send(&m_socket, QStringLiteral("worker"), args);
+    return true;
+}
+
+void RenderWorker::handleMessage(const QJsonObject &json)
+{
+    if (json.contains(QLatin1String("abort"))) {
+        if (m_consumer && json.value(QLatin1String("abort")).toObject().value(QLatin1String("url")).toString() == m_output) {
+            m_aborted = true;
+            m_consumer->stop();
+            checkProgress();
+        }
+    }
+    if (json.contains(QLatin1String("render"))) {
+        render(json.value(QLatin1String("render")).toObject());
+    }
+}
+
+void RenderWorker::render(const QJsonObject &request)
+{
+    const QString output = request.value(QLatin1String("output")).toString();
+    if (m_consumer) {
+        QJsonObject args;
+        args[QLatin1String("url")] = output;
+        args[QLatin1String("status")] = -2;
+        args[QLatin1String("error")] = tr("Render worker is busy");
+        RenderDaemon::send(&m_socket, QStringLiteral("setRenderingFinished"), args);
+        return;
+    }
+    m_output = output;
+    m_aborted = false;
+    m_progress = -1;
+    const QString playlist = request.value(QLatin1String("playlist")).toString();
+    // The profile is read from the playlist
+    m_profile = std::make_unique<Mlt::Profile>();
+    m_producer = std::make_unique<Mlt::Producer>(*m_profile.get(), "xml", playlist.toUtf8().constData());
+    if (!m_producer->is_valid()) {
+        finish(-2, tr("Cannot load %1").arg(playlist));
+        return;
+    }
+    m_profile->set_explicit(1);
+    QLocale::setDefault(QLocale(QString::fromUtf8(m_producer->get_lcnumeric())));
+    const int in = request.value(QLatin1String("in")).toInt(-1);
+    const int out = request.value(QLatin1String("out")).toInt(-1);
+    if (in >= 0 || out >= 0) {
+        // The cut keeps a reference to its parent, keep both for the whole render
+        std::unique_ptr<Mlt::Producer> cut(m_producer->cut(qMax(0, in), out >= 0 ? out : m_producer->get_length() - 1));
+        m_source = std::move(m_producer);
+        m_producer = std::move(cut);
+    }
+    const QString service = request.value(QLatin1String("service")).toString(QStringLiteral("avformat"));
+    m_consumer = std::make_unique<Mlt::Consumer>(*m_profile.get(), service.toUtf8().constData(), m_output.toUtf8().constData());
+    if (!m_consumer->is_valid()) {
+        finish(-2, tr("Cannot create the %1 consumer").arg(service));
+        return;
+    }
+    // Don't drop frames unless the preset asks for it
+    m_consumer->set("real_time", -1);
+    const QJsonObject properties = request.value(QLatin1String("properties")).toObject();
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it) {
+        m_consumer->set(it.key().toUtf8().constData(), it.value().toString().toUtf8().constData());
+    }
+    m_consumer->set("terminate_on_pause", 1);
+    m_consumer->connect(*m_producer.get());
+    if (m_consumer->start() != 0) {
+        finish(-2, tr("Cannot start rendering %1").arg(m_output));
+        return;
+    }
+    sendProgress(0, 0);
+    m_progressTimer.start();
+}
+
+void RenderWorker::checkProgress()
+{
+    if (!m_consumer) {
+        return;
+    }
+    if (!m_consumer->is_stopped()) {
+        const int frame = m_producer->position();
+        const int length = qMax(1, m_producer->get_playtime());
+        sendProgress(qBound(0, 100 * frame / length, 99), frame);
+        return;
+    }
+    if (m_aborted) {
+        QFile::remove(m_output);
+        finish(-3, QString());
+    } else if (QFileInfo(m_output).size() <= 0) {
+        finish(-2, tr("Rendering of %1 failed").arg(m_output));
+    } else {
+        sendProgress(100, m_producer->get_playtime());
+        finish(-1, QString());
+    }
+}
+
+void RenderWorker::sendProgress(int progress, int frame)
+{
+    if (progress == m_progress) {
+        return;
+    }
+    m_progress = progress;
+    QJsonObject args;
+    args[QLatin1String("url")] = m_output;
+    args[QLatin1String("progress")] = progress;
+    args[QLatin1String("frame")] = frame;
+    RenderDaemon::send(&m_socket, QStringLiteral("setRenderingProgress"), args);
+}
+
+void RenderWorker::finish(int status, const QString &error)
+{
+    m_progressTimer.stop();
+    if (m_consumer) {
+        m_consumer->stop();
+        m_consumer->purge();
+    }
+    // Release the clips of this render, MLT stays initialized for the next one
+    m_consumer.reset();
+    m_producer.reset();
+    m_source.reset();
+    m_profile.reset();
+    QJsonObject args;
+    args[QLatin1String("url")] = m_output;
+    args[QLatin1String("status")] = status;
+    if (!error.isEmpty()) {
+        args[QLatin1String("error")] = error;
+    }
+    RenderDaemon::send(&m_socket, QStringLiteral("setRenderingFinished"), args);
+    m_output.clear();
+}
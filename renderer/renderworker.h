@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QObject>
+#include <QTimer>
+#include <memory>
+
+namespace Mlt {
+class Consumer;
+class Producer;
+class Profile;
+} // namespace Mlt
+
+/** @class RenderWorker
+    @brief A persistent render process of the RenderDaemon. MLT is initialized once, then the worker renders the requests sent by
+    the daemon one after the other, in process, and reports the progress and result of each one like a RenderJob.
+ */
+class RenderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RenderWorker(int id, QObject *parent = nullptr);
+    ~RenderWorker() override;
+    /** @brief Connect to the daemon listening on @param serverName, returns false on failure */
+    bool connectToDaemon(const QString &serverName);
+
+private:
+    void handleMessage(const QJsonObject &json);
+    void render(const QJsonObject &request);
+    /** @brief Report the progress of the current render, and its result once the consumer stopped */
+    void checkProgress();
+    void finish(int status, const QString &error);
+    void sendProgress(int progress, int frame);
+
+    int m_id;
+    QLocalSocket m_socket;
+    QTimer m_progressTimer;
+    std::unique_ptr<Mlt::Profile> m_profile;
+    /// The rendered producer, a cut of m_source if only a range is rendered
+    std::unique_ptr<Mlt::Producer> m_producer;
+    std::unique_ptr<Mlt::Producer> m_source;
+    std::unique_ptr<Mlt::Consumer> m_consumer;
+    QString m_output;
+    int m_progress{-1};
+    bool m_aborted{false};
+};
@@ -524,7 +524,7 @@ bool KeyframeModel::updateKeyframe(GenTime pos, QVariant value)
     Fun redo = []() { return true; };
     bool res = updateKeyframe(pos, value, undo, redo);
     if (res) {
-        PUSH_UNDO(undo, redo, i18n("Update keyframe"));
+        PUSH_MERGEABLE_UNDO(undo, redo, i18n("Update keyframe"), pos.frames(pCore->getCurrentFps()));
     }
     return res;
 }
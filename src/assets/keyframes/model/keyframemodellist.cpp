@@ -695,7 +695,9 @@ void KeyframeModelList::setParametersFromTask(const paramVector &params)
         return true;
     };
     redo();
-    pCore->pushUndo(undo, redo, i18n("Update effect"));
+    // Tracking results can hold a keyframe for each frame
+    pCore->pushUndo(undo, redo, i18n("Update effect"),
+                    AssetParameterModel::parametersMemoryCost(params) + AssetParameterModel::parametersMemoryCost(previousParams));
 }
 
 void KeyframeModelList::reset()
@@ -797,6 +797,28 @@ bool AssetParameterModel::isAnimated(ParamType type)
            type == ParamType::Color;
 }
 
+// static
+size_t AssetParameterModel::parametersMemoryCost(const paramVector &params)
+{
+    size_t cost = 0;
+    for (const auto &p : params) {
+        // Values are mostly strings, animated ones can hold thousands of keyframes
+        cost += size_t(p.first.size() + p.second.toString().size()) * sizeof(QChar);
+    }
+    return cost;
+}
+
+// static
+size_t AssetParameterModel::propertiesMemoryCost(Mlt::Properties &properties)
+{
+    size_t cost = 0;
+    const int count = properties.count();
+    for (int i = 0; i < count; ++i) {
+        cost += qstrlen(properties.get_name(i)) + qstrlen(properties.get(i));
+    }
+    return cost;
+}
+
 // static
 QString AssetParameterModel::getDefaultKeyframes(int start, const QString &defaultValue, bool linearOnly)
 {
@@ -1567,7 +1589,7 @@ void AssetParameterModel::setParametersFromTask(const paramVector &params)
             return true;
         };
         redo();
-        pCore->pushUndo(undo, redo, i18n("Update effect"));
+        pCore->pushUndo(undo, redo, i18n("Update effect"), parametersMemoryCost(params) + parametersMemoryCost(previousParams));
     }
 }
 
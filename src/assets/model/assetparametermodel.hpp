@@ -138,6 +138,11 @@ public:
 
     /** @brief Returns true if @param type is animated */
     static bool isAnimated(ParamType type);
+    /** @brief Returns the memory used by a list of parameter values, in bytes. Used to declare the size of the values captured in undo commands */
+    static size_t parametersMemoryCost(const paramVector &params);
+    /** @brief Returns the memory used by the names and values of @param properties, in bytes. Used to declare the size of the MLT services captured in
+     * undo commands */
+    static size_t propertiesMemoryCost(Mlt::Properties &properties);
 
     /** @brief Returns the id of the asset represented by this object */
     QString getAssetId() const;
@@ -0,0 +1,161 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "audiometerbus.h"
+
+#include <QByteArray>
+#include <QMutexLocker>
+#include <QtGlobal>
+
+QVector<double> AudioMeterLevels::peakValues() const
+{
+    QVector<double> values;
+    values.reserve(channels);
+    for (int i = 0; i < channels; i++) {
+        values << double(peak[size_t(i)]);
+    }
+    return values;
+}
+
+void AudioMeterRing::publish(const AudioMeterLevels &levels)
+{
+    const quint64 index = m_published.load(std::memory_order_relaxed);
+    Entry &entry = m_entries[index % Capacity];
+    const quint32 sequence = entry.sequence.load(std::memory_order_relaxed);
+    // An odd sequence marks the entry as being written
+    entry.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const int channels = qBound(0, levels.channels, AudioMeterLevels::MaxChannels);
+    entry.position.store(levels.position, std::memory_order_relaxed);
+    entry.channels.store(channels, std::memory_order_relaxed);
+    for (size_t i = 0; i < size_t(channels); i++) {
+        entry.peak[i].store(levels.peak[i], std::memory_order_relaxed);
+        entry.rms[i].store(levels.rms[i], std::memory_order_relaxed);
+    }
+    entry.sequence.store(sequence + 2, std::memory_order_release);
+    m_published.store(index + 1, std::memory_order_release);
+}
+
+bool AudioMeterRing::readEntry(quint64 index, AudioMeterLevels &levels) const
+{
+    const Entry &entry = m_entries[index % Capacity];
+    const quint32 sequence = entry.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+        return false;
+    }
+    AudioMeterLevels copy;
+    copy.position = entry.position.load(std::memory_order_relaxed);
+    copy.channels = entry.channels.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size_t(copy.channels); i++) {
+        copy.peak[i] = entry.peak[i].load(std::memory_order_relaxed);
+        copy.rms[i] = entry.rms[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.sequence.load(std::memory_order_relaxed) != sequence) {
+        // The writer wrapped around and replaced this entry while we were copying it
+        return false;
+    }
+    levels = copy;
+    return true;
+}
+
+bool AudioMeterRing::read(int position, AudioMeterLevels &levels) const
+{
+    const quint64 published = m_published.load(std::memory_order_acquire);
+    const quint64 oldest = qMax(m_cleared.load(std::memory_order_acquire), published > Capacity ? published - Capacity : quint64(0));
+    // Start with the most recent levels, the requested frame was usually published a few frames ago
+    for (quint64 index = published; index > oldest; --index) {
+        const Entry &entry = m_entries[(index - 1) % Capacity];
+        if (entry.position.load(std::memory_order_relaxed) != position) {
+            continue;
+        }
+        AudioMeterLevels copy;
+        if (readEntry(index - 1, copy) && copy.position == position) {
+            levels = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AudioMeterRing::latest(AudioMeterLevels &levels) const
+{
+    const quint64 published = m_published.load(std::memory_order_acquire);
+    if (published <= m_cleared.load(std::memory_order_acquire)) {
+        return false;
+    }
+    return readEntry(published - 1, levels);
+}
+
+quint64 AudioMeterRing::published() const
+{
+    return m_published.load(std::memory_order_acquire);
+}
+
+void AudioMeterRing::clear()
+{
+    m_cleared.store(m_published.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+AudioMeterBus::AudioMeterBus()
+{
+    // The master ring is always allocated
+    m_rings[MasterMeter].reset(new AudioMeterRing());
+    m_used[MasterMeter] = true;
+}
+
+AudioMeterBus &AudioMeterBus::get()
+{
+    static AudioMeterBus instance;
+    return instance;
+}
+
+int AudioMeterBus::acquire()
+{
+    QMutexLocker lock(&m_mutex);
+    for (size_t i = 0; i < m_used.size(); i++) {
+        if (!m_used[i]) {
+            m_used[i] = true;
+            if (m_rings[i] == nullptr) {
+                m_rings[i].reset(new AudioMeterRing());
+            } else {
+                m_rings[i]->clear();
+            }
+            return int(i);
+        }
+    }
+    return -1;
+}
+
+void AudioMeterBus::release(int meter)
+{
+    if (meter <= MasterMeter || meter >= MaxMeters) {
+        return;
+    }
+    QMutexLocker lock(&m_mutex);
+    m_used[size_t(meter)] = false;
+}
+
+AudioMeterRing *AudioMeterBus::ring(int meter)
+{
+    if (meter < 0 || meter >= MaxMeters) {
+        return nullptr;
+    }
+    QMutexLocker lock(&m_mutex);
+    return m_rings[size_t(meter)].get();
+}
+
+const char *AudioMeterBus::levelProperty(int channel)
+{
+    static const std::array<QByteArray, AudioMeterLevels::MaxChannels> names = []() {
+        std::array<QByteArray, AudioMeterLevels::MaxChannels> result;
+        for (size_t i = 0; i < result.size(); i++) {
+            result[i] = QByteArrayLiteral("_audio_level.") + QByteArray::number(int(i));
+        }
+        return result;
+    }();
+    return names[size_t(qBound(0, channel, AudioMeterLevels::MaxChannels - 1))].constData();
+}
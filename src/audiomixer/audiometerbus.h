@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QMutex>
+#include <QVector>
+#include <array>
+#include <atomic>
+#include <memory>
+
+/** @brief The levels of one audio frame, in dB */
+struct AudioMeterLevels
+{
+    static constexpr int MaxChannels = 8;
+    int position{-1};
+    int channels{0};
+    std::array<float, MaxChannels> peak{};
+    std::array<float, MaxChannels> rms{};
+    /** @brief The peak values, as expected by the level widgets */
+    QVector<double> peakValues() const;
+};
+
+/** @class AudioMeterRing
+    @brief A lock-free ring of the last audio levels computed for one meter.
+    The levels are published by a single thread (the MLT audio thread or a scope worker) and read by the GUI thread. Each
+    entry is protected by a sequence counter, so a reader never waits for the writer and simply skips an entry that is being
+    overwritten.
+ */
+class AudioMeterRing
+{
+public:
+    static constexpr int Capacity = 128;
+    /** @brief Store the levels of a frame, must always be called from the same thread */
+    void publish(const AudioMeterLevels &levels);
+    /** @brief Get the levels published for the frame at @param position, returns false if they are not available */
+    bool read(int position, AudioMeterLevels &levels) const;
+    /** @brief Get the last published levels, returns false if nothing was published since the last clear() */
+    bool latest(AudioMeterLevels &levels) const;
+    /** @brief The number of levels published so far, can be used to detect new values */
+    quint64 published() const;
+    /** @brief Discard all the published levels, for example when the track volume changed */
+    void clear();
+
+private:
+    struct Entry
+    {
+        std::atomic<quint32> sequence{0};
+        std::atomic<int> position{-1};
+        std::atomic<int> channels{0};
+        std::array<std::atomic<float>, AudioMeterLevels::MaxChannels> peak{};
+        std::array<std::atomic<float>, AudioMeterLevels::MaxChannels> rms{};
+    };
+    std::array<Entry, Capacity> m_entries;
+    std::atomic<quint64> m_published{0};
+    std::atomic<quint64> m_cleared{0};
+    /** @brief Copy the entry at @param index, returns false if it was modified during the copy */
+    bool readEntry(quint64 index, AudioMeterLevels &levels) const;
+};
+
+/** @class AudioMeterBus
+    @brief The rings shared by all the audio level meters (mixer tracks, master and monitors).
+    Each meter acquires a ring from the GUI thread before any level is published. The master ring contains the levels of the
+    frames displayed in the project monitor.
+ */
+class AudioMeterBus
+{
+public:
+    static constexpr int MaxMeters = 64;
+    static constexpr int MasterMeter = 0;
+    static AudioMeterBus &get();
+    /** @brief Reserve a ring, returns -1 if all rings are in use */
+    int acquire();
+    void release(int meter);
+    /** @brief The ring of the @param meter, stays valid until the bus is destroyed */
+    AudioMeterRing *ring(int meter);
+    /** @brief The name of the property containing the level of @param channel in MLT's audiolevel filter */
+    static const char *levelProperty(int channel);
+
+private:
+    AudioMeterBus();
+    QMutex m_mutex;
+    std::array<std::unique_ptr<AudioMeterRing>, MaxMeters> m_rings;
+    std::array<bool, MaxMeters> m_used{};
+};
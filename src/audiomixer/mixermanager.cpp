@@ -46,6 +46,8 @@ MixerManager::MixerManager(QWidget *parent)
     , m_recommendedWidth(300)
     , m_monitorTrack(-1)
     , m_filterIsV2(false)
+    , m_meterPosition(-1)
+    , m_idleMeterTicks(0)
 {
     m_masterBox = new QHBoxLayout;
     setContentsMargins(0, 0, 0, 0);
@@ -74,6 +76,17 @@ MixerManager::MixerManager(QWidget *parent)
     setLayout(m_box);
     MySlider slider;
     m_sliderHandle = slider.getHandleHeight();
+    // The levels are published by the audio thread, we only read the latest ones once per screen refresh
+    m_meterTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_meterTimer, &QTimer::timeout, this, &MixerManager::updateMeters);
+    connect(pCore.get(), &Core::updateMixerLevels, this, [this](int pos) {
+        m_meterPosition = pos;
+        m_idleMeterTicks = 0;
+        if (m_visibleMixerManager && !m_meterTimer.isActive()) {
+            const qreal refreshRate = screen() ? screen()->refreshRate() : 60.;
+            m_meterTimer.start(qMax(1, qRound(1000. / qMax(refreshRate, 1.))));
+        }
+    });
 }
 
 void MixerManager::checkAudioLevelVersion()
@@ -124,7 +137,6 @@ void MixerManager::registerTrack(int tid, Mlt::Tractor *service, const QString &
     if (m_visibleMixerManager) {
         mixer->connectMixer(!KdenliveSettings::mixerCollapse());
     }
-    connect(pCore.get(), &Core::updateMixerLevels, mixer.get(), &MixerWidget::updateAudioLevel);
     connect(this, &MixerManager::clearMixers, mixer.get(), &MixerWidget::clear);
     connect(mixer.get(), &MixerWidget::toggleSolo, this, [&](int trid, bool solo) {
         if (!solo) {
@@ -246,6 +258,9 @@ void MixerManager::connectMixer(bool doConnect)
     if (m_masterMixer != nullptr) {
         m_masterMixer->connectMixer(m_visibleMixerManager);
     }
+    if (!m_visibleMixerManager) {
+        m_meterTimer.stop();
+    }
 }
 
 void MixerManager::collapseMixers()
@@ -267,6 +282,20 @@ void MixerManager::collapseMixers()
     }
 }
 
+void MixerManager::updateMeters()
+{
+    for (const auto &item : m_mixers) {
+        item.second->updateAudioLevel(m_meterPosition);
+    }
+    if (m_masterMixer != nullptr) {
+        m_masterMixer->updateAudioLevel(m_meterPosition);
+    }
+    // Playback stopped, no need to keep polling
+    if (++m_idleMeterTicks > 60) {
+        m_meterTimer.stop();
+    }
+}
+
 void MixerManager::resetSizePolicy()
 {
     setMaximumWidth(QWIDGETSIZE_MAX);
@@ -10,6 +10,7 @@
 #include <unordered_map>
 
 #include <QSlider>
+#include <QTimer>
 #include <QWidget>
 
 namespace Mlt {
@@ -61,6 +62,8 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void resetSizePolicy();
+    /** @brief Display the levels of the frame currently shown in the project monitor */
+    void updateMeters();
 
 Q_SIGNALS:
     void updateLevels(int);
@@ -88,4 +91,8 @@ private:
     int m_monitorTrack;
     bool m_filterIsV2;
     int m_sliderHandle;
+    /** @brief Refreshes the level meters at the screen refresh rate during playback */
+    QTimer m_meterTimer;
+    int m_meterPosition;
+    int m_idleMeterTicks;
 };
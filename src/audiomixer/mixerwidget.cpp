@@ -6,6 +6,7 @@
 #include "mixerwidget.hpp"
 
 #include "audiolevelwidget.hpp"
+#include "audiometerbus.h"
 #include "capture/mediacapture.h"
 #include "core.h"
 #include "iecscale.h"
@@ -34,38 +35,35 @@
 void MixerWidget::property_changed(mlt_service, MixerWidget *widget, mlt_event_data data)
 {
     if (widget && !strcmp(Mlt::EventData(data).to_string(), "_position")) {
-        mlt_properties filter_props = MLT_FILTER_PROPERTIES(widget->m_monitorFilter->get_filter());
-        int pos = mlt_properties_get_int(filter_props, "_position");
-        if (!widget->m_levels.contains(pos)) {
-            QVector<double> levels;
-            for (int i = 0; i < widget->m_channels; i++) {
-                // NOTE: this is an approximation. To get the real peak level, we need version 2 of audiolevel MLT filter, see property_changedV2
-                levels << log10(mlt_properties_get_double(filter_props, QStringLiteral("_audio_level.%1").arg(i).toUtf8().constData()) / 1.18) * 20;
-            }
-            widget->m_levels[pos] = std::move(levels);
-            if (widget->m_levels.size() > widget->m_maxLevels) {
-                widget->m_levels.erase(widget->m_levels.begin());
-            }
-        }
+        widget->publishLevels(false);
     }
 }
 
 void MixerWidget::property_changedV2(mlt_service, MixerWidget *widget, mlt_event_data data)
 {
     if (widget && !strcmp(Mlt::EventData(data).to_string(), "_position")) {
-        mlt_properties filter_props = MLT_FILTER_PROPERTIES(widget->m_monitorFilter->get_filter());
-        int pos = mlt_properties_get_int(filter_props, "_position");
-        if (!widget->m_levels.contains(pos)) {
-            QVector<double> levels;
-            for (int i = 0; i < widget->m_channels; i++) {
-                levels << mlt_properties_get_double(filter_props, QStringLiteral("_audio_level.%1").arg(i).toUtf8().constData());
-            }
-            widget->m_levels[pos] = std::move(levels);
-            if (widget->m_levels.size() > widget->m_maxLevels) {
-                widget->m_levels.erase(widget->m_levels.begin());
-            }
+        widget->publishLevels(true);
+    }
+}
+
+void MixerWidget::publishLevels(bool dbPeak)
+{
+    // Called from the audio thread for each frame, so only publish fixed size values without allocating
+    mlt_properties filter_props = MLT_FILTER_PROPERTIES(m_monitorFilter->get_filter());
+    AudioMeterLevels levels;
+    levels.position = mlt_properties_get_int(filter_props, "_position");
+    levels.channels = qMin(m_channels, AudioMeterLevels::MaxChannels);
+    for (int i = 0; i < levels.channels; i++) {
+        double level = mlt_properties_get_double(filter_props, AudioMeterBus::levelProperty(i));
+        if (!dbPeak) {
+            // NOTE: this is an approximation. To get the real peak level, we need version 2 of audiolevel MLT filter
+            level = log10(level / 1.18) * 20;
         }
+        // The audiolevel filter only computes one level per channel
+        levels.peak[size_t(i)] = float(level);
+        levels.rms[size_t(i)] = float(level);
     }
+    m_meter->publish(levels);
 }
 
 MixerWidget::MixerWidget(int tid, Mlt::Tractor *service, QString trackTag, const QString &trackName, int sliderHandle, MixerManager *parent)
@@ -78,10 +76,12 @@ MixerWidget::MixerWidget(int tid, Mlt::Tractor *service, QString trackTag, const
     , m_channels(pCore->audioChannels())
     , m_balanceSpin(nullptr)
     , m_balanceSlider(nullptr)
-    , m_maxLevels(qMax(30, int(service->get_fps() * 1.5)))
     , m_solo(nullptr)
     , m_collapse(nullptr)
     , m_monitor(nullptr)
+    , m_meterId(tid == -1 ? AudioMeterBus::MasterMeter : AudioMeterBus::get().acquire())
+    , m_meter(AudioMeterBus::get().ring(m_meterId))
+    , m_shownLevels(-1)
     , m_lastVolume(0)
     , m_listener(nullptr)
     , m_recording(false)
@@ -96,6 +96,7 @@ MixerWidget::~MixerWidget()
     if (m_listener) {
         delete m_listener;
     }
+    AudioMeterBus::get().release(m_meterId);
 }
 
 void MixerWidget::buildUI(Mlt::Tractor *service, const QString &trackName)
@@ -335,7 +336,7 @@ void MixerWidget::buildUI(Mlt::Tractor *service, const QString &trackName)
             m_volumeSpin->setValue(dbValue);
             m_levelFilter->set("level", dbValue);
             m_levelFilter->set("disable", value == 60 ? 1 : 0);
-            m_levels.clear();
+            clear();
             Q_EMIT m_manager->purgeCache();
             pCore->setDocumentModified();
         }
@@ -347,7 +348,7 @@ void MixerWidget::buildUI(Mlt::Tractor *service, const QString &trackName)
             if (m_balanceFilter != nullptr) {
                 m_balanceFilter->set("start", (value + 50) / 100.);
                 m_balanceFilter->set("disable", value == 0 ? 1 : 0);
-                m_levels.clear();
+                clear();
                 Q_EMIT m_manager->purgeCache();
                 pCore->setDocumentModified();
             }
@@ -456,26 +457,47 @@ void MixerWidget::updateLabel()
 
 void MixerWidget::updateAudioLevel(int pos)
 {
-    QMutexLocker lk(&m_storeMutex);
-    if (m_levels.contains(pos)) {
-        m_audioMeterWidget->setAudioValues(m_levels.value(pos));
-        // m_levels.remove(pos);
-    } else {
+    if (m_meter == nullptr) {
+        return;
+    }
+    AudioMeterLevels levels;
+    if (m_tid == -1) {
+        // The master levels are published when the project monitor displays a frame
+        const qint64 published = qint64(m_meter->published());
+        if (published == m_shownLevels) {
+            return;
+        }
+        m_shownLevels = published;
+        if (m_meter->latest(levels)) {
+            m_audioMeterWidget->setAudioValues(levels.peakValues());
+        }
+        return;
+    }
+    if (pos == m_shownLevels) {
+        return;
+    }
+    if (m_meter->read(pos, levels)) {
+        m_shownLevels = pos;
+        m_audioMeterWidget->setAudioValues(levels.peakValues());
+    } else if (m_shownLevels != -1) {
+        // The levels may still be published, retry on next refresh
+        m_shownLevels = -1;
         m_audioMeterWidget->setAudioValues(m_audioData);
     }
 }
 
 void MixerWidget::reset()
 {
-    QMutexLocker lk(&m_storeMutex);
-    m_levels.clear();
+    clear();
     m_audioMeterWidget->setAudioValues(m_audioData);
 }
 
 void MixerWidget::clear()
 {
-    QMutexLocker lk(&m_storeMutex);
-    m_levels.clear();
+    if (m_meter) {
+        m_meter->clear();
+    }
+    m_shownLevels = -1;
 }
 
 bool MixerWidget::isMute() const
@@ -558,21 +580,15 @@ void MixerWidget::setRecordState(bool recording)
 void MixerWidget::connectMixer(bool doConnect)
 {
     if (doConnect) {
-        if (m_tid == -1) {
-            // Master level
-            connect(pCore.get(), &Core::audioLevelsAvailable, m_audioMeterWidget.get(), &AudioLevelWidget::setAudioValues);
-        } else if (m_listener == nullptr) {
+        // The master levels are published by the project monitor audio meter
+        if (m_tid != -1 && m_meter != nullptr && m_listener == nullptr) {
             m_listener = m_monitorFilter->listen("property-changed", this,
                                                  m_manager->audioLevelV2() ? reinterpret_cast<mlt_listener>(property_changedV2)
                                                                            : reinterpret_cast<mlt_listener>(property_changed));
         }
     } else {
-        if (m_tid == -1) {
-            disconnect(pCore.get(), &Core::audioLevelsAvailable, m_audioMeterWidget.get(), &AudioLevelWidget::setAudioValues);
-        } else {
-            delete m_listener;
-            m_listener = nullptr;
-        }
+        delete m_listener;
+        m_listener = nullptr;
     }
     pauseMonitoring(!doConnect);
 }
@@ -8,13 +8,14 @@
 #include "definitions.h"
 #include "mlt++/MltService.h"
 
-#include <QMutex>
+#include <QVector>
 #include <QWidget>
 #include <memory>
 #include <unordered_map>
 
 class KDualAction;
 class AudioLevelWidget;
+class AudioMeterRing;
 class QSlider;
 class QDial;
 class QSpinBox;
@@ -64,6 +65,7 @@ protected:
     void mousePressEvent(QMouseEvent *event) override;
 
 public Q_SLOTS:
+    /** @brief Display the levels published for the frame at @param pos (the last published levels for the master) */
     void updateAudioLevel(int pos);
     void setRecordState(bool recording);
 
@@ -76,13 +78,11 @@ protected:
     std::shared_ptr<Mlt::Filter> m_levelFilter;
     std::shared_ptr<Mlt::Filter> m_monitorFilter;
     std::shared_ptr<Mlt::Filter> m_balanceFilter;
-    QMap<int, QVector<double>> m_levels;
     int m_channels;
     KDualAction *m_muteAction;
     QSpinBox *m_balanceSpin;
     QSlider *m_balanceSlider;
     QDoubleSpinBox *m_volumeSpin;
-    int m_maxLevels;
 
 private:
     std::shared_ptr<AudioLevelWidget> m_audioMeterWidget;
@@ -91,7 +91,11 @@ private:
     QToolButton *m_collapse;
     QToolButton *m_monitor;
     KSqueezedTextLabel *m_trackLabel;
-    QMutex m_storeMutex;
+    /** @brief Our ring in the AudioMeterBus, written by the audiolevel filter callbacks */
+    int m_meterId;
+    AudioMeterRing *m_meter;
+    /** @brief The frame position (track) or ring index (master) of the displayed levels */
+    qint64 m_shownLevels;
     double m_lastVolume;
     QVector<double> m_audioData;
     Mlt::Event *m_listener;
@@ -100,6 +104,9 @@ private:
     int m_sliderHandleSize;
     /** @Update track label to reflect state */
     void updateLabel();
+    /** @brief Publish the levels computed by the audiolevel filter for its current frame
+     *  @param dbPeak true if the filter reports the peak level in dB (version 2) */
+    void publishLevels(bool dbPeak);
 
 Q_SIGNALS:
     void gotLevels(QPair<double, double>);
@@ -1819,7 +1819,12 @@ void Bin::slotDeleteClip()
     // std::sort(items.begin(), items.end(), [](std::shared_ptr<AbstractProjectItem> a, std::shared_ptr<AbstractProjectItem>b) { return a->depth() > b->depth();
     // });
     QStringList notDeleted;
+    // The undo command keeps the deleted clips and their producers alive, estimate their size from their xml description
+    size_t deletedCost = 0;
     for (const auto &item : items) {
+        QDomDocument doc;
+        doc.appendChild(item->toXml(doc));
+        deletedCost += size_t(doc.toString(-1).size()) * sizeof(QChar);
         if (!m_itemModel->requestBinClipDeletion(item, undo, redo)) {
             notDeleted << item->name();
         }
@@ -1827,7 +1832,7 @@ void Bin::slotDeleteClip()
     if (!notDeleted.isEmpty()) {
         KMessageBox::errorList(this, i18n("Some items could not be deleted. Maybe there are instances on locked tracks?"), notDeleted);
     }
-    pCore->pushUndo(undo, redo, i18n("Delete bin Clips"));
+    pCore->pushUndo(undo, redo, i18n("Delete bin Clips"), deletedCost);
 }
 
 void Bin::slotReloadClip()
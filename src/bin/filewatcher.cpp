@@ -6,31 +6,48 @@
 #include "filewatcher.hpp"
 
 #include <KDirWatch>
+#include <QDateTime>
 #include <QFileInfo>
 
+namespace {
+/// Number of queued files added to the watcher at once
+constexpr int queueBatchSize = 50;
+} // namespace
+
 FileWatcher::FileWatcher(QObject *parent)
     : QObject(parent)
     , m_fileWatcher(new KDirWatch)
 {
-    // Init clip modification tracker
-    m_modifiedTimer.setInterval(2000);
-    connect(m_fileWatcher.get(), &KDirWatch::dirty, this, &FileWatcher::slotUrlModified);
-    connect(m_fileWatcher.get(), &KDirWatch::deleted, this, &FileWatcher::slotUrlMissing);
-    connect(m_fileWatcher.get(), &KDirWatch::created, this, &FileWatcher::slotUrlAdded);
-    connect(&m_modifiedTimer, &QTimer::timeout, this, &FileWatcher::slotProcessModifiedUrls);
+    // Init clip modification tracker. A file is reloaded once its fingerprint did not change during a whole interval
+    m_changesTimer.setInterval(1000);
+    m_changesTimer.setSingleShot(true);
+    connect(m_fileWatcher.get(), &KDirWatch::dirty, this, &FileWatcher::slotFolderChanged);
+    connect(m_fileWatcher.get(), &KDirWatch::deleted, this, &FileWatcher::slotFolderChanged);
+    connect(m_fileWatcher.get(), &KDirWatch::created, this, &FileWatcher::slotFolderChanged);
+    connect(&m_changesTimer, &QTimer::timeout, this, &FileWatcher::slotProcessChanges);
     m_queueTimer.setInterval(300);
     m_queueTimer.setSingleShot(true);
     connect(&m_queueTimer, &QTimer::timeout, this, &FileWatcher::slotProcessQueue);
 }
 
+FileWatcher::Fingerprint FileWatcher::fingerprint(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!info.exists()) {
+        return Fingerprint();
+    }
+    return {info.size(), info.lastModified().toMSecsSinceEpoch()};
+}
+
 void FileWatcher::slotProcessQueue()
 {
-    if (m_pendingUrls.size() == 0) {
-        return;
+    for (int i = 0; i < queueBatchSize && !m_pendingUrls.empty(); ++i) {
+        auto iter = m_pendingUrls.begin();
+        const QString binId = iter->first;
+        const QString url = iter->second;
+        m_pendingUrls.erase(iter);
+        doAddFile(binId, url);
     }
-    auto iter = m_pendingUrls.begin();
-    doAddFile(iter->first, iter->second);
-    m_pendingUrls.erase(iter->first);
     if (m_pendingUrls.size() > 0 && !m_queueTimer.isActive()) {
         m_queueTimer.start();
     }
@@ -59,8 +76,14 @@ void FileWatcher::doAddFile(const QString &binId, const QString &url)
         return;
     }
     if (m_occurences.count(url) == 0) {
-        // QtConcurrent::run([=] { KDirWatch::self()->addFile(url); });
-        m_fileWatcher->addFile(url);
+        const QString folder = QFileInfo(url).absolutePath();
+        std::unordered_set<QString> &files = m_folders[folder];
+        if (files.empty()) {
+            // A single watch for all the files of a folder
+            m_fileWatcher->addDir(folder, KDirWatch::WatchFiles);
+        }
+        files.insert(url);
+        m_fingerprints[url] = fingerprint(url);
     }
     m_occurences[url].insert(binId);
     m_binClipPaths[binId] = url;
@@ -68,6 +91,7 @@ void FileWatcher::doAddFile(const QString &binId, const QString &url)
 
 void FileWatcher::removeFile(const QString &binId)
 {
+    m_pendingUrls.erase(binId);
     if (m_binClipPaths.count(binId) == 0) {
         return;
     }
@@ -75,68 +99,120 @@ void FileWatcher::removeFile(const QString &binId)
     m_occurences[url].erase(binId);
     m_binClipPaths.erase(binId);
     if (m_occurences[url].empty()) {
-        m_fileWatcher->removeFile(url);
         m_occurences.erase(url);
+        removeUrl(url);
     }
 }
 
-void FileWatcher::slotUrlModified(const QString &path)
+void FileWatcher::removeUrl(const QString &url)
 {
-    if (m_modifiedUrls.insert(path).second) {
-        for (const QString &id : m_occurences[path]) {
-            Q_EMIT binClipWaiting(id);
-        }
+    m_fingerprints.erase(url);
+    m_modifiedUrls.erase(url);
+    const QString folder = QFileInfo(url).absolutePath();
+    auto pos = m_folders.find(folder);
+    if (pos == m_folders.end()) {
+        return;
     }
-    if (!m_modifiedTimer.isActive()) {
-        m_modifiedTimer.start();
+    pos->second.erase(url);
+    if (pos->second.empty()) {
+        m_fileWatcher->removeDir(folder);
+        m_folders.erase(pos);
+        m_changedFolders.erase(folder);
     }
 }
 
-void FileWatcher::slotUrlAdded(const QString &path)
+void FileWatcher::slotFolderChanged(const QString &path)
 {
-    for (const QString &id : m_occurences[path]) {
-        Q_EMIT binClipModified(id);
+    // We either get the watched folder (file created or deleted) or a file inside it
+    QString folder = path;
+    if (m_folders.count(folder) == 0) {
+        folder = QFileInfo(path).absolutePath();
+        if (m_folders.count(folder) == 0) {
+            return;
+        }
     }
+    m_changedFolders.insert(folder);
+    scheduleChanges();
 }
 
-void FileWatcher::slotUrlMissing(const QString &path)
+void FileWatcher::scheduleChanges()
 {
-    for (const QString &id : m_occurences[path]) {
-        Q_EMIT binClipMissing(id);
+    // Don't restart a running timer, a folder that keeps changing must not postpone the other reloads forever
+    if (!m_changesTimer.isActive()) {
+        m_changesTimer.start();
     }
 }
 
-void FileWatcher::slotProcessModifiedUrls()
+void FileWatcher::slotProcessChanges()
 {
-    auto checkList = m_modifiedUrls;
-    for (const QString &path : checkList) {
-        if (m_fileWatcher->ctime(path).msecsTo(QDateTime::currentDateTime()) > 2000) {
-            for (const QString &id : m_occurences[path]) {
-                Q_EMIT binClipModified(id);
+    // Files waiting for the end of their modification, and all the watched files of changed folders
+    std::unordered_set<QString> checkList = m_modifiedUrls;
+    for (const QString &folder : m_changedFolders) {
+        auto pos = m_folders.find(folder);
+        if (pos != m_folders.end()) {
+            checkList.insert(pos->second.begin(), pos->second.end());
+        }
+    }
+    m_changedFolders.clear();
+    QStringList waiting;
+    QStringList missing;
+    QStringList modified;
+    for (const QString &url : checkList) {
+        auto known = m_fingerprints.find(url);
+        if (known == m_fingerprints.end()) {
+            continue;
+        }
+        const Fingerprint current = fingerprint(url);
+        const std::unordered_set<QString> &ids = m_occurences[url];
+        if (current != known->second) {
+            known->second = current;
+            if (!current.exists()) {
+                m_modifiedUrls.erase(url);
+                missing.append(QStringList(ids.begin(), ids.end()));
+            } else if (m_modifiedUrls.insert(url).second) {
+                waiting.append(QStringList(ids.begin(), ids.end()));
             }
-            m_modifiedUrls.erase(path);
+            // The file may still be written, check again after the next interval
+            continue;
+        }
+        if (m_modifiedUrls.erase(url) > 0) {
+            modified.append(QStringList(ids.begin(), ids.end()));
         }
     }
-    if (m_modifiedUrls.empty()) {
-        m_modifiedTimer.stop();
+    // Signals are sent once all the files are checked, since their receivers may change the watched files
+    for (const QString &id : std::as_const(waiting)) {
+        Q_EMIT binClipWaiting(id);
+    }
+    for (const QString &id : std::as_const(missing)) {
+        Q_EMIT binClipMissing(id);
+    }
+    if (!modified.isEmpty()) {
+        Q_EMIT binClipsModified(modified);
+    }
+    if (!m_modifiedUrls.empty()) {
+        scheduleChanges();
     }
 }
 
 void FileWatcher::clear()
 {
     m_queueTimer.stop();
+    m_changesTimer.stop();
     m_fileWatcher->stopScan();
-    for (const auto &f : m_occurences) {
-        m_fileWatcher->removeFile(f.first);
+    for (const auto &f : m_folders) {
+        m_fileWatcher->removeDir(f.first);
     }
     m_pendingUrls.clear();
     m_occurences.clear();
+    m_folders.clear();
+    m_fingerprints.clear();
     m_modifiedUrls.clear();
+    m_changedFolders.clear();
     m_binClipPaths.clear();
     m_fileWatcher->startScan();
 }
 
 bool FileWatcher::contains(const QString &path) const
 {
-    return m_fileWatcher->contains(path);
+    return m_occurences.count(path) > 0;
 }
@@ -14,12 +14,25 @@
 /** @class FileWatcher
     @brief This class is responsible for watching all files used in the project
     and triggers a reload notification when a file changes.
+    Only the folders containing the files are watched, which keeps the number of system watches low on large projects.
+    When a folder changes, the size and modification time of its watched files are compared to the previous ones to find
+    the changed files. The changes are coalesced so that a folder being synchronized only triggers one reload per clip.
  */
 class FileWatcher : public QObject
 {
     Q_OBJECT
 
 public:
+    /** @brief The size and last modification time of a file, used to detect changes */
+    struct Fingerprint
+    {
+        qint64 size{-1};
+        qint64 modified{-1};
+        bool exists() const { return size >= 0; }
+        bool operator==(const Fingerprint &other) const { return size == other.size && modified == other.modified; }
+        bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+    };
+
     // Constructor
     explicit FileWatcher(QObject *parent = nullptr);
     /** @brief Add a file to the queue for watched items */
@@ -30,38 +43,46 @@ public:
     bool contains(const QString &path) const;
     /** @brief Reset all watched files */
     void clear();
+    /** @brief Read the current fingerprint of a file, it does not exist if the file is missing */
+    static Fingerprint fingerprint(const QString &path);
 
 Q_SIGNALS:
-    /** @brief This signal is triggered whenever the file corresponding to a bin clip has been modified and should be reloaded. Note that this signal is sent no
-     * more than every 1500 ms. We also make sure that at least 1000ms has passed since the last modification of the file. */
-    void binClipModified(const QString &binId);
-    /** @brief Same signal than binClipModified, but triggers immediately. Can be useful to refresh UI without actually reloading the file (yet)*/
+    /** @brief This signal is triggered whenever the files corresponding to some bin clips have been modified and should be reloaded. Note that this signal
+     * is sent no more than every 1000 ms. We also make sure that at least 1000ms has passed since the last modification of the files. */
+    void binClipsModified(const QStringList &binIds);
+    /** @brief Triggers as soon as a change is detected. Can be useful to refresh UI without actually reloading the file (yet)*/
     void binClipWaiting(const QString &binId);
     void binClipMissing(const QString &binId);
 
 private Q_SLOTS:
-    void slotUrlModified(const QString &path);
-    void slotUrlMissing(const QString &path);
-    void slotUrlAdded(const QString &path);
-    void slotProcessModifiedUrls();
+    void slotFolderChanged(const QString &path);
+    void slotProcessChanges();
     void slotProcessQueue();
 
 private:
-    /// This is a handle to the watcher singleton, not owned by this class.
     std::unique_ptr<KDirWatch> m_fileWatcher;
     /// A list with urls as keys, and the corresponding clip ids as value
     std::unordered_map<QString, std::unordered_set<QString>> m_occurences;
     /// keys are binId, keys are stored paths
     std::unordered_map<QString, QString> m_binClipPaths;
+    /// The watched folders, with the watched urls they contain
+    std::unordered_map<QString, std::unordered_set<QString>> m_folders;
+    /// The last known fingerprint of each watched url
+    std::unordered_map<QString, Fingerprint> m_fingerprints;
 
-    /// List of files for which we received an update since the last send
+    /// List of files that changed and are not yet reloaded, waiting for the end of the modifications
     std::unordered_set<QString> m_modifiedUrls;
+    /// Folders which changed since the last check
+    std::unordered_set<QString> m_changedFolders;
 
     /// When loading a project or adding many clips, adding many files to the watcher causes a freeze, so queue them
     std::unordered_map<QString, QString> m_pendingUrls;
 
-    QTimer m_modifiedTimer;
+    QTimer m_changesTimer;
     QTimer m_queueTimer;
     /// Add a file to the list of watched items
     void doAddFile(const QString &binId, const QString &url);
+    /// Remove a watched url, and its folder if it does not contain any other watched file
+    void removeUrl(const QString &url);
+    void scheduleChanges();
 };
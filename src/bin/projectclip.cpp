@@ -18,6 +18,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "jobs/audiolevels/audiolevelstask.h"
 #include "jobs/cachetask.h"
 #include "jobs/cliploadtask.h"
+#include "jobs/keyframeindextask.h"
 #include "jobs/proxytask.h"
 #include "kdenlivesettings.h"
 #include "lib/audio/audioStreamInfo.h"
@@ -31,6 +32,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "projectitemmodel.h"
 #include "projectsubclip.h"
 #include "timeline2/model/snapmodel.hpp"
+#include "utils/filehashcache.hpp"
 #include "utils/thumbnailcache.hpp"
 #include "utils/timecode.h"
 #include "xml/xml.hpp"
@@ -445,6 +447,7 @@ void ProjectClip::reloadProducer(bool refreshOnly, bool isProxy, bool forceAudio
         pCore->taskManager.discardJobs(oid, AbstractTask::LOADJOB, true);
         pCore->taskManager.discardJobs(oid, AbstractTask::THUMBJOB);
         pCore->taskManager.discardJobs(oid, AbstractTask::CACHEJOB);
+        pCore->taskManager.discardJobs(oid, AbstractTask::KEYFRAMEINDEXJOB);
         if (QFile::exists(m_path) && (!isProxy && !hasProxy()) && m_properties) {
             clearBackupProperties();
         }
@@ -595,8 +598,12 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
     }
 
     isReloading = false;
-    // Make sure we have a hash for this clip
-    getFileHash();
+    // Make sure we have a hash for this clip, file based clips are hashed in the load task
+    if (m_masterProducer->get_int("_file_hash_ready") == 1) {
+        m_masterProducer->clear("_file_hash_ready");
+    } else {
+        getFileHash();
+    }
     Q_EMIT producerChanged(m_binId, m_clipType == ClipType::Timeline ? m_masterProducer->parent() : *m_masterProducer.get());
     connectEffectStack();
 
@@ -654,6 +661,11 @@ bool ProjectClip::setProducer(std::shared_ptr<Mlt::Producer> producer, bool gene
         (m_clipType == ClipType::AV || m_clipType == ClipType::Audio || (m_hasAudio && m_clipType != ClipType::Timeline))) {
         AudioLevelsTask::start(ObjectId(KdenliveObjectType::BinClip, m_binId.toInt(), QUuid()), this, false);
     }
+    if (!waitForTranscode && m_hasVideo && (m_clipType == ClipType::AV || m_clipType == ClipType::Video)) {
+        // Index the keyframes of the file in the background, used for fast scrubbing and thumbnails
+        setKeyframeIndex(nullptr);
+        KeyframeIndexTask::start(ObjectId(KdenliveObjectType::BinClip, m_binId.toInt(), QUuid()), this);
+    }
     // TODO: currently when adding a transform effect to a bin clip and adding
     // another transform to it in timeline there is an image distortion
     /*if (KdenliveSettings::keep_original_frame_size() && !m_usesProxy && m_clipType != ClipType::Timeline && !replacingProducer) {
@@ -1635,21 +1647,8 @@ const QString ProjectClip::hashForThumbs()
 
 const QByteArray ProjectClip::getFolderHash(const QDir &dir, QString fileName)
 {
-    QStringList files = dir.entryList(QDir::Files);
-    fileName.append(files.join(QLatin1Char(',')));
-    // Include file hash info in case we have several folders with same file names (can happen for image sequences)
-    if (!files.isEmpty()) {
-        QPair<QByteArray, qint64> hashData = calculateHash(dir.absoluteFilePath(files.first()));
-        fileName.append(hashData.first);
-        fileName.append(QString::number(hashData.second));
-        if (files.size() > 1) {
-            hashData = calculateHash(dir.absoluteFilePath(files.at(files.size() / 2)));
-            fileName.append(hashData.first);
-            fileName.append(QString::number(hashData.second));
-        }
-    }
-    QByteArray fileData = fileName.toUtf8();
-    return QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
+    // Only lists the folder if it was modified since it was last hashed
+    return FileHashCache::get()->folderHash(dir, fileName);
 }
 
 const QString ProjectClip::getFileHash()
@@ -1710,28 +1709,8 @@ const QString ProjectClip::getFileHash()
 
 const QPair<QByteArray, qint64> ProjectClip::calculateHash(const QString &path)
 {
-    QFile file(path);
-    QByteArray fileHash;
-    qint64 fSize = 0;
-    if (file.open(QIODevice::ReadOnly)) { // write size and hash only if resource points to a file
-        /*
-         * 1 MB = 1 second per 450 files (or faster)
-         * 10 MB = 9 seconds per 450 files (or faster)
-         */
-        QByteArray fileData;
-        fSize = file.size();
-        if (fSize > 2000000) {
-            fileData = file.read(1000000);
-            if (file.seek(file.size() - 1000000)) {
-                fileData.append(file.readAll());
-            }
-        } else {
-            fileData = file.readAll();
-        }
-        file.close();
-        fileHash = QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
-    }
-    return {fileHash, fSize};
+    // Only reads the file if it was modified since it was last hashed
+    return FileHashCache::get()->fileHash(path);
 }
 
 double ProjectClip::getOriginalFps() const
@@ -2189,6 +2168,50 @@ const QString ProjectClip::getAudioThumbPath(int stream)
     return audioPath;
 }
 
+const QString ProjectClip::getKeyframeIndexPath()
+{
+    bool ok;
+    QDir cacheFolder = pCore->projectManager()->cacheDir(false, &ok);
+    if (!ok) {
+        qWarning() << "Cannot write to cache folder: " << cacheFolder.absolutePath();
+        return QString();
+    }
+    const QString clipHash = hash(false);
+    if (clipHash.isEmpty()) {
+        return QString();
+    }
+    // Keyframe positions are stored in frames, so the exact frame rate is part of the file name
+    return cacheFolder.absoluteFilePath(clipHash + QStringLiteral("_%1_keyframes.dat").arg(qRound(pCore->getCurrentFps() * 100)));
+}
+
+const QString ProjectClip::getSceneScoresPath()
+{
+    bool ok;
+    QDir cacheFolder = pCore->projectManager()->cacheDir(true, &ok);
+    if (!ok) {
+        qWarning() << "Cannot write to cache folder: " << cacheFolder.absolutePath();
+        return QString();
+    }
+    const QString clipHash = hash(false);
+    if (clipHash.isEmpty()) {
+        return QString();
+    }
+    // Scores are stored with their time, they don't depend on the project frame rate
+    return cacheFolder.absoluteFilePath(clipHash + QStringLiteral("_scenes.dat"));
+}
+
+std::shared_ptr<const KeyframeIndex> ProjectClip::keyframeIndex() const
+{
+    QMutexLocker lock(&m_keyframeIndexMutex);
+    return m_keyframeIndex;
+}
+
+void ProjectClip::setKeyframeIndex(std::shared_ptr<const KeyframeIndex> index)
+{
+    QMutexLocker lock(&m_keyframeIndexMutex);
+    m_keyframeIndex = std::move(index);
+}
+
 QStringList ProjectClip::updatedAnalysisData(const QString &name, const QString &data, int offset)
 {
     if (data.isEmpty()) {
@@ -22,6 +22,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <memory>
 
 class ClipPropertiesController;
+class KeyframeIndex;
 class ProjectFolder;
 class ProjectSubClip;
 class QDomElement;
@@ -206,6 +207,13 @@ public:
     void discardAudioThumb();
     /** @brief Get path for this clip's audio thumbnail */
     const QString getAudioThumbPath(int stream);
+    /** @brief Get path for this clip's cached keyframe index */
+    const QString getKeyframeIndexPath();
+    /** @brief Get path for this clip's cached scene change scores */
+    const QString getSceneScoresPath();
+    /** @brief Returns the keyframe index of the clip's video stream, nullptr until it was built */
+    std::shared_ptr<const KeyframeIndex> keyframeIndex() const;
+    void setKeyframeIndex(std::shared_ptr<const KeyframeIndex> index);
     /** @brief Returns true if this producer has audio and can be splitted on timeline*/
     bool isSplittable() const;
 
@@ -413,6 +421,8 @@ public Q_SLOTS:
 
 private:
     QMutex m_producerMutex;
+    mutable QMutex m_keyframeIndexMutex;
+    std::shared_ptr<const KeyframeIndex> m_keyframeIndex;
     QByteArray m_thumbXml;
     const QString geometryWithOffset(const QString &data, int offset);
     QVector<MaskInfo> m_masks;
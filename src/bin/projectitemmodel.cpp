@@ -38,6 +38,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QJsonObject>
 #include <QMimeData>
 #include <QProgressDialog>
+#include <QSet>
 #include <QStorageInfo>
 #include <QTemporaryFile>
 
@@ -62,7 +63,7 @@ ProjectItemModel::ProjectItemModel(QObject *parent)
     QPixmap pix(QSize(160, 90));
     pix.fill(Qt::lightGray);
     m_blankThumb.addPixmap(pix);
-    connect(m_fileWatcher.get(), &FileWatcher::binClipModified, this, &ProjectItemModel::reloadClip);
+    connect(m_fileWatcher.get(), &FileWatcher::binClipsModified, this, &ProjectItemModel::reloadClips);
     connect(m_fileWatcher.get(), &FileWatcher::binClipWaiting, this, &ProjectItemModel::setClipWaiting);
     connect(m_fileWatcher.get(), &FileWatcher::binClipMissing, this, &ProjectItemModel::setClipInvalid);
     missingClipTimer.setInterval(500);
@@ -1828,12 +1829,22 @@ QMap<QString, QString> ProjectItemModel::getProxies(const QString &root)
     return m_binPlaylist->getProxies(root);
 }
 
-void ProjectItemModel::reloadClip(const QString &binId)
+void ProjectItemModel::reloadClips(const QStringList &binIds)
 {
     QWriteLocker locker(&m_lock);
-    std::shared_ptr<ProjectClip> clip = getClipByBinID(binId);
-    if (clip) {
-        clip->reloadProducer();
+    QSet<QString> reloaded;
+    for (const QString &binId : binIds) {
+        if (reloaded.contains(binId)) {
+            continue;
+        }
+        reloaded.insert(binId);
+        std::shared_ptr<ProjectClip> clip = getClipByBinID(binId);
+        if (clip) {
+            // Loading the other clips is more urgent than the thumbnails
+            pCore->taskManager.lowerNextTasksPriority(ObjectId(KdenliveObjectType::BinClip, binId.toInt(), QUuid()),
+                                                      {AbstractTask::THUMBJOB, AbstractTask::AUDIOTHUMBJOB, AbstractTask::CACHEJOB});
+            clip->reloadProducer();
+        }
     }
 }
 
@@ -218,8 +218,9 @@ public:
     /** @brief Retrieve a list of proxy/original urls */
     QMap<QString, QString> getProxies(const QString &root);
 
-    /** @brief Request that the producer of a given clip is reloaded */
-    void reloadClip(const QString &binId);
+    /** @brief Request that the producers of the given clips are reloaded, used when their files changed on disk.
+     *  The thumbnails are regenerated after the other pending jobs */
+    void reloadClips(const QStringList &binIds);
 
     /** @brief Set the status of the clip to "waiting". This happens when the corresponding file has changed*/
     void setClipWaiting(const QString &binId);
@@ -968,9 +968,11 @@ void Core::profileChanged()
     GenTime::setFps(getCurrentFps());
 }
 
-void Core::pushUndo(const Fun &undo, const Fun &redo, const QString &text)
+void Core::pushUndo(const Fun &undo, const Fun &redo, const QString &text, size_t memoryCost)
 {
-    undoStack()->push(new FunctionalUndoCommand(undo, redo, text));
+    auto *command = new FunctionalUndoCommand(undo, redo, text);
+    command->addMemoryCost(memoryCost);
+    undoStack()->push(command);
 }
 
 void Core::pushUndo(QUndoCommand *command)
@@ -192,8 +192,9 @@ public:
     void profileChanged();
 
     /** @brief Create and push and undo object based on the corresponding functions
-        Note that if you class permits and requires it, you should use the macro PUSH_UNDO instead*/
-    void pushUndo(const Fun &undo, const Fun &redo, const QString &text);
+        Note that if you class permits and requires it, you should use the macro PUSH_UNDO instead
+        @param memoryCost the size of large data (xml, producer state) captured by the functions, in bytes */
+    void pushUndo(const Fun &undo, const Fun &redo, const QString &text, size_t memoryCost = 0);
     void pushUndo(QUndoCommand *command);
     /** @brief display timeline selection info in statusbar */
     void displaySelectionMessage(const QString &message);
@@ -467,8 +468,6 @@ Q_SIGNALS:
     void updatePalette();
     /** @brief Emitted when a clip is resized (to handle clip monitor inserted zones) */
     void clipInstanceResized(const QString &binId);
-    /** @brief Contains the project audio levels */
-    void audioLevelsAvailable(const QVector<double> &levels);
     /** @brief A frame was displayed in monitor, update audio mixer */
     void updateMixerLevels(int pos);
     /** @brief Audio recording was started or stopped*/
@@ -53,6 +53,7 @@
 #include <QProcess>
 #include <QScreen>
 #include <QScrollBar>
+#include <QSet>
 #include <QStandardPaths>
 #include <QString>
 #include <QTemporaryFile>
@@ -79,7 +80,10 @@ enum {
     LastTimeRole,
     LastFrameRole,
     OpenBrowserRole,
-    PlayAfterRole
+    PlayAfterRole,
+    ThreadsRole,
+    DependenciesRole,
+    GroupRole
 };
 
 // Running job status
@@ -255,6 +259,17 @@ RenderWidget::RenderWidget(bool enableProxy, QWidget *parent)
     connect(m_view.encoder_threads, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KdenliveSettings::setEncodethreads);
     connect(m_view.encoder_threads, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &RenderWidget::refreshParams);
 
+    m_view.render_segments->setMaximum(QThread::idealThreadCount());
+    m_view.render_segments->setValue(KdenliveSettings::rendersegments());
+    connect(m_view.render_segments, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &KdenliveSettings::setRendersegments);
+
+    m_view.concurrent_jobs->setMaximum(QThread::idealThreadCount());
+    m_view.concurrent_jobs->setValue(KdenliveSettings::concurrentrenderjobs());
+    connect(m_view.concurrent_jobs, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, [this](int jobs) {
+        KdenliveSettings::setConcurrentrenderjobs(jobs);
+        checkRenderStatus();
+    });
+
     connect(m_view.video_box, &QGroupBox::toggled, this, &RenderWidget::refreshParams);
     connect(m_view.audio_box, &QGroupBox::toggled, this, &RenderWidget::refreshParams);
     connect(m_view.rescale, &QAbstractButton::toggled, this, &RenderWidget::setRescaleEnabled);
@@ -719,6 +734,8 @@ void RenderWidget::slotPrepareExport2(bool delayedRendering)
     request->setEmbedSubtitles(m_view.embed_subtitles->isEnabled() && m_view.embed_subtitles->isChecked());
     request->setTwoPass(m_view.checkTwoPass->isChecked());
     request->setAudioFilePerTrack(m_view.stemAudioExport->isChecked() && m_view.stemAudioExport->isEnabled());
+    request->setSegmentedRendering(m_view.render_segments->value());
+    request->setCheckpointLength(KdenliveSettings::renderresumeinterval() * 60 * qRound(pCore->getCurrentFps()));
 
     bool guideMultiExport = m_view.guide_multi_box->isChecked();
     int guideCategory = m_view.guideCategoryChooser->currentCategory();
@@ -805,7 +822,12 @@ RenderJobItem *RenderWidget::createRenderJob(const RenderRequest::RenderJob &job
     qDebug() << "* CREATED JOB WITH ARGS: " << argsJob;
     renderItem->setData(1, OpenBrowserRole, m_view.open_browser->isChecked());
     renderItem->setData(1, PlayAfterRole, m_view.play_after->isChecked());
-    if (!m_view.audio_box->isChecked()) {
+    renderItem->setData(1, ThreadsRole, job.threads);
+    renderItem->setData(1, DependenciesRole, job.dependencies);
+    renderItem->setData(1, GroupRole, job.manifestPath);
+    if (!job.extraInfo.isEmpty()) {
+        renderItem->setData(1, ExtraInfoRole, job.extraInfo);
+    } else if (!m_view.audio_box->isChecked()) {
         renderItem->setData(1, ExtraInfoRole, i18n("Video without audio track"));
     } else if (!m_view.video_box->isChecked()) {
         renderItem->setData(1, ExtraInfoRole, i18n("Audio without video track"));
@@ -822,45 +844,118 @@ void RenderWidget::checkRenderStatus()
         return;
     }
 
-    // Make sure no other rendering is running
-    if (runningJobsCount() > 0) {
-        return;
-    }
-
+    // Count running jobs and the processor cores they use. The segments of a segmented render count as a single job,
+    // they are only limited by the cores they share
+    const int maxJobs = qMax(1, KdenliveSettings::concurrentrenderjobs());
+    const int maxThreads = QThread::idealThreadCount();
+    int runningJobs = 0;
+    int usedThreads = 0;
+    QSet<QString> runningGroups;
     auto *item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
+    while (item != nullptr) {
+        if (item->status() == RUNNINGJOB || item->status() == STARTINGJOB) {
+            const QString group = item->data(1, GroupRole).toString();
+            if (group.isEmpty()) {
+                runningJobs++;
+            } else if (!runningGroups.contains(group)) {
+                runningGroups.insert(group);
+                runningJobs++;
+            }
+            usedThreads += qMax(1, item->data(1, ThreadsRole).toInt());
+        }
+        item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+    }
 
-    bool waitingJob = false;
-
-    // Find first waiting job
+    // Start waiting jobs in queue order, as long as there are enough free cores
+    item = static_cast<RenderJobItem *>(m_view.running_jobs->topLevelItem(0));
     while (item != nullptr) {
-        if (item->status() == WAITINGJOB) {
-            QDateTime t = QDateTime::currentDateTime();
-            item->setData(1, StartTimeRole, t);
-            item->setData(1, LastTimeRole, t);
-            waitingJob = true;
-            startRendering(item);
-            // Check for 2 pass encoding
-            QStringList jobData = item->data(1, ParametersRole).toStringList();
-            if (jobData.size() > 2 && jobData.at(1).endsWith(QStringLiteral("-pass2.mlt"))) {
-                // Find and remove 1st pass job
-                QTreeWidgetItem *above = m_view.running_jobs->itemAbove(item);
-                QString firstPassName = jobData.at(1).section(QLatin1Char('-'), 0, -2) + QStringLiteral(".mlt");
-                while (above) {
-                    QStringList aboveData = above->data(1, ParametersRole).toStringList();
-                    qDebug() << "// GOT  JOB: " << aboveData.at(1);
-                    if (aboveData.size() > 2 && aboveData.at(1) == firstPassName) {
-                        delete above;
-                        break;
-                    }
-                    above = m_view.running_jobs->itemAbove(above);
+        if (item->status() != WAITINGJOB) {
+            item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+            continue;
+        }
+        const int threads = qMax(1, item->data(1, ThreadsRole).toInt());
+        const QString group = item->data(1, GroupRole).toString();
+        const bool groupRunning = !group.isEmpty() && runningGroups.contains(group);
+        if (runningJobs >= maxJobs && !groupRunning) {
+            // Only the other segments of a running render can still start
+            item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+            continue;
+        }
+        QTreeWidgetItem *firstPass = nullptr;
+        // Check for 2 pass encoding
+        QStringList jobData = item->data(1, ParametersRole).toStringList();
+        if (jobData.size() > 2 && jobData.at(1).endsWith(QStringLiteral("-pass2.mlt"))) {
+            // Find 1st pass job
+            QTreeWidgetItem *above = m_view.running_jobs->itemAbove(item);
+            QString firstPassName = jobData.at(1).section(QLatin1Char('-'), 0, -2) + QStringLiteral(".mlt");
+            while (above) {
+                QStringList aboveData = above->data(1, ParametersRole).toStringList();
+                qDebug() << "// GOT  JOB: " << aboveData.at(1);
+                if (aboveData.size() > 2 && aboveData.at(1) == firstPassName) {
+                    firstPass = above;
+                    break;
                 }
+                above = m_view.running_jobs->itemAbove(above);
             }
-            item->setStatus(STARTINGJOB);
-            break;
         }
-        item = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+        auto *next = static_cast<RenderJobItem *>(m_view.running_jobs->itemBelow(item));
+        // Check that the jobs producing our input (like the segments of a segmented render) are finished
+        bool blocked = false;
+        bool dependencyFailed = false;
+        const QStringList dependencies = item->data(1, DependenciesRole).toStringList();
+        for (const QString &dependency : dependencies) {
+            const QList<QTreeWidgetItem *> found = m_view.running_jobs->findItems(dependency, Qt::MatchExactly, 1);
+            if (found.isEmpty()) {
+                // Job was removed from the queue, kdenlive_render will check that its output exists
+                continue;
+            }
+            int dependencyStatus = static_cast<RenderJobItem *>(found.first())->status();
+            if (dependencyStatus == WAITINGJOB || dependencyStatus == STARTINGJOB || dependencyStatus == RUNNINGJOB) {
+                blocked = true;
+            } else if (dependencyStatus != FINISHEDJOB) {
+                dependencyFailed = true;
+            }
+        }
+        if (dependencyFailed && !blocked) {
+            item->setStatus(FAILEDJOB);
+            m_view.error_log->append(i18n("<strong>Rendering of %1 failed</strong><br />", item->text(1)));
+            m_view.error_log->append(i18n("A segment of this render failed."));
+            m_view.error_log->append(QStringLiteral("<hr />"));
+            m_view.error_box->setVisible(true);
+        }
+        if (blocked || dependencyFailed) {
+            item = next;
+            continue;
+        }
+        if (firstPass) {
+            int firstPassStatus = static_cast<RenderJobItem *>(firstPass)->status();
+            if (firstPassStatus == WAITINGJOB || firstPassStatus == STARTINGJOB || firstPassStatus == RUNNINGJOB) {
+                // Second pass has to wait for the first one
+                item = next;
+                continue;
+            }
+        }
+        if (usedThreads > 0 && usedThreads + threads > maxThreads) {
+            // Not enough free cores for this job, try the next ones
+            item = next;
+            continue;
+        }
+        QDateTime t = QDateTime::currentDateTime();
+        item->setData(1, StartTimeRole, t);
+        item->setData(1, LastTimeRole, t);
+        startRendering(item);
+        delete firstPass;
+        item->setStatus(STARTINGJOB);
+        if (group.isEmpty()) {
+            runningJobs++;
+        } else if (!groupRunning) {
+            runningGroups.insert(group);
+            runningJobs++;
+        }
+        usedThreads += threads;
+        item = next;
     }
-    if (!waitingJob && m_view.shutdown->isChecked()) {
+    if (runningJobs == 0 && m_view.shutdown->isChecked()) {
         Q_EMIT shutdown();
     }
 }
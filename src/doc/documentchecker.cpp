@@ -11,12 +11,16 @@
 #include "kdenlivesettings.h"
 #include "titler/titlewidget.h"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/filehashcache.hpp"
 #include "xml/xml.hpp"
 
 #include <KLocalizedString>
 
 #include <QCryptographicHash>
 #include <QStandardPaths>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentMap>
 
 QDebug operator<<(QDebug qd, const DocumentChecker::DocumentResource &item)
 {
@@ -344,6 +348,44 @@ bool DocumentChecker::hasErrorInProject()
         m_doc.documentElement().setAttribute(QStringLiteral("modified"), 1);
     }
 
+    // Check all referenced files in one parallel batch, lumas and assets included
+    const QStringList lumaFiles = getAssetsFilesByMltTag(m_doc, QStringLiteral("transition"), getLumaPairs());
+    const QStringList assetFiles = getAssetsFilesByMltTag(m_doc, QStringLiteral("filter"), getAssetPairs());
+    QStringList pathsToCheck;
+    QStringList pathsToHash;
+    auto collectPaths = [this, &pathsToCheck, &pathsToHash](const QDomNodeList &items) {
+        int count = items.count();
+        for (int i = 0; i < count; ++i) {
+            const QDomElement e = items.item(i).toElement();
+            const QString resource = getProducerResource(e);
+            if (!resource.isEmpty()) {
+                pathsToCheck << resource;
+                if (Xml::getXmlProperty(e, QStringLiteral("mlt_service")).startsWith(QLatin1String("avformat")) &&
+                    Xml::hasXmlProperty(e, QStringLiteral("kdenlive:file_hash")) && m_binIds.contains(e.attribute(QLatin1String("id")))) {
+                    pathsToHash << resource;
+                }
+            }
+            const QString proxy = Xml::getXmlProperty(e, QStringLiteral("kdenlive:proxy"));
+            if (proxy.length() > 1) {
+                pathsToCheck << ensureAbsolutePath(proxy);
+            }
+            const QString original = Xml::getXmlProperty(e, QStringLiteral("kdenlive:originalurl"));
+            if (!original.isEmpty()) {
+                pathsToCheck << ensureAbsolutePath(original);
+            }
+        }
+    };
+    collectPaths(documentProducers);
+    collectPaths(documentChains);
+    for (const QString &file : lumaFiles) {
+        pathsToCheck << ensureAbsolutePath(file);
+    }
+    for (const QString &file : assetFiles) {
+        pathsToCheck << ensureAbsolutePath(file);
+    }
+    prefetchFileStatus(pathsToCheck, pathsToHash);
+    Q_EMIT pCore->loadingMessageNewStage(i18n("Checking for missing items…"), taskCount);
+
     QStringList verifiedPaths;
     max = documentProducers.count();
     for (int i = 0; i < max; ++i) {
@@ -411,11 +453,10 @@ bool DocumentChecker::hasErrorInProject()
     }
 
     // Check existence of luma files
-    QStringList filesToCheck = getAssetsFilesByMltTag(m_doc, QStringLiteral("transition"), getLumaPairs());
-    for (const QString &lumafile : std::as_const(filesToCheck)) {
+    for (const QString &lumafile : lumaFiles) {
         QString filePath = ensureAbsolutePath(lumafile);
 
-        if (QFile::exists(filePath)) {
+        if (fileExists(filePath)) {
             // everything is fine, we can stop here
             continue;
         }
@@ -481,11 +522,10 @@ bool DocumentChecker::hasErrorInProject()
     }
 
     // Check for missing filter assets
-    QStringList assetsToCheck = getAssetsFilesByMltTag(m_doc, QStringLiteral("filter"), getAssetPairs());
-    for (const QString &filterfile : std::as_const(assetsToCheck)) {
+    for (const QString &filterfile : assetFiles) {
         QString filePath = ensureAbsolutePath(filterfile);
 
-        if (QFile::exists(filePath)) {
+        if (fileExists(filePath)) {
             // everything is fine, we can stop here
             continue;
         }
@@ -541,6 +581,91 @@ bool DocumentChecker::hasErrorInProject()
 
 DocumentChecker::~DocumentChecker() {}
 
+void DocumentChecker::prefetchFileStatus(const QStringList &paths, const QStringList &hashPaths)
+{
+    m_existingFiles.clear();
+    // Group files by parent folder
+    QMap<QString, QStringList> folders;
+    for (const QString &path : paths) {
+        if (path.isEmpty()) {
+            continue;
+        }
+        const QFileInfo info(path);
+        folders[info.absolutePath()] << info.absoluteFilePath();
+    }
+    std::vector<QStringList> batches;
+    batches.reserve(size_t(folders.size()));
+    QMapIterator<QString, QStringList> i(folders);
+    while (i.hasNext()) {
+        i.next();
+        QStringList batch = i.value();
+        batch.removeDuplicates();
+        // First item is the folder itself
+        batch.prepend(i.key());
+        batches.push_back(batch);
+    }
+    const QSet<QString> toHash(hashPaths.cbegin(), hashPaths.cend());
+    std::function<QStringList(const QStringList &)> checkFolder = [&toHash](const QStringList &batch) {
+        QStringList found;
+        const QDir dir(batch.first());
+        if (batch.size() > 3) {
+            // Several files in this folder, a single listing is cheaper than one stat per file
+            const QStringList entries = dir.entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+            const QSet<QString> names(entries.cbegin(), entries.cend());
+            for (int ix = 1; ix < batch.size(); ++ix) {
+                if (names.contains(QFileInfo(batch.at(ix)).fileName())) {
+                    found << batch.at(ix);
+                }
+            }
+        } else {
+            for (int ix = 1; ix < batch.size(); ++ix) {
+                if (QFileInfo::exists(batch.at(ix))) {
+                    found << batch.at(ix);
+                }
+            }
+        }
+        // Warm the hash cache so that the file change check does not have to read files on the GUI thread
+        for (const QString &path : std::as_const(found)) {
+            if (toHash.contains(path)) {
+                FileHashCache::get()->fileHash(path);
+            }
+        }
+        return found;
+    };
+    // Network or removable drives can make this slow, so keep the loading dialog updated while the batch runs
+    Q_EMIT pCore->loadingMessageNewStage(i18n("Checking files…"), int(batches.size()));
+    QFutureWatcher<QStringList> watcher;
+    QEventLoop loop;
+    QObject::connect(&watcher, &QFutureWatcher<QStringList>::resultReadyAt, &loop, [this, &watcher](int index) {
+        const QStringList found = watcher.resultAt(index);
+        for (const QString &path : found) {
+            m_existingFiles.insert(path);
+        }
+        Q_EMIT pCore->loadingMessageIncrease();
+    });
+    QObject::connect(&watcher, &QFutureWatcher<QStringList>::finished, &loop, &QEventLoop::quit);
+    watcher.setFuture(QtConcurrent::mapped(batches, checkFolder));
+    if (!watcher.isFinished()) {
+        // The user should not be able to act on the project while it is being checked
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+    // Results that were not delivered yet when the batch finished
+    for (const QStringList &found : watcher.future().results()) {
+        for (const QString &path : found) {
+            m_existingFiles.insert(path);
+        }
+    }
+}
+
+bool DocumentChecker::fileExists(const QString &path) const
+{
+    if (m_existingFiles.contains(path)) {
+        return true;
+    }
+    // Not part of the batch, or listing did not match (case insensitive file systems): check directly
+    return QFile::exists(path);
+}
+
 const QString DocumentChecker::relocateResource(QString sourceResource)
 {
     if (m_rootReplacement.first.isEmpty()) {
@@ -729,7 +854,7 @@ void DocumentChecker::checkMissingImagesAndFonts(const QStringList &images, cons
         if (m_safeImages.contains(img)) {
             continue;
         }
-        if (!QFile::exists(img)) {
+        if (!fileExists(img)) {
             DocumentResource item;
             item.type = MissingType::TitleImage;
             item.status = MissingStatus::Missing;
@@ -929,7 +1054,7 @@ QString DocumentChecker::getMissingProducers(QDomElement &e, const QDomNodeList
     if (isBinClip && !proxy.isEmpty() && proxy.length() > 1) {
         bool proxyFound = true;
         proxy = ensureAbsolutePath(proxy);
-        if (!QFile::exists(proxy)) {
+        if (!fileExists(proxy)) {
             // Missing clip found
             // Check if proxy exists in current storage folder
             bool fixed = false;
@@ -964,7 +1089,7 @@ QString DocumentChecker::getMissingProducers(QDomElement &e, const QDomNodeList
         item.clipId = clipId;
         item.clipType = clipType;
         item.status = MissingStatus::Missing;
-        if (!QFile::exists(original)) {
+        if (!fileExists(original)) {
             bool resourceFixed = false;
             QString movedOriginal = relocateResource(original);
             if (!movedOriginal.isEmpty()) {
@@ -1027,12 +1152,12 @@ QString DocumentChecker::getMissingProducers(QDomElement &e, const QDomNodeList
         }
     }
     const QStringList checkHashForService = {QLatin1String("qimage"), QLatin1String("pixbuf"), QLatin1String("glaxnimate")};
-    if (!QFile::exists(resource)) {
+    if (!fileExists(resource)) {
         if (service == QLatin1String("timewarp") && proxy == QLatin1String("-")) {
             // In some corrupted cases, clips with speed effect kept a reference to proxy clip in warp_resource
             QString original = Xml::getXmlProperty(e, QStringLiteral("kdenlive:originalurl"));
             original = ensureAbsolutePath(original);
-            if (original != resource && QFile::exists(original)) {
+            if (original != resource && fileExists(original)) {
                 // Fix timewarp producer
                 Xml::setXmlProperty(e, QStringLiteral("warp_resource"), original);
                 Xml::setXmlProperty(e, QStringLiteral("resource"), Xml::getXmlProperty(e, QStringLiteral("warp_speed")) + QStringLiteral(":") + original);
@@ -11,6 +11,7 @@
 
 #include <QDir>
 #include <QDomElement>
+#include <QSet>
 #include <QUrl>
 
 class DocumentChecker : public QObject
@@ -82,9 +83,19 @@ private:
     QStringList m_warnings;
     QMap<int, std::pair<QString, QUuid>> m_recoveryMap;
     QMap<int, QString> m_hashMap;
+    /** @brief Files found to exist by the prefetch batch */
+    QSet<QString> m_existingFiles;
 
     QString ensureAbsolutePath(QString filepath);
 
+    /** @brief Check the existence of @param paths in parallel before the producers are processed.
+     *  Paths are grouped by folder, so that a folder containing several of them is listed once instead of
+     *  performing one stat call per file. Files in @param hashPaths are also hashed in the same batch.
+     */
+    void prefetchFileStatus(const QStringList &paths, const QStringList &hashPaths);
+    /** @brief Returns true if the file or folder exists, using the prefetched results when available */
+    bool fileExists(const QString &path) const;
+
     /** @brief Returns list of transitions ids / tag containing luma files */
     const QMap<QString, QString> getLumaPairs() const;
     /** @brief Returns list of filters ids / tag containing asset files */
@@ -4,19 +4,90 @@
 */
 
 #include "docundostack.hpp"
+#include "kdenlivesettings.h"
+#include "undohelper.hpp"
 #include <QUndoCommand>
 #include <QUndoGroup>
 
+#include <algorithm>
+
+namespace {
+size_t commandCost(const QUndoCommand *cmd)
+{
+    size_t cost = 0;
+    if (auto *functional = dynamic_cast<const FunctionalUndoCommand *>(cmd)) {
+        cost = functional->memoryCost();
+    } else if (!cmd->isObsolete()) {
+        cost = sizeof(QUndoCommand) + size_t(cmd->text().size()) * sizeof(QChar);
+    }
+    for (int i = 0; i < cmd->childCount(); ++i) {
+        cost += commandCost(cmd->child(i));
+    }
+    return cost;
+}
+} // namespace
+
 DocUndoStack::DocUndoStack(QUndoGroup *parent)
     : QUndoStack(parent)
+    , m_memoryUsage(0)
 {
 }
 
 // TODO: custom undostack everywhere do that
 void DocUndoStack::push(QUndoCommand *cmd)
 {
-    if (index() < count()) {
-        Q_EMIT invalidate(index());
+    if (count() == 0) {
+        // The stack was cleared
+        m_memoryUsage = 0;
     }
+    const int previousIndex = index();
+    if (previousIndex < count()) {
+        Q_EMIT invalidate(previousIndex);
+        // The undone commands are deleted by the push
+        for (int i = previousIndex; i < count(); ++i) {
+            m_memoryUsage -= std::min(m_memoryUsage, commandCost(command(i)));
+        }
+    }
+    // The pushed command may be merged in the current one, or added to the current macro
+    const size_t previousTopCost = previousIndex > 0 ? commandCost(command(previousIndex - 1)) : 0;
     QUndoStack::push(cmd);
+    if (count() == previousIndex + 1) {
+        m_memoryUsage += commandCost(command(previousIndex));
+    } else if (count() == previousIndex && previousIndex > 0) {
+        m_memoryUsage = m_memoryUsage - std::min(m_memoryUsage, previousTopCost) + commandCost(command(previousIndex - 1));
+    } else {
+        m_memoryUsage = 0;
+        for (int i = 0; i < count(); ++i) {
+            m_memoryUsage += commandCost(command(i));
+        }
+    }
+    enforceMemoryBudget();
+}
+
+size_t DocUndoStack::memoryUsage() const
+{
+    return count() == 0 ? 0 : m_memoryUsage;
+}
+
+void DocUndoStack::enforceMemoryBudget()
+{
+    const size_t budget = size_t(KdenliveSettings::undomemorybudget()) * 1024 * 1024;
+    if (budget == 0 || m_memoryUsage <= budget) {
+        return;
+    }
+    // QUndoStack cannot remove its oldest commands, so we release their content instead.
+    // Only done steps are discarded, and the latest one is always kept. We stop at the first step that cannot be discarded, so that the
+    // history keeps a contiguous range of undoable steps
+    for (int i = 0; i < index() - 1 && m_memoryUsage > budget; ++i) {
+        auto *functional = dynamic_cast<FunctionalUndoCommand *>(const_cast<QUndoCommand *>(command(i)));
+        if (functional == nullptr || functional->childCount() > 0) {
+            break;
+        }
+        if (functional->isObsolete()) {
+            // Already discarded
+            continue;
+        }
+        m_memoryUsage -= std::min(m_memoryUsage, functional->memoryCost());
+        functional->discard();
+    }
 }
@@ -16,6 +16,14 @@ class DocUndoStack : public QUndoStack
 public:
     explicit DocUndoStack(QUndoGroup *parent = Q_NULLPTR);
     void push(QUndoCommand *cmd);
+    /** @brief Returns the estimated memory used by the undo history, in bytes. This is a running total updated on each push */
+    size_t memoryUsage() const;
+
+private:
+    size_t m_memoryUsage;
+    /** @brief Discards the oldest undo steps until the history fits in the undomemorybudget setting */
+    void enforceMemoryBudget();
+
 Q_SIGNALS:
     void invalidate(int ix);
 };
@@ -30,6 +30,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "timeline2/model/timelineitemmodel.hpp"
 #include "titler/titlewidget.h"
 #include "transitions/transitionsrepository.hpp"
+#include "utils/filehashcache.hpp"
 #include <config-kdenlive.h>
 
 #include <KBookmark>
@@ -598,6 +599,8 @@ void KdenliveDoc::slotAutoSave(const QString &scene)
             pCore->displayMessage(i18n("Cannot create autosave file %1", m_autosave->fileName()), ErrorMessage);
         }
         m_autosave->flush();
+        // Also keep the hashes of the clips added since the project was last saved
+        FileHashCache::get()->save();
     }
 }
 
@@ -189,8 +189,10 @@ void EffectStackModel::removeEffect(const std::shared_ptr<EffectItemModel> &effe
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
     QString effectName;
+    // The removed effect is kept alive by the undo command
+    const size_t memoryCost = AssetParameterModel::propertiesMemoryCost(*effect->getAsset());
     removeEffectWithUndo(effect, effectName, undo, redo);
-    PUSH_UNDO(undo, redo, i18n("Delete effect %1", effectName));
+    PUSH_UNDO_WITH_COST(undo, redo, i18n("Delete effect %1", effectName), memoryCost);
 }
 
 void EffectStackModel::removeEffectWithUndo(const QString &assetId, QString &effectName, int assetRow, Fun &undo, Fun &redo)
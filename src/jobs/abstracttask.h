@@ -34,7 +34,8 @@ public:
         SPEEDJOB = 10,
         CACHEJOB = 11,
         MASKJOB = 12,
-        MELTJOB = 13
+        MELTJOB = 13,
+        KEYFRAMEINDEXJOB = 14
     };
     AbstractTask(const ObjectId &owner, JOBTYPE type, QObject* object);
     ~AbstractTask() override;
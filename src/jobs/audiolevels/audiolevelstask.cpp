@@ -12,6 +12,8 @@
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "generators.h"
+#include "jobs/ingesttask.h"
+#include "kdenlivesettings.h"
 
 #include <KLocalizedString>
 #include <KMessageWidget>
@@ -38,7 +40,8 @@ void AudioLevelsTask::start(const ObjectId &owner, QObject *object, bool force)
         qDebug() << "AUDIO LEVELS TASK STARTED TWICE!!!!";
         return;
     }
-    AudioLevelsTask *task = new AudioLevelsTask(owner, object);
+    // In single pass ingest mode, the thumbnails and scene cuts are computed while reading the audio
+    AudioLevelsTask *task = KdenliveSettings::singlepassingest() ? new IngestTask(owner, object) : new AudioLevelsTask(owner, object);
     // Otherwise, start a new audio levels generation thread.
     task->m_isForce = force;
     pCore->taskManager.startTask(owner.itemId, task);
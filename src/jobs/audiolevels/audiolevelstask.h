@@ -25,8 +25,6 @@ public:
 
 protected:
     void run() override;
-
-private:
     static void storeLevels(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
     static void storeMax(const std::shared_ptr<ProjectClip> &binClip, int stream, const QVector<int16_t> &levels);
     void progressCallback(const std::shared_ptr<ProjectClip> &binClip, const QVector<int16_t> &levels, int streamIdx, int progress);
@@ -121,6 +121,121 @@ QVector<int16_t> generateMLT(const size_t streamIdx, const QString &service, con
     return levels;
 }
 
+// Levels are computed on interleaved uint16_t samples
+static const AVSampleFormat dst_sample_fmt = AV_SAMPLE_FMT_S16;
+
+AudioLevelsAccumulator::AudioLevelsAccumulator(const size_t MLTlengthInFrames, const double MLTfps)
+    : m_MLTlengthInFrames(MLTlengthInFrames)
+    , m_MLTfps(MLTfps)
+{
+}
+
+AudioLevelsAccumulator::~AudioLevelsAccumulator()
+{
+    if (m_buf) {
+        av_freep(&m_buf[0]);
+    }
+    av_freep(&m_buf);
+    av_audio_fifo_free(m_fifo);
+    swr_free(&m_swr_ctx);
+}
+
+bool AudioLevelsAccumulator::init(const AVCodecContext *codec_ctx)
+{
+    int ret = 0;
+    // Add a sample format converter (will no-op if the codec is able to directly output s16)
+    const AVChannelLayout *src_ch_layout = &codec_ctx->ch_layout;
+    const AVChannelLayout *dst_ch_layout = src_ch_layout;
+    const AVSampleFormat src_sample_fmt = codec_ctx->sample_fmt;
+    const int src_rate = codec_ctx->sample_rate;
+    m_dst_nb_channels = codec_ctx->ch_layout.nb_channels;
+    m_dst_rate = src_rate;
+
+    ret = swr_alloc_set_opts2(&m_swr_ctx, dst_ch_layout, dst_sample_fmt, m_dst_rate, src_ch_layout, src_sample_fmt, src_rate, 0, nullptr);
+    if (ret < 0) {
+        qWarning() << "Failed to set SwrContext options:" << av_err2string(ret);
+        return false;
+    }
+
+    if ((ret = swr_init(m_swr_ctx)) < 0) {
+        qWarning() << "Failed to initialize SwrContext:" << av_err2string(ret);
+        return false;
+    }
+
+    // Allocate fifo with a bit of space (will be grown automatically)
+    m_samplesPerMLTFrame = mlt_audio_calculate_frame_samples(m_MLTfps, m_dst_rate, 0);
+    m_fifo = av_audio_fifo_alloc(dst_sample_fmt, m_dst_nb_channels, 2 * m_samplesPerMLTFrame);
+
+    // Allocate levels
+    m_levels.resize(m_MLTlengthInFrames * AUDIOLEVELS_POINTS_PER_FRAME * m_dst_nb_channels);
+    return true;
+}
+
+bool AudioLevelsAccumulator::addFrame(const AVFrame *frame, const std::function<void(int progress, const QVector<int16_t> &levels)> &progressCallback)
+{
+    int ret = 0;
+    // Grow the output buffer (only if needed) to be able to store either the output from swr, or a full MLT frame's worth of data.
+    const int dst_nb_samples = swr_get_out_samples(m_swr_ctx, frame->nb_samples);
+    const int buf_nbsamples = std::max(dst_nb_samples, m_samplesPerMLTFrame);
+    if (buf_nbsamples > m_max_buf_nbsamples) {
+        if (m_buf) {
+            av_freep(&m_buf[0]);
+        }
+        av_freep(&m_buf);
+        int dst_linesize;
+        ret = av_samples_alloc_array_and_samples(&m_buf, &dst_linesize, m_dst_nb_channels, buf_nbsamples, dst_sample_fmt, 0);
+        if (ret < 0) {
+            qWarning() << "Failed to allocate output buffer:" << av_err2string(ret);
+            m_levels.clear();
+            return false;
+        }
+        m_max_buf_nbsamples = buf_nbsamples;
+    }
+
+    // Convert sample format, put data into buffer
+    ret = swr_convert(m_swr_ctx, m_buf, dst_nb_samples, const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
+    if (ret <= 0) {
+        qWarning() << "Failed to convert samples:" << av_err2string(ret);
+        m_levels.clear();
+        return false;
+    }
+
+    // Write the buffer into the fifo (grows automatically if needed)
+    ret = av_audio_fifo_write(m_fifo, reinterpret_cast<void **>(m_buf), dst_nb_samples);
+    if (ret < 0) {
+        qWarning() << "Failed to write samples to audio fifo:" << av_err2string(ret);
+        m_levels.clear();
+        return false;
+    }
+
+    // If there is enough samples for one MLT frame in the fifo, compute the peaks and advance one MLT frame !
+    while (av_audio_fifo_size(m_fifo) >= m_samplesPerMLTFrame) {
+        av_audio_fifo_read(m_fifo, reinterpret_cast<void **>(m_buf), m_samplesPerMLTFrame);
+        const size_t requiredSize = (m_MLTFrameCount + 1) * AUDIOLEVELS_POINTS_PER_FRAME * m_dst_nb_channels;
+        if (requiredSize > size_t(m_levels.size())) {
+            m_levels.resize(requiredSize);
+        }
+        computePeaks(reinterpret_cast<const int16_t *>(m_buf[0]), m_levels.data() + m_MLTFrameCount * AUDIOLEVELS_POINTS_PER_FRAME * m_dst_nb_channels,
+                     m_dst_nb_channels, m_samplesPerMLTFrame, AUDIOLEVELS_POINTS_PER_FRAME);
+
+        progressCallback(100.0 * m_MLTFrameCount / m_MLTlengthInFrames, m_levels);
+
+        m_MLTFrameCount++;
+        if (m_MLTFrameCount > m_MLTlengthInFrames) {
+            qWarning() << "MLT frame" << m_MLTFrameCount << "of" << m_MLTlengthInFrames << "is beyond the MLT length !!!";
+            m_levels.clear();
+            return false;
+        }
+        m_samplesPerMLTFrame = mlt_audio_calculate_frame_samples(m_MLTfps, m_dst_rate, m_samplesPerMLTFrame);
+    }
+    return true;
+}
+
+QVector<int16_t> &AudioLevelsAccumulator::levels()
+{
+    return m_levels;
+}
+
 QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const size_t MLTlengthInFrames, const double MLTfps,
                                const std::function<void(int progress, const QVector<int16_t> &levels)> &progressCallback, const QAtomicInt &isCanceled)
 {
@@ -129,7 +244,6 @@ QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const
     timer.start();
 
     int ret = 0;
-    size_t MLTFrameCount = 0;
 
     AVFormatContext *fmt_ctx = nullptr;
     const AVCodec *codec = nullptr;
@@ -137,19 +251,7 @@ QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const
     AVFrame *frame = av_frame_alloc();
     const AVStream *stream = nullptr;
     AVCodecContext *codec_ctx = nullptr;
-    QVector<int16_t> levels;
-    SwrContext *swr_ctx = nullptr;
-
-    uint8_t **buf = nullptr;
-    int buf_nbsamples = 0, max_buf_nbsamples = 0;
-    int src_rate, dst_rate;
-    int src_nb_channels, dst_nb_channels;
-    int dst_linesize;
-    int dst_nb_samples = 0;
-    int samplesPerMLTFrame = 0;
-    AVSampleFormat src_sample_fmt, dst_sample_fmt;
-    AVChannelLayout *src_ch_layout, *dst_ch_layout;
-    AVAudioFifo *fifo = nullptr;
+    AudioLevelsAccumulator accumulator(MLTlengthInFrames, MLTfps);
 
     // Open file
     ret = avformat_open_input(&fmt_ctx, uri.toLocal8Bit().data(), nullptr, nullptr);
@@ -198,39 +300,15 @@ QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const
         goto cleanup;
     }
 
-    // Add a sample format converter (will no-op if the codec is able to directly output s16)
-    src_ch_layout = &codec_ctx->ch_layout;
-    dst_ch_layout = src_ch_layout;
-    src_nb_channels = codec_ctx->ch_layout.nb_channels;
-    dst_nb_channels = src_nb_channels;
-    src_sample_fmt = codec_ctx->sample_fmt;
-    dst_sample_fmt = AV_SAMPLE_FMT_S16;
-    src_rate = codec_ctx->sample_rate;
-    dst_rate = src_rate;
-
-    ret = swr_alloc_set_opts2(&swr_ctx, dst_ch_layout, dst_sample_fmt, dst_rate, src_ch_layout, src_sample_fmt, src_rate, 0, nullptr);
-    if (ret < 0) {
-        qWarning() << "Failed to set SwrContext options:" << av_err2string(ret);
-        goto cleanup;
-    }
-
-    if ((ret = swr_init(swr_ctx)) < 0) {
-        qWarning() << "Failed to initialize SwrContext:" << av_err2string(ret);
+    if (!accumulator.init(codec_ctx)) {
         goto cleanup;
     }
 
-    // Allocate fifo with a bit of space (will be grown automatically)
-    samplesPerMLTFrame = mlt_audio_calculate_frame_samples(MLTfps, dst_rate, 0);
-    fifo = av_audio_fifo_alloc(dst_sample_fmt, dst_nb_channels, 2 * samplesPerMLTFrame);
-
-    // Allocate levels
-    levels.resize(MLTlengthInFrames * AUDIOLEVELS_POINTS_PER_FRAME * dst_nb_channels);
-
     // /!\ libav frames != MLT frames !
     // Read each packet in the stream
     while (av_read_frame(fmt_ctx, packet) >= 0) {
         if (isCanceled) {
-            levels.clear();
+            accumulator.levels().clear();
             break;
         }
 
@@ -242,7 +320,7 @@ QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const
         // Send encoded packet to the decoder .....
         if ((ret = avcodec_send_packet(codec_ctx, packet)) < 0) {
             qWarning() << "Error sending packet for decoding: " << av_err2string(ret);
-            levels.clear();
+            accumulator.levels().clear();
             break;
         }
 
@@ -254,79 +332,22 @@ QVector<int16_t> generateLibav(const size_t streamIdx, const QString &uri, const
             }
             if (ret < 0) {
                 qWarning() << "Error during decoding: " << av_err2string(ret);
-                levels.clear();
+                accumulator.levels().clear();
                 goto cleanup;
             }
-
-            // Grow the output buffer (only if needed) to be able to store either the output from swr, or a full MLT frame's worth of data.
-            dst_nb_samples = swr_get_out_samples(swr_ctx, frame->nb_samples);
-            buf_nbsamples = std::max(dst_nb_samples, samplesPerMLTFrame);
-            if (buf_nbsamples > max_buf_nbsamples) {
-                if (buf) {
-                    av_freep(&buf[0]);
-                }
-                av_freep(&buf);
-                ret = av_samples_alloc_array_and_samples(&buf, &dst_linesize, dst_nb_channels, buf_nbsamples, dst_sample_fmt, 0);
-                if (ret < 0) {
-                    qWarning() << "Failed to allocate output buffer:" << av_err2string(ret);
-                    levels.clear();
-                    goto cleanup;
-                }
-                max_buf_nbsamples = buf_nbsamples;
-            }
-
-            // Convert sample format, put data into buffer
-            ret = swr_convert(swr_ctx, buf, dst_nb_samples, const_cast<const uint8_t **>(frame->extended_data), frame->nb_samples);
-            if (ret <= 0) {
-                qWarning() << "Failed to convert samples:" << av_err2string(ret);
-                levels.clear();
+            if (!accumulator.addFrame(frame, progressCallback)) {
                 goto cleanup;
             }
-
-            // Write the buffer into the fifo (grows automatically if needed)
-            ret = av_audio_fifo_write(fifo, reinterpret_cast<void **>(buf), dst_nb_samples);
-            if (ret < 0) {
-                qWarning() << "Failed to write samples to audio fifo:" << av_err2string(ret);
-                levels.clear();
-                goto cleanup;
-            }
-
-            // If there is enough samples for one MLT frame in the fifo, compute the peaks and advance one MLT frame !
-            while (av_audio_fifo_size(fifo) >= samplesPerMLTFrame) {
-                av_audio_fifo_read(fifo, reinterpret_cast<void **>(buf), samplesPerMLTFrame);
-                const size_t requiredSize = (MLTFrameCount + 1) * AUDIOLEVELS_POINTS_PER_FRAME * dst_nb_channels;
-                if (requiredSize > levels.size()) {
-                    levels.resize(requiredSize);
-                }
-                computePeaks(reinterpret_cast<const int16_t *>(buf[0]), levels.data() + MLTFrameCount * AUDIOLEVELS_POINTS_PER_FRAME * dst_nb_channels,
-                             dst_nb_channels, samplesPerMLTFrame, AUDIOLEVELS_POINTS_PER_FRAME);
-
-                progressCallback(100.0 * MLTFrameCount / MLTlengthInFrames, levels);
-
-                MLTFrameCount++;
-                if (MLTFrameCount > MLTlengthInFrames) {
-                    qWarning() << "MLT frame" << MLTFrameCount << "of" << MLTlengthInFrames << "is beyond the MLT length !!!";
-                    levels.clear();
-                    goto cleanup;
-                }
-                samplesPerMLTFrame = mlt_audio_calculate_frame_samples(MLTfps, dst_rate, samplesPerMLTFrame);
-            }
         }
 
         av_packet_unref(packet);
     }
 cleanup:
-    if (buf) {
-        av_freep(&buf[0]);
-    }
-    av_freep(&buf);
-    av_audio_fifo_free(fifo);
     av_frame_free(&frame);
     av_packet_free(&packet);
     avcodec_free_context(&codec_ctx);
-    swr_free(&swr_ctx);
     avformat_close_input(&fmt_ctx);
 
     qDebug() << "Audio levels generation took" << timer.elapsed() / 1000.0 << "s (" << MLTlengthInFrames / (timer.elapsed() / 1000.0) << "frames/s)";
-    return levels;
+    return accumulator.levels();
 }
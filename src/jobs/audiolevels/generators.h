@@ -5,8 +5,15 @@
 */
 
 #pragma once
+#include <QAtomicInt>
 #include <QString>
 #include <QVector>
+#include <functional>
+
+struct AVAudioFifo;
+struct AVCodecContext;
+struct AVFrame;
+struct SwrContext;
 
 /**
  * @brief Computes peaks on interleaved multichannel audio data.
@@ -51,4 +58,39 @@ QVector<int16_t> generateMLT(size_t streamIdx, const QString &service, const QSt
  * @return the computed audio levels
  */
 QVector<int16_t> generateLibav(size_t streamIdx, const QString &uri, size_t MLTlengthInFrames, double MLTfps,
-                               const std::function<void(int progress, const QVector<int16_t> &levels)> &progressCallback, const QAtomicInt &isCanceled);
\ No newline at end of file
+                               const std::function<void(int progress, const QVector<int16_t> &levels)> &progressCallback, const QAtomicInt &isCanceled);
+
+/** @class AudioLevelsAccumulator
+ *  @brief Computes the audio levels of an audio stream from its decoded libav frames.
+ *
+ * This allows computing the levels while the file is demuxed and decoded for other purposes, see IngestTask.
+ */
+class AudioLevelsAccumulator
+{
+public:
+    /**
+     * @param MLTlengthInFrames duration of the file in MLT frames
+     * @param MLTfps frames per second
+     */
+    AudioLevelsAccumulator(size_t MLTlengthInFrames, double MLTfps);
+    ~AudioLevelsAccumulator();
+    /** @brief Prepare the sample conversion for frames decoded by @param codec_ctx, returns false on failure */
+    bool init(const AVCodecContext *codec_ctx);
+    /** @brief Process a decoded audio frame, returns false on failure, in which case the levels are cleared */
+    bool addFrame(const AVFrame *frame, const std::function<void(int progress, const QVector<int16_t> &levels)> &progressCallback);
+    /** @brief The computed audio levels */
+    QVector<int16_t> &levels();
+
+private:
+    size_t m_MLTlengthInFrames;
+    double m_MLTfps;
+    size_t m_MLTFrameCount{0};
+    QVector<int16_t> m_levels;
+    SwrContext *m_swr_ctx{nullptr};
+    AVAudioFifo *m_fifo{nullptr};
+    uint8_t **m_buf{nullptr};
+    int m_max_buf_nbsamples{0};
+    int m_dst_nb_channels{0};
+    int m_dst_rate{0};
+    int m_samplesPerMLTFrame{0};
+};
@@ -765,6 +765,32 @@ void ClipLoadTask::run()
             if (transcode) {
                 producer->set("_wait_for_transcode", 1);
             }
+            // Hash file based clips in this thread so that the GUI thread does not have to read the file
+            if (type != ClipType::Text && type != ClipType::TextTemplate && type != ClipType::QText && type != ClipType::Color &&
+                type != ClipType::Timeline) {
+                QString hashPath = producer->get("kdenlive:originalurl");
+                if (hashPath.isEmpty()) {
+                    hashPath = producer->get("resource");
+                }
+                if (!hashPath.isEmpty()) {
+                    if (QFileInfo(hashPath).isRelative()) {
+                        hashPath.prepend(pCore->currentDoc()->documentRoot());
+                    }
+                    QFileInfo info(hashPath);
+                    QByteArray fileHash;
+                    if (type == ClipType::SlideShow) {
+                        fileHash = ProjectClip::getFolderHash(info.absoluteDir(), info.fileName());
+                    } else {
+                        QPair<QByteArray, qint64> hashData = ProjectClip::calculateHash(info.absoluteFilePath());
+                        fileHash = hashData.first;
+                        producer->set("kdenlive:file_size", QString::number(hashData.second).toUtf8().constData());
+                    }
+                    if (!fileHash.isEmpty()) {
+                        producer->set("kdenlive:file_hash", fileHash.toHex().constData());
+                        producer->set("_file_hash_ready", 1);
+                    }
+                }
+            }
             QMetaObject::invokeMethod(binClip.get(), "setProducer", Qt::QueuedConnection, Q_ARG(std::shared_ptr<Mlt::Producer>, std::move(producer)),
                                       Q_ARG(bool, true));
             if (checkProfile && !isVariableFrameRate && seekable) {
@@ -0,0 +1,455 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "ingesttask.h"
+#include "audio/audioStreamInfo.h"
+#include "bin/model/markerlistmodel.hpp"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "jobs/audiolevels/generators.h"
+#include "jobs/cachetask.h"
+#include "jobs/scenedetection/scenedetector.h"
+#include "jobs/scenedetection/scenescores.h"
+#include "kdenlivesettings.h"
+#include "utils/thumbnailcache.hpp"
+
+#include <KLocalizedString>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <set>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+// Width of the downscaled frames used for scene detection
+static const int sceneScanWidth = 256;
+
+namespace {
+struct AudioConsumer
+{
+    int streamIdx;
+    AVCodecContext *codec_ctx{nullptr};
+    std::unique_ptr<AudioLevelsAccumulator> accumulator;
+    bool failed{false};
+};
+
+/** @brief Receive all the frames available from @param codec_ctx and pass them to @param process */
+bool receiveFrames(AVCodecContext *codec_ctx, AVFrame *frame, const std::function<bool()> &process)
+{
+    while (true) {
+        const int ret = avcodec_receive_frame(codec_ctx, frame);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            return true;
+        }
+        if (ret < 0) {
+            return false;
+        }
+        const bool ok = process();
+        av_frame_unref(frame);
+        if (!ok) {
+            return false;
+        }
+    }
+}
+
+AVCodecContext *openDecoder(const AVStream *stream, int threads)
+{
+    const AVCodec *codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) {
+        return nullptr;
+    }
+    AVCodecContext *codec_ctx = avcodec_alloc_context3(codec);
+    if (!codec_ctx) {
+        return nullptr;
+    }
+    if (avcodec_parameters_to_context(codec_ctx, stream->codecpar) < 0) {
+        avcodec_free_context(&codec_ctx);
+        return nullptr;
+    }
+    if (stream->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+        // Request s16 to codec, if possible
+        codec_ctx->request_sample_fmt = AV_SAMPLE_FMT_S16;
+    } else {
+        codec_ctx->thread_count = threads;
+    }
+    if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+        avcodec_free_context(&codec_ctx);
+        return nullptr;
+    }
+    return codec_ctx;
+}
+
+/** @brief Add a marker on each of the @param scenes (in seconds) of the clip @param object, like the scene detection job */
+void importSceneMarkers(QObject *object, const QList<double> &scenes)
+{
+    if (scenes.isEmpty()) {
+        return;
+    }
+    QJsonArray list;
+    int ix = 1;
+    for (double scene : scenes) {
+        QJsonObject currentMarker;
+        currentMarker.insert(QLatin1String("pos"), QJsonValue(GenTime(scene).frames(pCore->getCurrentFps())));
+        currentMarker.insert(QLatin1String("comment"), QJsonValue(i18n("Scene %1", ix)));
+        currentMarker.insert(QLatin1String("type"), QJsonValue(KdenliveSettings::default_marker_type()));
+        list.push_back(currentMarker);
+        ix++;
+    }
+    QMetaObject::invokeMethod(object, "importJsonMarkers", Q_ARG(QString, QString(QJsonDocument(list).toJson())));
+}
+} // namespace
+
+IngestTask::IngestTask(const ObjectId &owner, QObject *object)
+    : AudioLevelsTask(owner, object)
+{
+    m_description = i18n("Ingest");
+}
+
+void IngestTask::run()
+{
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        AbstractTaskDone whenFinished(m_owner.itemId, this);
+        return;
+    }
+    if (!ingest()) {
+        // The cache task skips the clips waiting for an ingest, so the hover thumbnails have to be requested here
+        const auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
+        const bool cacheThumbs = binClip != nullptr && KdenliveSettings::hoverPreview() &&
+                                 (binClip->clipType() == ClipType::AV || binClip->clipType() == ClipType::Video || binClip->clipType() == ClipType::Playlist);
+        // This task is deleted once the audio levels are done
+        const ObjectId owner = m_owner;
+        QObject *object = m_object;
+        AudioLevelsTask::run();
+        if (cacheThumbs && object != nullptr) {
+            QMetaObject::invokeMethod(object, [owner, object]() { CacheTask::start(owner, 30, 0, 0, object); }, Qt::QueuedConnection);
+        }
+        return;
+    }
+    AbstractTaskDone whenFinished(m_owner.itemId, this);
+}
+
+bool IngestTask::ingest()
+{
+    QMutexLocker lock(&m_runMutex);
+    m_running = true;
+    m_timer.start();
+    const auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
+    if (binClip == nullptr) {
+        return false;
+    }
+    std::shared_ptr<Mlt::Producer> producer = binClip->originalProducer();
+    if ((producer == nullptr) || !producer->is_valid()) {
+        return false;
+    }
+    const QString service = producer->get("mlt_service");
+    if (!service.startsWith(QLatin1String("avformat"))) {
+        // Only media files can be processed with libav
+        return false;
+    }
+    const int lengthInFrames = producer->get_length();
+    if (lengthInFrames == INT_MAX || lengthInFrames == 0) {
+        return false;
+    }
+    const QString resource = QString::fromUtf8(producer->get("resource"));
+    const double fps = producer->get_fps();
+    const QString clipId = QString::number(m_owner.itemId);
+    const bool hasVideo = binClip->clipType() == ClipType::AV || binClip->clipType() == ClipType::Video;
+
+    // Audio streams that are not cached yet
+    QList<int> audioStreams;
+    bool freshImport = true;
+    if (binClip->audioChannels() > 0 && !binClip->audioThumbCreated()) {
+        const QMap<int, QString> streams = binClip->audioInfo()->streams();
+        for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+            if (!m_isForce && QFile::exists(binClip->getAudioThumbPath(it.key()))) {
+                freshImport = false;
+                continue;
+            }
+            audioStreams << it.key();
+        }
+    }
+    // Thumbnails used by the hover preview
+    std::set<int> thumbFrames;
+    if (hasVideo && KdenliveSettings::hoverPreview()) {
+        for (int frame : CacheTask::thumbnailFrames(0, binClip->getFramePlaytime(), 30)) {
+            if (!ThumbnailCache::get()->hasThumbnail(clipId, frame)) {
+                thumbFrames.insert(frame);
+            }
+        }
+    }
+    // Scene cuts are only detected the first time a clip is imported
+    const bool detectScenes = hasVideo && KdenliveSettings::ingestscenes() && freshImport && binClip->getMarkerModel()->rowCount() == 0;
+    const double threshold = KdenliveSettings::scenesplitthreshold() / 100.;
+    // The file may have been scanned before, for example in another project
+    const QString scenesPath = detectScenes ? binClip->getSceneScoresPath() : QString();
+    const std::shared_ptr<SceneScores> cachedScores = scenesPath.isEmpty() ? nullptr : SceneScores::load(scenesPath);
+    const bool scanScenes = detectScenes && cachedScores == nullptr;
+    if (cachedScores) {
+        importSceneMarkers(m_object, cachedScores->scenes(threshold));
+    }
+    if (audioStreams.isEmpty() && thumbFrames.empty() && !scanScenes) {
+        // Nothing to decode, cached audio levels are loaded by the audio levels task
+        return false;
+    }
+
+    qDebug() << "Ingesting" << resource << "audio streams:" << audioStreams << "thumbnails:" << thumbFrames.size() << "scenes:" << scanScenes;
+    QElapsedTimer timer;
+    timer.start();
+    ScanRequest request;
+    request.lengthInFrames = lengthInFrames;
+    request.fps = fps;
+    request.audioStreams = audioStreams;
+    request.scanScenes = scanScenes;
+    if (!thumbFrames.empty() || scanScenes) {
+        request.videoIndex = binClip->getProducerIntProperty(QStringLiteral("video_index"));
+    }
+    if (!thumbFrames.empty()) {
+        const int fullWidth = qFuzzyCompare(pCore->getCurrentSar(), 1.0) ? 0 : qRound(pCore->thumbProfile().height() * pCore->getCurrentDar());
+        request.thumbFrames = thumbFrames;
+        request.thumbSize = QSize(fullWidth > 0 ? fullWidth + fullWidth % 2 : pCore->thumbProfile().width(), pCore->thumbProfile().height());
+        request.thumbnailReady = [clipId](int frame, const QImage &thumb) { ThumbnailCache::get()->storeThumbnail(clipId, frame, thumb, true); };
+    }
+    request.audioProgress = [this, binClip](int streamIdx, int progress, const QVector<int16_t> &levels) {
+        progressCallback(binClip, levels, streamIdx, progress);
+    };
+    request.videoProgress = [this](int progress) {
+        if (progress != m_progress) {
+            m_progress = progress;
+            QMetaObject::invokeMethod(m_object, "updateJobProgress");
+        }
+    };
+    ScanResult result;
+    if (!scan(resource, request, result, m_isCanceled)) {
+        return false;
+    }
+    qDebug() << "Ingest of" << resource << "took" << timer.elapsed() / 1000.0 << "s";
+    if (m_isCanceled) {
+        return true;
+    }
+
+    // Audio levels
+    for (auto it = result.levels.begin(); it != result.levels.end(); ++it) {
+        const int streamIdx = it.key();
+        QVector<int16_t> &levels = it.value();
+        if (levels.isEmpty()) {
+            // Libav could not process this stream, use MLT
+            const int channels = binClip->audioInfo()->channelsForStream(streamIdx);
+            auto clbk = [this, binClip, streamIdx](const int progress, const QVector<int16_t> &levels) {
+                progressCallback(binClip, levels, streamIdx, progress);
+            };
+            levels = generateMLT(streamIdx, QStringLiteral("avformat"), resource, channels, clbk, m_isCanceled);
+        }
+        if (!m_isCanceled && !levels.isEmpty()) {
+            storeLevels(binClip, streamIdx, levels);
+            storeMax(binClip, streamIdx, levels);
+            saveLevelsToCache(binClip->getAudioThumbPath(streamIdx), levels);
+        }
+    }
+    // Streams that were already cached
+    const QMap<int, QString> streams = binClip->audioInfo()->streams();
+    for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+        if (m_isCanceled || audioStreams.contains(it.key()) || binClip->audioChannels() == 0) {
+            continue;
+        }
+        const QVector<int16_t> levels = getLevelsFromCache(binClip->getAudioThumbPath(it.key()));
+        if (!levels.isEmpty()) {
+            storeLevels(binClip, it.key(), levels);
+            storeMax(binClip, it.key(), levels);
+        }
+    }
+    m_progress = 100;
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+    if (binClip->audioChannels() > 0) {
+        QMetaObject::invokeMethod(m_object, "updateAudioThumbnail", Q_ARG(bool, true));
+    }
+
+    // Scene cuts, using the same markers as the scene detection job
+    if (scanScenes && !result.sceneScores.isEmpty()) {
+        if (!scenesPath.isEmpty()) {
+            // Keep the scores for the scene detection job
+            result.sceneScores.save(scenesPath);
+        }
+        importSceneMarkers(m_object, result.sceneScores.scenes(threshold));
+    }
+    return true;
+}
+
+bool IngestTask::scan(const QString &resource, ScanRequest request, ScanResult &result, const QAtomicInt &isCanceled)
+{
+    AVFormatContext *fmt_ctx = nullptr;
+    if (avformat_open_input(&fmt_ctx, resource.toLocal8Bit().data(), nullptr, nullptr) < 0) {
+        return false;
+    }
+    if (avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
+        avformat_close_input(&fmt_ctx);
+        return false;
+    }
+    std::vector<AudioConsumer> audioConsumers;
+    for (int streamIdx : std::as_const(request.audioStreams)) {
+        if (streamIdx < 0 || streamIdx >= int(fmt_ctx->nb_streams)) {
+            continue;
+        }
+        AudioConsumer consumer;
+        consumer.streamIdx = streamIdx;
+        consumer.codec_ctx = openDecoder(fmt_ctx->streams[streamIdx], 1);
+        consumer.accumulator = std::make_unique<AudioLevelsAccumulator>(request.lengthInFrames, request.fps);
+        if (!consumer.codec_ctx || !consumer.accumulator->init(consumer.codec_ctx)) {
+            consumer.failed = true;
+        }
+        audioConsumers.push_back(std::move(consumer));
+    }
+    std::set<int> &thumbFrames = request.thumbFrames;
+    const bool scanScenes = request.scanScenes;
+    AVCodecContext *video_ctx = nullptr;
+    int videoIdx = -1;
+    if (!thumbFrames.empty() || scanScenes) {
+        videoIdx = request.videoIndex;
+        if (videoIdx < 0 || videoIdx >= int(fmt_ctx->nb_streams) || fmt_ctx->streams[videoIdx]->codecpar->codec_type != AVMEDIA_TYPE_VIDEO) {
+            videoIdx = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        }
+        if (videoIdx >= 0) {
+            video_ctx = openDecoder(fmt_ctx->streams[videoIdx], QThread::idealThreadCount());
+        }
+    }
+    // Only demux the streams we decode
+    for (unsigned i = 0; i < fmt_ctx->nb_streams; ++i) {
+        bool used = video_ctx != nullptr && int(i) == videoIdx;
+        for (const AudioConsumer &consumer : audioConsumers) {
+            used = used || (!consumer.failed && consumer.streamIdx == int(i));
+        }
+        fmt_ctx->streams[i]->discard = used ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+
+    const AVStream *videoStream = videoIdx >= 0 ? fmt_ctx->streams[videoIdx] : nullptr;
+    const double videoStart = videoStream && videoStream->start_time != AV_NOPTS_VALUE ? videoStream->start_time * av_q2d(videoStream->time_base) : 0.;
+    SwsContext *thumb_sws = nullptr;
+    SwsContext *scene_sws = nullptr;
+    int sceneHeight = 0;
+    const int sceneStride = (sceneScanWidth + 15) & ~15;
+    std::vector<uint8_t> sceneCurrent;
+    std::vector<uint8_t> sceneReference;
+    bool hasReference = false;
+    double previousMafd = 0.;
+
+    AVPacket *packet = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+
+    auto processVideoFrame = [&]() {
+        int64_t pts = frame->best_effort_timestamp;
+        if (pts == AV_NOPTS_VALUE) {
+            return true;
+        }
+        const double seconds = pts * av_q2d(videoStream->time_base);
+        const int position = int(std::lround((seconds - videoStart) * request.fps));
+        if (!thumbFrames.empty() && *thumbFrames.begin() <= position) {
+            thumb_sws = sws_getCachedContext(thumb_sws, frame->width, frame->height, AVPixelFormat(frame->format), request.thumbSize.width(),
+                                             request.thumbSize.height(), AV_PIX_FMT_RGB32, SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (thumb_sws) {
+                QImage thumb(request.thumbSize, QImage::Format_RGB32);
+                uint8_t *dst[4] = {thumb.bits(), nullptr, nullptr, nullptr};
+                int dstStride[4] = {int(thumb.bytesPerLine()), 0, 0, 0};
+                sws_scale(thumb_sws, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+                // A frame is used for all the positions we passed, in case of variable frame rate
+                while (!thumbFrames.empty() && *thumbFrames.begin() <= position) {
+                    if (request.thumbnailReady) {
+                        request.thumbnailReady(*thumbFrames.begin(), thumb);
+                    }
+                    thumbFrames.erase(thumbFrames.begin());
+                }
+            }
+        }
+        if (scanScenes) {
+            if (sceneHeight == 0) {
+                sceneHeight = std::max(2, int(std::lround(double(sceneScanWidth) * frame->height / std::max(1, frame->width))) & ~1);
+                sceneCurrent.assign(size_t(sceneStride) * sceneHeight, 0);
+                sceneReference.assign(size_t(sceneStride) * sceneHeight, 0);
+            }
+            scene_sws = sws_getCachedContext(scene_sws, frame->width, frame->height, AVPixelFormat(frame->format), sceneScanWidth, sceneHeight,
+                                             AV_PIX_FMT_GRAY8, SWS_AREA, nullptr, nullptr, nullptr);
+            if (scene_sws) {
+                uint8_t *dst[4] = {sceneCurrent.data(), nullptr, nullptr, nullptr};
+                int dstStride[4] = {sceneStride, 0, 0, 0};
+                sws_scale(scene_sws, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+                if (hasReference) {
+                    const uint64_t sad = planeSad(sceneCurrent.data(), sceneStride, sceneReference.data(), sceneStride, sceneScanWidth, sceneHeight);
+                    result.sceneScores.append(seconds - videoStart, sceneScore(sad, sceneScanWidth * sceneHeight, previousMafd));
+                }
+                std::swap(sceneCurrent, sceneReference);
+                hasReference = true;
+            }
+        }
+        if (audioConsumers.empty() && request.videoProgress && request.lengthInFrames > 0) {
+            request.videoProgress(qBound(0, 100 * position / request.lengthInFrames, 99));
+        }
+        return true;
+    };
+    auto audioCallback = [&request](int streamIdx) {
+        return [&request, streamIdx](const int progress, const QVector<int16_t> &levels) {
+            if (request.audioProgress) {
+                request.audioProgress(streamIdx, progress, levels);
+            }
+        };
+    };
+
+    while (!isCanceled && av_read_frame(fmt_ctx, packet) >= 0) {
+        if (video_ctx && packet->stream_index == videoIdx) {
+            if (thumbFrames.empty() && !scanScenes) {
+                // All thumbnails were extracted, stop decoding video
+                avcodec_free_context(&video_ctx);
+                fmt_ctx->streams[videoIdx]->discard = AVDISCARD_ALL;
+            } else if (avcodec_send_packet(video_ctx, packet) >= 0) {
+                receiveFrames(video_ctx, frame, processVideoFrame);
+            }
+        } else {
+            for (AudioConsumer &consumer : audioConsumers) {
+                if (consumer.failed || consumer.streamIdx != packet->stream_index) {
+                    continue;
+                }
+                const auto clbk = audioCallback(consumer.streamIdx);
+                if (avcodec_send_packet(consumer.codec_ctx, packet) < 0 ||
+                    !receiveFrames(consumer.codec_ctx, frame, [&]() { return consumer.accumulator->addFrame(frame, clbk); })) {
+                    qWarning() << "Ingest failed to decode audio stream" << consumer.streamIdx << "of" << resource;
+                    consumer.failed = true;
+                }
+                break;
+            }
+        }
+        av_packet_unref(packet);
+    }
+    if (!isCanceled) {
+        // Drain the decoders
+        if (video_ctx && avcodec_send_packet(video_ctx, nullptr) >= 0) {
+            receiveFrames(video_ctx, frame, processVideoFrame);
+        }
+        for (AudioConsumer &consumer : audioConsumers) {
+            if (!consumer.failed && avcodec_send_packet(consumer.codec_ctx, nullptr) >= 0) {
+                const auto clbk = audioCallback(consumer.streamIdx);
+                receiveFrames(consumer.codec_ctx, frame, [&]() { return consumer.accumulator->addFrame(frame, clbk); });
+            }
+        }
+    }
+
+    sws_freeContext(thumb_sws);
+    sws_freeContext(scene_sws);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&video_ctx);
+    for (AudioConsumer &consumer : audioConsumers) {
+        avcodec_free_context(&consumer.codec_ctx);
+        result.levels.insert(consumer.streamIdx, consumer.failed ? QVector<int16_t>() : consumer.accumulator->levels());
+    }
+    avformat_close_input(&fmt_ctx);
+    return true;
+}
@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "jobs/audiolevels/audiolevelstask.h"
+#include "jobs/scenedetection/scenescores.h"
+
+#include <QImage>
+#include <QMap>
+#include <QSize>
+#include <functional>
+#include <set>
+
+/** @class IngestTask
+    @brief Reads a media file once to compute the audio levels of all its streams, the cached video thumbnails and optionally
+    the scene cuts. Results are stored in the same caches as the AudioLevelsTask and CacheTask.
+    This task is used instead of the AudioLevelsTask when single pass ingest is enabled. If the file cannot be processed with
+    libav, it falls back to the regular audio levels generation and starts a CacheTask for the thumbnails.
+ */
+class IngestTask : public AudioLevelsTask
+{
+public:
+    IngestTask(const ObjectId &owner, QObject *object);
+
+    /** @brief What is computed by a single pass over a media file */
+    struct ScanRequest
+    {
+        /// Length of the clip in MLT frames, and its frame rate
+        int lengthInFrames{0};
+        double fps{25.};
+        /// The audio streams whose levels are computed
+        QList<int> audioStreams;
+        /// The video stream to decode, the best video stream of the file is used if it is not valid
+        int videoIndex{-1};
+        /// The positions of the requested thumbnails, and their size
+        std::set<int> thumbFrames;
+        QSize thumbSize;
+        /// Whether the scene change scores of the video stream are computed
+        bool scanScenes{false};
+        std::function<void(int frame, const QImage &thumb)> thumbnailReady;
+        std::function<void(int streamIdx, int progress, const QVector<int16_t> &levels)> audioProgress;
+        /// Only used when no audio stream is processed
+        std::function<void(int progress)> videoProgress;
+    };
+    struct ScanResult
+    {
+        /// The levels of each processed audio stream, empty if libav could not decode the stream
+        QMap<int, QVector<int16_t>> levels;
+        SceneScores sceneScores;
+    };
+    /** @brief Demux and decode @param resource once to compute what is described by @param request
+        @returns false if the file could not be opened with libav */
+    static bool scan(const QString &resource, ScanRequest request, ScanResult &result, const QAtomicInt &isCanceled);
+
+protected:
+    void run() override;
+
+private:
+    /** @brief Demux and decode the clip once, returns false if the regular audio levels task has to be used instead */
+    bool ingest();
+};
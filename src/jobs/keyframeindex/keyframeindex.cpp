@@ -0,0 +1,214 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "keyframeindex.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <algorithm>
+#include <cmath>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+// Version of the cache file format
+static const qint32 indexVersion = 2;
+
+KeyframeIndex::KeyframeIndex(std::vector<int> keyframes, std::vector<int64_t> offsets, int64_t fileSize)
+{
+    if (offsets.size() != keyframes.size() || fileSize <= 0) {
+        offsets.clear();
+    }
+    // Sort by frame, keeping the offset of each keyframe. Duplicates keep their first position in the file
+    std::vector<std::pair<int, int64_t>> entries;
+    entries.reserve(keyframes.size());
+    for (size_t i = 0; i < keyframes.size(); ++i) {
+        entries.emplace_back(keyframes[i], offsets.empty() ? 0 : offsets[i]);
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.first == b.first; }), entries.end());
+    for (const auto &entry : entries) {
+        m_keyframes.push_back(entry.first);
+        if (!offsets.empty()) {
+            m_offsets.push_back(entry.second);
+        }
+    }
+    if (!m_offsets.empty()) {
+        m_fileSize = fileSize;
+    }
+    for (size_t i = 1; i < m_keyframes.size(); ++i) {
+        m_maxGop = std::max(m_maxGop, m_keyframes[i] - m_keyframes[i - 1]);
+    }
+}
+
+std::shared_ptr<KeyframeIndex> KeyframeIndex::build(const QString &uri, double fps, const std::function<void(int progress)> &progressCallback,
+                                                    const QAtomicInt &isCanceled)
+{
+    QElapsedTimer timer;
+    timer.start();
+    AVFormatContext *fmt_ctx = nullptr;
+    if (avformat_open_input(&fmt_ctx, uri.toLocal8Bit().data(), nullptr, nullptr) < 0) {
+        qWarning() << "Could not open input file" << uri;
+        return nullptr;
+    }
+    if (avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
+        avformat_close_input(&fmt_ctx);
+        return nullptr;
+    }
+    const int streamIdx = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (streamIdx < 0 || (fmt_ctx->streams[streamIdx]->disposition & AV_DISPOSITION_ATTACHED_PIC)) {
+        avformat_close_input(&fmt_ctx);
+        return nullptr;
+    }
+    // Only read the packets of the indexed stream
+    for (unsigned i = 0; i < fmt_ctx->nb_streams; ++i) {
+        fmt_ctx->streams[i]->discard = int(i) == streamIdx ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+    const AVStream *stream = fmt_ctx->streams[streamIdx];
+    const double timeBase = av_q2d(stream->time_base);
+    const int64_t startTime = stream->start_time == AV_NOPTS_VALUE ? 0 : stream->start_time;
+    const int64_t fileSize = fmt_ctx->pb ? avio_size(fmt_ctx->pb) : -1;
+
+    std::vector<int> keyframes;
+    std::vector<int64_t> offsets;
+    AVPacket *packet = av_packet_alloc();
+    int lastProgress = -1;
+    bool canceled = false;
+    while (av_read_frame(fmt_ctx, packet) >= 0) {
+        if (isCanceled) {
+            canceled = true;
+            av_packet_unref(packet);
+            break;
+        }
+        if (packet->stream_index == streamIdx && (packet->flags & AV_PKT_FLAG_KEY)) {
+            const int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            if (ts != AV_NOPTS_VALUE) {
+                keyframes.push_back(std::max(0, int(std::lround((ts - startTime) * timeBase * fps))));
+                offsets.push_back(packet->pos);
+            }
+        }
+        if (fileSize > 0 && packet->pos > 0) {
+            const int progress = int(std::min<int64_t>(99, 100 * packet->pos / fileSize));
+            if (progress != lastProgress) {
+                lastProgress = progress;
+                progressCallback(progress);
+            }
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&fmt_ctx);
+    if (canceled || keyframes.empty()) {
+        return nullptr;
+    }
+    if (std::any_of(offsets.cbegin(), offsets.cend(), [](int64_t offset) { return offset < 0; })) {
+        // The container does not tell where the packets are
+        offsets.clear();
+    }
+    auto index = std::make_shared<KeyframeIndex>(std::move(keyframes), std::move(offsets), fileSize);
+    progressCallback(100);
+    qDebug() << "Keyframe index of" << uri << "built in" << timer.elapsed() << "ms," << index->count() << "keyframes, max GOP" << index->maxGopLength();
+    return index;
+}
+
+std::shared_ptr<KeyframeIndex> KeyframeIndex::load(const QString &cachePath)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    QDataStream in(&file);
+    qint32 version = 0;
+    QList<int> keyframes;
+    QList<qint64> offsets;
+    qint64 fileSize = 0;
+    in >> version;
+    if (version != indexVersion) {
+        return nullptr;
+    }
+    in >> keyframes >> offsets >> fileSize;
+    if (in.status() != QDataStream::Ok || keyframes.isEmpty()) {
+        return nullptr;
+    }
+    return std::make_shared<KeyframeIndex>(std::vector<int>(keyframes.cbegin(), keyframes.cend()), std::vector<int64_t>(offsets.cbegin(), offsets.cend()),
+                                           fileSize);
+}
+
+bool KeyframeIndex::save(const QString &cachePath) const
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write keyframe index to" << cachePath;
+        return false;
+    }
+    QDataStream out(&file);
+    out << indexVersion;
+    out << QList<int>(m_keyframes.cbegin(), m_keyframes.cend());
+    out << QList<qint64>(m_offsets.cbegin(), m_offsets.cend());
+    out << qint64(m_fileSize);
+    return out.status() == QDataStream::Ok;
+}
+
+bool KeyframeIndex::isEmpty() const
+{
+    return m_keyframes.empty();
+}
+
+int KeyframeIndex::count() const
+{
+    return int(m_keyframes.size());
+}
+
+int KeyframeIndex::previousKeyframe(int frame) const
+{
+    auto it = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), frame);
+    if (it == m_keyframes.cbegin()) {
+        return 0;
+    }
+    return *std::prev(it);
+}
+
+int KeyframeIndex::nextKeyframe(int frame) const
+{
+    auto it = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), frame);
+    return it == m_keyframes.cend() ? -1 : *it;
+}
+
+int KeyframeIndex::nearestKeyframe(int frame) const
+{
+    const int previous = previousKeyframe(frame);
+    const int next = nextKeyframe(frame);
+    if (next < 0 || frame - previous <= next - frame) {
+        return previous;
+    }
+    return next;
+}
+
+int KeyframeIndex::maxGopLength() const
+{
+    return m_maxGop;
+}
+
+bool KeyframeIndex::isLongGop(int frames) const
+{
+    return m_maxGop > frames;
+}
+
+int64_t KeyframeIndex::byteCount(int in, int out) const
+{
+    if (m_offsets.empty() || out < in) {
+        return -1;
+    }
+    auto first = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), in);
+    const int64_t start = first == m_keyframes.cbegin() ? 0 : m_offsets[size_t(std::distance(m_keyframes.cbegin(), first) - 1)];
+    auto last = std::upper_bound(m_keyframes.cbegin(), m_keyframes.cend(), out);
+    const int64_t end = last == m_keyframes.cend() ? m_fileSize : m_offsets[size_t(std::distance(m_keyframes.cbegin(), last))];
+    return std::max<int64_t>(0, end - start);
+}
@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/** @class KeyframeIndex
+    @brief The positions (in project frames) of the keyframes of a clip's video stream.
+    With long GOP files (most camera H.264 / HEVC footage), seeking to a frame requires decoding everything from the previous keyframe.
+    The index allows to pick a nearby keyframe when an exact frame is not required, for example while scrubbing or for timeline thumbnails.
+ */
+class KeyframeIndex
+{
+public:
+    /** @param offsets the position of each keyframe in the file, in bytes. Optional, allows to compute the size of a range with byteCount()
+     *  @param fileSize the size of the file, only used with @param offsets */
+    explicit KeyframeIndex(std::vector<int> keyframes, std::vector<int64_t> offsets = {}, int64_t fileSize = 0);
+
+    /** @brief Reads the packets of the best video stream of a file to build its keyframe index, nothing is decoded.
+     * @param uri the media file to process
+     * @param fps the frame rate used to convert the timestamps to frames
+     * @param progressCallback process callback function
+     * @param isCanceled task cancelled semaphor, 0 = not cancelled, 1 = cancelled
+     * @return the index, or nullptr if the file could not be processed
+     */
+    static std::shared_ptr<KeyframeIndex> build(const QString &uri, double fps, const std::function<void(int progress)> &progressCallback,
+                                                const QAtomicInt &isCanceled);
+    /** @brief Load an index previously saved with save(), returns nullptr if the file is missing or invalid */
+    static std::shared_ptr<KeyframeIndex> load(const QString &cachePath);
+    bool save(const QString &cachePath) const;
+
+    bool isEmpty() const;
+    int count() const;
+    /** @brief Returns the last keyframe at or before @param frame, 0 if there is none */
+    int previousKeyframe(int frame) const;
+    /** @brief Returns the first keyframe after @param frame, -1 if there is none */
+    int nextKeyframe(int frame) const;
+    /** @brief Returns the keyframe closest to @param frame */
+    int nearestKeyframe(int frame) const;
+    /** @brief Returns the longest distance between two keyframes, in frames */
+    int maxGopLength() const;
+    /** @brief Returns true if a seek can require decoding more than @param frames frames */
+    bool isLongGop(int frames) const;
+    /** @brief Returns the number of bytes read to stream copy the frames @param in to @param out (included), from the keyframe at or before
+     *  @param in to the next keyframe after @param out. Includes the packets of all the streams, -1 if the offsets are not known */
+    int64_t byteCount(int in, int out) const;
+
+private:
+    std::vector<int> m_keyframes;
+    /// Empty, or the byte offset of each keyframe
+    std::vector<int64_t> m_offsets;
+    int64_t m_fileSize{0};
+    int m_maxGop{0};
+};
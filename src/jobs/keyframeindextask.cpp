@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "keyframeindextask.h"
+#include "bin/projectclip.h"
+#include "bin/projectitemmodel.h"
+#include "core.h"
+#include "jobs/keyframeindex/keyframeindex.h"
+
+#include <KLocalizedString>
+#include <QFile>
+
+KeyframeIndexTask::KeyframeIndexTask(const ObjectId &owner, QObject *object)
+    : AbstractTask(owner, AbstractTask::KEYFRAMEINDEXJOB, object)
+{
+    m_description = i18n("Keyframe index");
+}
+
+void KeyframeIndexTask::start(const ObjectId &owner, QObject *object, bool force)
+{
+    if (pCore->taskManager.hasPendingJob(owner, AbstractTask::KEYFRAMEINDEXJOB)) {
+        return;
+    }
+    KeyframeIndexTask *task = new KeyframeIndexTask(owner, object);
+    task->m_isForce = force;
+    pCore->taskManager.startTask(owner.itemId, task);
+}
+
+void KeyframeIndexTask::run()
+{
+    AbstractTaskDone whenFinished(m_owner.itemId, this);
+    if (m_isCanceled || pCore->taskManager.isBlocked()) {
+        return;
+    }
+    QMutexLocker lock(&m_runMutex);
+    m_running = true;
+
+    const auto binClip = pCore->projectItemModel()->getClipByBinID(QString::number(m_owner.itemId));
+    if (binClip == nullptr) {
+        // Clip was deleted
+        return;
+    }
+    if (binClip->clipType() != ClipType::AV && binClip->clipType() != ClipType::Video) {
+        return;
+    }
+    // The index always describes the original file, proxy clips are encoded with short GOPs
+    const QString url = binClip->url();
+    const QString cachePath = binClip->getKeyframeIndexPath();
+    std::shared_ptr<KeyframeIndex> index;
+    if (!m_isForce && !cachePath.isEmpty() && QFile::exists(cachePath)) {
+        index = KeyframeIndex::load(cachePath);
+    }
+    if (!index && !m_isCanceled) {
+        auto progressCallback = [this](int progress) {
+            if (m_progress != progress) {
+                m_progress = progress;
+                QMetaObject::invokeMethod(m_object, "updateJobProgress");
+            }
+        };
+        index = KeyframeIndex::build(url, pCore->getCurrentFps(), progressCallback, m_isCanceled);
+        if (index && !cachePath.isEmpty()) {
+            index->save(cachePath);
+        }
+    }
+    if (m_isCanceled || !index) {
+        return;
+    }
+    binClip->setKeyframeIndex(index);
+    m_progress = 100;
+    QMetaObject::invokeMethod(m_object, "updateJobProgress");
+}
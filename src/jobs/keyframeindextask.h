@@ -0,0 +1,22 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include "abstracttask.h"
+
+/** @class KeyframeIndexTask
+    @brief Builds or loads from cache the keyframe index of a video clip, used to speed up scrubbing and thumbnail generation.
+ */
+class KeyframeIndexTask : public AbstractTask
+{
+public:
+    KeyframeIndexTask(const ObjectId &owner, QObject *object);
+    static void start(const ObjectId &owner, QObject *object, bool force = false);
+
+protected:
+    void run() override;
+};
@@ -0,0 +1,283 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "proxyscheduler.h"
+#include "abstracttask.h"
+#include "jobs/keyframeindex/keyframeindex.h"
+#include "kdenlive_debug.h"
+#include "kdenlivesettings.h"
+
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QThread>
+
+namespace {
+/** @brief The duration of a throughput measurement */
+constexpr qint64 measureWindow = 20000;
+/** @brief The throughput must change by this ratio to be considered different */
+constexpr double throughputTolerance = 0.05;
+/** @brief How long the first small file waits for others to join its batch */
+constexpr int batchCollectTime = 300;
+} // namespace
+
+ProxyScheduler::ProxyScheduler()
+    : m_maximum(maximumConcurrency())
+{
+    m_hardwareLimit = qBound(1, KdenliveSettings::proxythreads(), m_maximum);
+    m_limit = m_hardwareLimit;
+}
+
+int ProxyScheduler::maximumConcurrency()
+{
+    // Same bound as the proxythreads setting, one core is left for the UI and playback
+    return qMax(1, QThread::idealThreadCount() - 1);
+}
+
+bool ProxyScheduler::canStart(bool hardware) const
+{
+    return m_active < m_limit && (!hardware || m_hardwareActive < m_hardwareLimit);
+}
+
+void ProxyScheduler::start(bool hardware)
+{
+    m_active++;
+    if (hardware) {
+        m_hardwareActive++;
+    }
+    if (!m_window.isValid()) {
+        m_window.start();
+    }
+}
+
+bool ProxyScheduler::acquire(bool hardware, const QAtomicInt &isCanceled)
+{
+    QMutexLocker lock(&m_mutex);
+    while (!canStart(hardware)) {
+        m_windowSaturated = true;
+        if (isCanceled.loadRelaxed()) {
+            return false;
+        }
+        // Tasks are canceled from another thread without notifying us, check regularly
+        m_slotFreed.wait(&m_mutex, QDeadlineTimer(200));
+    }
+    start(hardware);
+    return true;
+}
+
+bool ProxyScheduler::tryAcquire(bool hardware)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!canStart(hardware)) {
+        m_windowSaturated = true;
+        return false;
+    }
+    start(hardware);
+    return true;
+}
+
+void ProxyScheduler::release(bool hardware)
+{
+    QMutexLocker lock(&m_mutex);
+    m_active = qMax(0, m_active - 1);
+    if (hardware) {
+        m_hardwareActive = qMax(0, m_hardwareActive - 1);
+    }
+    m_slotFreed.wakeAll();
+}
+
+void ProxyScheduler::addEncodedFrames(int frames)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_window.isValid()) {
+        return;
+    }
+    m_windowFrames += frames;
+    const qint64 elapsed = m_window.elapsed();
+    if (elapsed < measureWindow) {
+        return;
+    }
+    // The throughput only depends on the limit if there was more work than slots
+    if (m_windowSaturated && elapsed > 0) {
+        const int previous = m_limit;
+        adjustLimitLocked(1000. * m_windowFrames / elapsed);
+        if (m_limit != previous) {
+            qCDebug(KDENLIVE_LOG) << "Proxy encoding processes:" << previous << "->" << m_limit << "at" << 1000. * m_windowFrames / elapsed << "fps";
+        }
+    }
+    m_windowFrames = 0;
+    m_windowSaturated = false;
+    if (m_active > 0) {
+        m_window.restart();
+    } else {
+        m_window.invalidate();
+    }
+}
+
+int ProxyScheduler::limit() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_limit;
+}
+
+void ProxyScheduler::updateSettings()
+{
+    QMutexLocker lock(&m_mutex);
+    m_hardwareLimit = qBound(1, KdenliveSettings::proxythreads(), m_maximum);
+    m_slotFreed.wakeAll();
+}
+
+int ProxyScheduler::adjustLimit(double throughput)
+{
+    QMutexLocker lock(&m_mutex);
+    return adjustLimitLocked(throughput);
+}
+
+int ProxyScheduler::adjustLimitLocked(double throughput)
+{
+    if (m_throughputs.contains(m_limit)) {
+        // Smooth the measurements, the content of the files also changes the throughput
+        m_throughputs[m_limit] = (m_throughputs.value(m_limit) + throughput) / 2;
+    } else {
+        m_throughputs.insert(m_limit, throughput);
+    }
+    const double current = m_throughputs.value(m_limit);
+    const bool hasLower = m_throughputs.contains(m_limit - 1);
+    const bool hasUpper = m_throughputs.contains(m_limit + 1);
+    const double lower = m_throughputs.value(m_limit - 1);
+    const double upper = m_throughputs.value(m_limit + 1);
+    if (m_limit < m_maximum && !hasUpper && (!hasLower || current > lower * (1 + throughputTolerance))) {
+        // Adding a process helped so far, try one more
+        m_limit++;
+    } else if (hasUpper && upper > current * (1 + throughputTolerance)) {
+        m_limit++;
+    } else if (hasLower && lower * (1 + throughputTolerance) >= current) {
+        // Fewer processes are as fast, don't waste memory and CPU
+        m_limit--;
+    }
+    m_slotFreed.wakeAll();
+    return m_limit;
+}
+
+QVector<std::pair<int, int>> ProxyScheduler::splitSegments(int duration, const KeyframeIndex &index, int count)
+{
+    QVector<std::pair<int, int>> segments;
+    if (duration <= 0) {
+        return segments;
+    }
+    QVector<int> starts = {0};
+    for (int i = 1; i < count; ++i) {
+        const int frame = index.nearestKeyframe(int(qint64(duration) * i / count));
+        if (frame > starts.last() && frame < duration) {
+            starts << frame;
+        }
+    }
+    for (int i = 0; i < starts.count(); ++i) {
+        segments.append({starts.at(i), i + 1 < starts.count() ? starts.at(i + 1) - 1 : duration - 1});
+    }
+    return segments;
+}
+
+std::pair<double, double> ProxyScheduler::segmentTimes(const std::pair<int, int> &segment, double fps)
+{
+    const double start = segment.first > 0 ? (segment.first - 0.5) / fps : 0.;
+    return {start, (segment.second + 0.5) / fps};
+}
+
+bool ProxyScheduler::encodeBatched(const QStringList &input, const QStringList &output, int frames, const QAtomicInt &isCanceled)
+{
+    auto entry = std::make_shared<BatchEntry>();
+    entry->input = input;
+    entry->output = output;
+    entry->frames = frames;
+    QMutexLocker lock(&m_batchMutex);
+    if (m_collecting && int(m_batch.size()) < MaxBatchSize) {
+        // Another task is collecting small files, it will encode this one
+        m_batch.push_back(entry);
+        m_batchChanged.wakeAll();
+        while (!entry->done) {
+            m_batchChanged.wait(&m_batchMutex);
+        }
+        return entry->success;
+    }
+    m_collecting = true;
+    m_batch = {entry};
+    QDeadlineTimer deadline(batchCollectTime);
+    while (int(m_batch.size()) < MaxBatchSize && !deadline.hasExpired() && !isCanceled.loadRelaxed()) {
+        m_batchChanged.wait(&m_batchMutex, deadline);
+    }
+    std::vector<std::shared_ptr<BatchEntry>> batch;
+    std::swap(batch, m_batch);
+    m_collecting = false;
+    lock.unlock();
+
+    // A single file is encoded by its task, with progress reporting
+    const bool success = batch.size() > 1 && !isCanceled.loadRelaxed() && runBatch(batch, isCanceled);
+
+    lock.relock();
+    for (auto &e : batch) {
+        e->done = true;
+        e->success = success;
+    }
+    m_batchChanged.wakeAll();
+    return success;
+}
+
+bool ProxyScheduler::runBatch(const std::vector<std::shared_ptr<BatchEntry>> &batch, const QAtomicInt &isCanceled)
+{
+    if (!acquire(false, isCanceled)) {
+        return false;
+    }
+    QStringList parameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-v"), QStringLiteral("error")};
+    for (const auto &e : batch) {
+        parameters << e->input;
+    }
+    int frames = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        QStringList output = batch.at(i)->output;
+        // Each output reads its own input
+        for (int j = 0; j + 1 < output.count(); ++j) {
+            if (output.at(j) == QLatin1String("-map") && output.at(j + 1).section(QLatin1Char(':'), 0, 0) == QLatin1String("0")) {
+                output[j + 1].replace(0, 1, QString::number(i));
+            }
+        }
+        parameters << output;
+        frames += batch.at(i)->frames;
+    }
+    QProcess process;
+    process.start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
+    bool success = process.waitForStarted();
+    if (success) {
+        AbstractTask::setPreferredPriority(process.processId());
+        while (!process.waitForFinished(200)) {
+            if (isCanceled.loadRelaxed()) {
+                process.kill();
+                process.waitForFinished();
+                break;
+            }
+            if (process.state() == QProcess::NotRunning) {
+                break;
+            }
+        }
+        success = !isCanceled.loadRelaxed() && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+    }
+    release(false);
+    if (!success) {
+        qCDebug(KDENLIVE_LOG) << "Batched proxy encoding failed, encoding the files separately:" << process.readAllStandardError();
+    }
+    for (const auto &e : batch) {
+        const QString dest = e->output.last();
+        if (!success || QFileInfo(dest).size() == 0) {
+            QFile::remove(dest);
+            success = false;
+        }
+    }
+    if (success) {
+        addEncodedFrames(frames);
+    }
+    return success;
+}
@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class KeyframeIndex;
+
+/** @class ProxyScheduler
+    @brief Shares the external encoding processes (FFmpeg / melt) between the proxy, transcode and stabilization tasks.
+    Each process needs a slot. The number of slots starts at the proxythreads setting and is then adapted to the measured
+    throughput: more processes are allowed as long as they increase the number of encoded frames per second. Hardware
+    encoders stay limited to the proxythreads setting since GPUs only accept a few concurrent sessions.
+    Long sources are encoded as several keyframe aligned segments that use the free slots, small files are grouped in a
+    single FFmpeg process to avoid the startup cost of a process per file.
+ */
+class ProxyScheduler
+{
+public:
+    /** @brief Files shorter than this (in seconds) are encoded in batches */
+    static constexpr double SmallFileDuration = 10.;
+    /** @brief The minimum duration (in seconds) of a segment when a long source is split */
+    static constexpr double MinSegmentDuration = 60.;
+    static constexpr int MaxBatchSize = 8;
+
+    ProxyScheduler();
+    /** @brief The maximum number of concurrent processes, whatever the measured throughput */
+    static int maximumConcurrency();
+    /** @brief Wait for a free slot, returns false if @param isCanceled was set while waiting */
+    bool acquire(bool hardware, const QAtomicInt &isCanceled);
+    /** @brief Get a slot if one is free without waiting, used to encode the segments of a file in parallel */
+    bool tryAcquire(bool hardware);
+    void release(bool hardware);
+    /** @brief Report the frames encoded by a finished process, used to measure the throughput */
+    void addEncodedFrames(int frames);
+    /** @brief The current number of slots */
+    int limit() const;
+    /** @brief Read the proxythreads setting again */
+    void updateSettings();
+    /** @brief Adapt the number of slots to the @param throughput (frames per second) measured with the current limit.
+     *  @returns the new limit */
+    int adjustLimit(double throughput);
+
+    /** @brief Split a source of @param duration frames in at most @param count segments starting on a keyframe.
+     *  @returns the first and last frame of each segment */
+    static QVector<std::pair<int, int>> splitSegments(int duration, const KeyframeIndex &index, int count);
+    /** @brief Returns the start and end time, in seconds, of a @param segment returned by splitSegments.
+     *  The segments are in project frames, which differ from the frames of the source when its frame rate is not the project's, so the encoded parts
+     *  are bounded by time. The bounds are half a project frame before the first frame and after the last one, so consecutive segments are contiguous */
+    static std::pair<double, double> segmentTimes(const std::pair<int, int> &segment, double fps);
+
+    /** @brief Encode a small file in the same FFmpeg process as the other small files started meanwhile.
+     *  @param input the parameters of the input, ending with "-i source"
+     *  @param output the parameters of the output, ending with the destination. The first input is mapped with "-map 0"
+     *  @param frames the duration of the file, used to measure the throughput
+     *  @returns true if the file was encoded, false if it must be encoded separately (no other small file, or the batch failed) */
+    bool encodeBatched(const QStringList &input, const QStringList &output, int frames, const QAtomicInt &isCanceled);
+
+private:
+    struct BatchEntry
+    {
+        QStringList input;
+        QStringList output;
+        int frames{0};
+        bool done{false};
+        bool success{false};
+    };
+    mutable QMutex m_mutex;
+    QWaitCondition m_slotFreed;
+    int m_limit;
+    int m_maximum;
+    int m_hardwareLimit;
+    int m_active{0};
+    int m_hardwareActive{0};
+    /** @brief The throughput measured for each limit */
+    QMap<int, double> m_throughputs;
+    QElapsedTimer m_window;
+    qint64 m_windowFrames{0};
+    /** @brief True if a process had to wait for a slot during the current window */
+    bool m_windowSaturated{false};
+
+    QMutex m_batchMutex;
+    QWaitCondition m_batchChanged;
+    bool m_collecting{false};
+    std::vector<std::shared_ptr<BatchEntry>> m_batch;
+
+    bool canStart(bool hardware) const;
+    void start(bool hardware);
+    int adjustLimitLocked(double throughput);
+    bool runBatch(const std::vector<std::shared_ptr<BatchEntry>> &batch, const QAtomicInt &isCanceled);
+};
@@ -10,17 +10,56 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "doc/kdenlivedoc.h"
+#include "jobs/keyframeindex/keyframeindex.h"
 #include "kdenlive_debug.h"
 #include "kdenlivesettings.h"
 #include "macros.hpp"
+#include "proxyscheduler.h"
 
+#include <QDir>
 #include <QImageReader>
 #include <QProcess>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QThread>
 
 #include <KLocalizedString>
 
+namespace {
+/** @brief Returns true if the FFmpeg @param parameters encode on the GPU */
+bool isHardwareEncoder(const QStringList &parameters)
+{
+    for (const QString &p : parameters) {
+        if (p.contains(QLatin1String("_nvenc")) || p.contains(QLatin1String("_vaapi")) || p.contains(QLatin1String("_qsv")) ||
+            p.contains(QLatin1String("_videotoolbox")) || p.contains(QLatin1String("_amf"))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Run an FFmpeg process until it finishes or the task is canceled */
+bool runProcess(QProcess &process, const QStringList &parameters, const QAtomicInt &isCanceled)
+{
+    process.start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
+    if (!process.waitForStarted()) {
+        return false;
+    }
+    AbstractTask::setPreferredPriority(process.processId());
+    while (!process.waitForFinished(200)) {
+        if (isCanceled.loadRelaxed()) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+        if (process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+} // namespace
+
 ProxyTask::ProxyTask(const ObjectId &owner, QObject *object)
     : AbstractTask(owner, AbstractTask::PROXYJOB, object)
     , m_jobDuration(0)
@@ -187,15 +226,22 @@ void ProxyTask::run()
         // Ask for progress reporting
         mltParameters << QStringLiteral("progress=1");
 
-        m_jobProcess.reset(new QProcess);
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        qDebug() << " :: STARTING PLAYLIST PROXY: " << mltParameters;
-        QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
-        m_jobProcess->start(KdenliveSettings::meltpath(), mltParameters);
-        AbstractTask::setPreferredPriority(m_jobProcess->processId());
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        ProxyScheduler &scheduler = pCore->taskManager.proxyScheduler;
+        if (scheduler.acquire(false, m_isCanceled)) {
+            m_jobProcess.reset(new QProcess);
+            // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
+            qDebug() << " :: STARTING PLAYLIST PROXY: " << mltParameters;
+            QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+            QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
+            m_jobProcess->start(KdenliveSettings::meltpath(), mltParameters);
+            AbstractTask::setPreferredPriority(m_jobProcess->processId());
+            m_jobProcess->waitForFinished(-1);
+            result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+            scheduler.release(false);
+            if (result) {
+                scheduler.addEncodedFrames(int(binClip->frameDuration()));
+            }
+        }
         delete playlist;
     } else if (type == ClipType::Image) {
         m_isFfmpegJob = false;
@@ -241,10 +287,12 @@ void ProxyTask::run()
             return;
         }
         // Only output error data, make sure we don't block when proxy file already exists
-        QStringList parameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-stats"), QStringLiteral("-v"),
-                                  QStringLiteral("error")};
+        const QStringList globalParameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-stats"), QStringLiteral("-v"),
+                                              QStringLiteral("error")};
+        QStringList parameters = globalParameters;
         m_jobDuration = int(binClip->duration().seconds());
-        if (binClip->hasProducerProperty(QStringLiteral("kdenlive:camcorderproxy"))) {
+        const bool camcorderProxy = binClip->hasProducerProperty(QStringLiteral("kdenlive:camcorderproxy"));
+        if (camcorderProxy) {
             // ffmpeg -an -i proxy.mp4 -vn -i original.MXF -map 0:v -map 1:a -c:v copy out.MP4
             // Create a new proxy file with video from camcorder proxy and audio from source clip
             const QString proxyPath = binClip->getProducerProperty(QStringLiteral("kdenlive:camcorderproxy"));
@@ -375,14 +423,57 @@ void ProxyTask::run()
             parameters << dest;
             qDebug() << "/// FULL PROXY PARAMS:\n" << parameters << "\n------";
         }
-        m_jobProcess.reset(new QProcess);
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
-        QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
-        AbstractTask::setPreferredPriority(m_jobProcess->processId());
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit && m_jobProcess->exitCode() == 0;
+        ProxyScheduler &scheduler = pCore->taskManager.proxyScheduler;
+        const bool hardware = isHardwareEncoder(parameters);
+        const int frames = int(binClip->frameDuration());
+        bool done = false;
+        // The input parameters end with the source, the output parameters with the destination
+        int sourceIndex = -1;
+        for (int i = globalParameters.count(); i + 1 < parameters.count(); ++i) {
+            if (parameters.at(i) == QLatin1String("-i") && parameters.at(i + 1) == source) {
+                sourceIndex = i + 1;
+                break;
+            }
+        }
+        if (!camcorderProxy && sourceIndex > 0) {
+            const QStringList input = parameters.mid(globalParameters.count(), sourceIndex - globalParameters.count() + 1);
+            const QStringList output = parameters.mid(sourceIndex + 1);
+            const double seconds = binClip->duration().seconds();
+            if (!hardware && seconds < ProxyScheduler::SmallFileDuration) {
+                // Small files are encoded together, starting FFmpeg would take longer than the encoding
+                done = result = scheduler.encodeBatched(input, output, frames, m_isCanceled);
+            } else if (seconds >= 2 * ProxyScheduler::MinSegmentDuration && (type == ClipType::AV || type == ClipType::Video)) {
+                std::shared_ptr<const KeyframeIndex> index = binClip->keyframeIndex();
+                if (!index) {
+                    const QString indexPath = binClip->getKeyframeIndexPath();
+                    if (!indexPath.isEmpty()) {
+                        index = KeyframeIndex::load(indexPath);
+                    }
+                }
+                if (index && !index->isEmpty()) {
+                    const int count = qMin(ProxyScheduler::maximumConcurrency(), int(seconds / ProxyScheduler::MinSegmentDuration));
+                    const QVector<std::pair<int, int>> segments = ProxyScheduler::splitSegments(frames, *index, count);
+                    if (segments.count() > 1) {
+                        // Fall back to a single process if the segments could not be encoded
+                        done = result = encodeSegments(input, output, segments, type == ClipType::AV, hardware);
+                    }
+                }
+            }
+        }
+        if (!done && !m_isCanceled && scheduler.acquire(hardware, m_isCanceled)) {
+            m_jobProcess.reset(new QProcess);
+            // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
+            QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &ProxyTask::processLogInfo);
+            QObject::connect(this, &ProxyTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+            m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
+            AbstractTask::setPreferredPriority(m_jobProcess->processId());
+            m_jobProcess->waitForFinished(-1);
+            result = m_jobProcess->exitStatus() == QProcess::NormalExit && m_jobProcess->exitCode() == 0;
+            scheduler.release(hardware);
+            if (result) {
+                scheduler.addEncodedFrames(frames);
+            }
+        }
     }
     // remove temporary playlist if it exists
     m_progress = 100;
@@ -462,3 +553,145 @@ void ProxyTask::processLogInfo()
         }
     }
 }
+
+bool ProxyTask::encodeSegments(const QStringList &input, const QStringList &output, const QVector<std::pair<int, int>> &segments, bool withAudio,
+                               bool hardware)
+{
+    ProxyScheduler &scheduler = pCore->taskManager.proxyScheduler;
+    const QString dest = output.last();
+    const QFileInfo destInfo(dest);
+    QTemporaryDir folder(destInfo.absoluteDir().absoluteFilePath(destInfo.completeBaseName() + QStringLiteral("-XXXXXX")));
+    if (!folder.isValid()) {
+        return false;
+    }
+    const double fps = pCore->getCurrentFps();
+    const QStringList globalParameters = {QStringLiteral("-hide_banner"), QStringLiteral("-y"), QStringLiteral("-v"), QStringLiteral("error")};
+    const QString source = input.last();
+    const QStringList inputOptions = input.mid(0, input.count() - 2);
+    const QStringList outputOptions = output.mid(0, output.count() - 1);
+    struct Part
+    {
+        QStringList parameters;
+        QString path;
+        int frames;
+    };
+    QVector<Part> parts;
+    int totalFrames = 0;
+    for (int i = 0; i < segments.count(); ++i) {
+        const std::pair<int, int> &segment = segments.at(i);
+        const int frames = segment.second - segment.first + 1;
+        // The segments are in project frames, bound them by time since the source frame rate may be different
+        const std::pair<double, double> times = ProxyScheduler::segmentTimes(segment, fps);
+        Part part;
+        part.path = folder.filePath(QStringLiteral("%1.%2").arg(i, 3, 10, QLatin1Char('0')).arg(destInfo.suffix()));
+        part.frames = frames;
+        part.parameters = globalParameters;
+        part.parameters << inputOptions;
+        if (segment.first > 0) {
+            // The accurate seek starts on the first source frame of the segment
+            part.parameters << QStringLiteral("-ss") << QString::number(times.first, 'f', 6);
+        }
+        part.parameters << QStringLiteral("-i") << source << outputOptions << QStringLiteral("-an");
+        if (i + 1 < segments.count()) {
+            // The last segment goes to the end of the source
+            part.parameters << QStringLiteral("-t") << QString::number(times.second - times.first, 'f', 6);
+        }
+        part.parameters << part.path;
+        parts << part;
+        totalFrames += frames;
+    }
+    const QString audioPath = folder.filePath(QStringLiteral("audio.%1").arg(destInfo.suffix()));
+    if (withAudio) {
+        // The audio is encoded in one piece to avoid gaps between the segments
+        Part part;
+        part.path = audioPath;
+        part.frames = 0;
+        part.parameters = globalParameters;
+        part.parameters << input << QStringLiteral("-vn") << outputOptions << audioPath;
+        parts << part;
+    }
+
+    struct Running
+    {
+        std::unique_ptr<QProcess> process;
+        int part;
+    };
+    std::vector<Running> running;
+    int next = 0;
+    int encodedFrames = 0;
+    bool success = true;
+    while (success && (next < parts.count() || !running.empty())) {
+        // Start a part on each free slot, only the first part waits for one
+        while (next < parts.count()) {
+            if (!(running.empty() ? scheduler.acquire(hardware, m_isCanceled) : scheduler.tryAcquire(hardware))) {
+                break;
+            }
+            std::unique_ptr<QProcess> process(new QProcess);
+            process->start(KdenliveSettings::ffmpegpath(), parts.at(next).parameters, QIODevice::ReadOnly);
+            if (!process->waitForStarted()) {
+                scheduler.release(hardware);
+                success = false;
+                break;
+            }
+            AbstractTask::setPreferredPriority(process->processId());
+            running.push_back({std::move(process), next});
+            next++;
+        }
+        if (m_isCanceled || running.empty()) {
+            success = false;
+            break;
+        }
+        for (auto it = running.begin(); it != running.end();) {
+            if (!it->process->waitForFinished(50) && it->process->state() != QProcess::NotRunning) {
+                ++it;
+                continue;
+            }
+            scheduler.release(hardware);
+            const Part &part = parts.at(it->part);
+            if (it->process->exitStatus() != QProcess::NormalExit || it->process->exitCode() != 0 || QFileInfo(part.path).size() == 0) {
+                m_logDetails.append(QString::fromUtf8(it->process->readAllStandardError()));
+                success = false;
+            } else if (part.frames > 0) {
+                scheduler.addEncodedFrames(part.frames);
+                encodedFrames += part.frames;
+                m_progress = 100 * encodedFrames / qMax(1, totalFrames);
+                QMetaObject::invokeMethod(m_object, "updateJobProgress");
+            }
+            it = running.erase(it);
+        }
+    }
+    for (Running &r : running) {
+        r.process->kill();
+        r.process->waitForFinished();
+        scheduler.release(hardware);
+    }
+    if (!success || m_isCanceled) {
+        return false;
+    }
+
+    // Join the segments without encoding them again
+    QFile list(folder.filePath(QStringLiteral("segments.txt")));
+    if (!list.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    for (int i = 0; i < segments.count(); ++i) {
+        QString path = parts.at(i).path;
+        path.replace(QLatin1Char('\''), QLatin1String("'\\''"));
+        list.write(QStringLiteral("file '%1'\n").arg(path).toUtf8());
+    }
+    list.close();
+    QStringList parameters = globalParameters;
+    parameters << QStringLiteral("-f") << QStringLiteral("concat") << QStringLiteral("-safe") << QStringLiteral("0") << QStringLiteral("-i") << list.fileName();
+    if (withAudio) {
+        parameters << QStringLiteral("-i") << audioPath << QStringLiteral("-map") << QStringLiteral("0:v") << QStringLiteral("-map") << QStringLiteral("1:a?");
+    } else {
+        parameters << QStringLiteral("-map") << QStringLiteral("0");
+    }
+    parameters << QStringLiteral("-c") << QStringLiteral("copy") << dest;
+    QProcess process;
+    if (!runProcess(process, parameters, m_isCanceled)) {
+        m_logDetails.append(QString::fromUtf8(process.readAllStandardError()));
+        return false;
+    }
+    return true;
+}
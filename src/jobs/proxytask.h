@@ -8,6 +8,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 
+#include <QVector>
+#include <utility>
+
 class QProcess;
 
 class ProxyTask : public AbstractTask
@@ -23,6 +26,10 @@ private Q_SLOTS:
     void processLogInfo();
 
 private:
+    /** @brief Encode the @param segments of the source in parallel and join them in the destination.
+     *  @param input the FFmpeg input parameters, ending with the source
+     *  @param output the FFmpeg output parameters, ending with the destination */
+    bool encodeSegments(const QStringList &input, const QStringList &output, const QVector<std::pair<int, int>> &segments, bool withAudio, bool hardware);
     int m_jobDuration{0};
     bool m_isFfmpegJob;
     std::unique_ptr<QProcess> m_jobProcess;
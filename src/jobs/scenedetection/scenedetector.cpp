@@ -0,0 +1,326 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "scenedetector.h"
+#include "scenescores.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SCENEDETECTOR_SSE2
+#endif
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+}
+
+// Width of the downscaled frames used for comparison
+static const int scanWidth = 256;
+// Don't split the scan in segments shorter than this duration, in seconds
+static const int minSegmentDuration = 30;
+// Decoding starts this duration (in seconds) before a segment, so that its first frame can be compared
+static const double segmentPreroll = 1.;
+
+uint64_t planeSad(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height)
+{
+    uint64_t sad = 0;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *lineA = a + y * strideA;
+        const uint8_t *lineB = b + y * strideB;
+        int x = 0;
+#ifdef SCENEDETECTOR_SSE2
+        __m128i acc = _mm_setzero_si128();
+        for (; x + 16 <= width; x += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lineA + x));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lineB + x));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(va, vb));
+        }
+        alignas(16) uint64_t sums[2];
+        _mm_store_si128(reinterpret_cast<__m128i *>(sums), acc);
+        sad += sums[0] + sums[1];
+#endif
+        for (; x < width; ++x) {
+            sad += uint64_t(std::abs(int(lineA[x]) - int(lineB[x])));
+        }
+    }
+    return sad;
+}
+
+double sceneScore(uint64_t sad, int pixels, double &previousMafd)
+{
+    if (pixels <= 0) {
+        return 0.;
+    }
+    const double mafd = double(sad) / pixels;
+    const double diff = std::fabs(mafd - previousMafd);
+    previousMafd = mafd;
+    return std::clamp(std::min(mafd, diff) / 100., 0., 1.);
+}
+
+namespace {
+struct ScanRange
+{
+    // Range of the scan, in stream time base
+    int64_t start;
+    int64_t end;
+    bool last;
+};
+
+struct ScanResult
+{
+    bool ok{false};
+    SceneScores scores;
+};
+
+struct ScanContext
+{
+    QString uri;
+    int streamIdx;
+    int decoderThreads;
+    int64_t startTime;
+    int64_t duration;
+    const std::function<void(int progress)> *progressCallback;
+    const QAtomicInt *isCanceled;
+    std::atomic<int64_t> scanned{0};
+    std::atomic<int> progress{0};
+};
+
+ScanResult scanRange(ScanContext &context, const ScanRange &range)
+{
+    ScanResult result;
+    AVFormatContext *fmt_ctx = nullptr;
+    AVCodecContext *codec_ctx = nullptr;
+    SwsContext *sws_ctx = nullptr;
+    AVPacket *packet = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    const AVStream *stream = nullptr;
+    const AVCodec *codec = nullptr;
+    int ret = 0;
+    int scanHeight = 0;
+    int scanStride = 0;
+    bool hasReference = false;
+    bool done = false;
+    bool failed = false;
+    double previousMafd = 0.;
+    int64_t lastPts = range.start;
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> reference;
+
+    // Score a decoded frame, returns false once the frame is past the end of the range
+    auto processFrame = [&]() {
+        int64_t pts = frame->best_effort_timestamp;
+        if (pts == AV_NOPTS_VALUE) {
+            pts = lastPts;
+        }
+        if (!range.last && pts >= range.end) {
+            return false;
+        }
+        if (!sws_ctx || scanHeight == 0) {
+            scanHeight = std::max(2, int(std::lround(double(scanWidth) * frame->height / std::max(1, frame->width))) & ~1);
+            scanStride = (scanWidth + 15) & ~15;
+            current.assign(size_t(scanStride) * scanHeight, 0);
+            reference.assign(size_t(scanStride) * scanHeight, 0);
+        }
+        sws_ctx = sws_getCachedContext(sws_ctx, frame->width, frame->height, AVPixelFormat(frame->format), scanWidth, scanHeight, AV_PIX_FMT_GRAY8,
+                                       SWS_AREA, nullptr, nullptr, nullptr);
+        if (!sws_ctx) {
+            failed = true;
+            return false;
+        }
+        uint8_t *dst[4] = {current.data(), nullptr, nullptr, nullptr};
+        int dstStride[4] = {scanStride, 0, 0, 0};
+        sws_scale(sws_ctx, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+        if (hasReference) {
+            const uint64_t sad = planeSad(current.data(), scanStride, reference.data(), scanStride, scanWidth, scanHeight);
+            const double score = sceneScore(sad, scanWidth * scanHeight, previousMafd);
+            if (pts >= range.start) {
+                result.scores.append((pts - context.startTime) * av_q2d(stream->time_base), score);
+            }
+        }
+        std::swap(current, reference);
+        hasReference = true;
+        const int64_t delta = std::min(pts, range.end) - std::max(lastPts, range.start);
+        if (delta > 0) {
+            const int64_t scanned = context.scanned.fetch_add(delta) + delta;
+            const int progress = context.duration > 0 ? int(std::clamp<int64_t>(100 * scanned / context.duration, 0, 99)) : 0;
+            int previous = context.progress.load();
+            while (progress > previous) {
+                if (context.progress.compare_exchange_weak(previous, progress)) {
+                    (*context.progressCallback)(progress);
+                    break;
+                }
+            }
+        }
+        lastPts = std::max(lastPts, pts);
+        return true;
+    };
+
+    ret = avformat_open_input(&fmt_ctx, context.uri.toLocal8Bit().data(), nullptr, nullptr);
+    if (ret < 0) {
+        goto cleanup;
+    }
+    ret = avformat_find_stream_info(fmt_ctx, nullptr);
+    if (ret < 0 || context.streamIdx >= int(fmt_ctx->nb_streams)) {
+        goto cleanup;
+    }
+    stream = fmt_ctx->streams[context.streamIdx];
+    codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) {
+        goto cleanup;
+    }
+    codec_ctx = avcodec_alloc_context3(codec);
+    if (!codec_ctx || avcodec_parameters_to_context(codec_ctx, stream->codecpar) < 0) {
+        goto cleanup;
+    }
+    codec_ctx->thread_count = context.decoderThreads;
+    // Frames are downscaled, skip the costly deblocking
+    codec_ctx->skip_loop_filter = AVDISCARD_ALL;
+    if (avcodec_open2(codec_ctx, codec, nullptr) < 0) {
+        goto cleanup;
+    }
+    // Only decode the stream we analyse
+    for (unsigned i = 0; i < fmt_ctx->nb_streams; ++i) {
+        fmt_ctx->streams[i]->discard = int(i) == context.streamIdx ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+    }
+    if (range.start > context.startTime) {
+        const int64_t preroll = int64_t(segmentPreroll / av_q2d(stream->time_base));
+        ret = av_seek_frame(fmt_ctx, context.streamIdx, std::max(context.startTime, range.start - preroll), AVSEEK_FLAG_BACKWARD);
+        if (ret < 0) {
+            qWarning() << "Cannot seek in" << context.uri << "for scene detection";
+            goto cleanup;
+        }
+    }
+
+    while (!done && av_read_frame(fmt_ctx, packet) >= 0) {
+        if (*context.isCanceled) {
+            av_packet_unref(packet);
+            goto cleanup;
+        }
+        if (packet->stream_index != context.streamIdx) {
+            av_packet_unref(packet);
+            continue;
+        }
+        ret = avcodec_send_packet(codec_ctx, packet);
+        av_packet_unref(packet);
+        if (ret < 0 && ret != AVERROR_INVALIDDATA) {
+            goto cleanup;
+        }
+        while (!done && avcodec_receive_frame(codec_ctx, frame) >= 0) {
+            done = !processFrame();
+            av_frame_unref(frame);
+        }
+    }
+    if (!done) {
+        // Drain the decoder
+        avcodec_send_packet(codec_ctx, nullptr);
+        while (!done && avcodec_receive_frame(codec_ctx, frame) >= 0) {
+            done = !processFrame();
+            av_frame_unref(frame);
+        }
+    }
+    result.ok = !failed;
+
+cleanup:
+    sws_freeContext(sws_ctx);
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&codec_ctx);
+    avformat_close_input(&fmt_ctx);
+    return result;
+}
+} // namespace
+
+bool sceneScoresLibav(const QString &uri, int segments, const std::function<void(int progress)> &progressCallback, const QAtomicInt &isCanceled,
+                      SceneScores &scores)
+{
+    qDebug() << "Detecting scenes of" << uri << "using libav";
+    QElapsedTimer timer;
+    timer.start();
+
+    ScanContext context;
+    context.uri = uri;
+    context.progressCallback = &progressCallback;
+    context.isCanceled = &isCanceled;
+
+    // Probe the file to find the video stream and its duration
+    AVFormatContext *fmt_ctx = nullptr;
+    if (avformat_open_input(&fmt_ctx, uri.toLocal8Bit().data(), nullptr, nullptr) < 0) {
+        qWarning() << "Could not open input file" << uri;
+        return false;
+    }
+    if (avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
+        avformat_close_input(&fmt_ctx);
+        return false;
+    }
+    context.streamIdx = av_find_best_stream(fmt_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (context.streamIdx < 0) {
+        qWarning() << "No video stream found in" << uri;
+        avformat_close_input(&fmt_ctx);
+        return false;
+    }
+    const AVStream *stream = fmt_ctx->streams[context.streamIdx];
+    const double timeBase = av_q2d(stream->time_base);
+    context.startTime = stream->start_time == AV_NOPTS_VALUE ? 0 : stream->start_time;
+    context.duration = stream->duration;
+    if (context.duration <= 0 && fmt_ctx->duration > 0) {
+        context.duration = av_rescale_q(fmt_ctx->duration, AV_TIME_BASE_Q, stream->time_base);
+    }
+    const bool seekable = fmt_ctx->pb && (fmt_ctx->pb->seekable & AVIO_SEEKABLE_NORMAL);
+    avformat_close_input(&fmt_ctx);
+
+    // Split long files in ranges scanned in parallel
+    int count = 1;
+    if (seekable && context.duration > 0) {
+        count = std::clamp(int(context.duration * timeBase / minSegmentDuration), 1, std::max(1, segments));
+    }
+    context.decoderThreads = std::max(1, QThread::idealThreadCount() / count);
+    std::vector<ScanRange> ranges;
+    for (int i = 0; i < count; ++i) {
+        const int64_t start = context.startTime + context.duration * i / count;
+        const int64_t end = context.startTime + context.duration * (i + 1) / count;
+        ranges.push_back({start, end, i == count - 1});
+    }
+    const QList<ScanResult> scanned =
+        QtConcurrent::blockingMapped<QList<ScanResult>>(ranges, [&context](const ScanRange &range) { return scanRange(context, range); });
+    if (isCanceled) {
+        return false;
+    }
+    // Stitch the results, each range only reports the frames starting inside it
+    scores = SceneScores();
+    for (const ScanResult &result : scanned) {
+        if (!result.ok) {
+            qWarning() << "Scene detection failed for" << uri;
+            scores = SceneScores();
+            return false;
+        }
+        scores.append(result.scores);
+    }
+    progressCallback(100);
+    qDebug() << "Scene detection took" << timer.elapsed() / 1000.0 << "s using" << count << "segments for" << scores.count() << "frames";
+    return true;
+}
+
+bool detectScenesLibav(const QString &uri, double threshold, int segments, const std::function<void(int progress)> &progressCallback,
+                       const QAtomicInt &isCanceled, QList<double> &results)
+{
+    SceneScores scores;
+    results.clear();
+    if (!sceneScoresLibav(uri, segments, progressCallback, isCanceled, scores)) {
+        return false;
+    }
+    results = scores.scenes(threshold);
+    return true;
+}
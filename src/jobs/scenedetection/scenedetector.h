@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+#include <QAtomicInt>
+#include <QList>
+#include <QString>
+#include <cstdint>
+#include <functional>
+
+class SceneScores;
+
+/** @brief Computes the sum of absolute differences between two 8 bit planes.
+ *
+ * @param a first plane
+ * @param strideA number of bytes between two lines of the first plane
+ * @param b second plane
+ * @param strideB number of bytes between two lines of the second plane
+ * @param width number of pixels per line
+ * @param height number of lines
+ * @return the sum of absolute differences of all pixels
+ */
+uint64_t planeSad(const uint8_t *a, int strideA, const uint8_t *b, int strideB, int width, int height);
+
+/** @brief Computes the scene change score of a frame with the formula of FFmpeg's select filter (MAFD).
+ * This is an approximation of FFmpeg's score: it is computed on the downscaled luma plane instead of the full frame, so the
+ * values are close but not identical and thresholds keep roughly the same meaning.
+ *
+ * @param sad sum of absolute differences between the frame and the previous one
+ * @param pixels number of compared pixels
+ * @param previousMafd mean absolute frame difference of the previous frame, updated for the next call
+ * @return the score, between 0 (identical frames) and 1
+ */
+double sceneScore(uint64_t sad, int pixels, double &previousMafd);
+
+/** @brief Computes the scene change score of every frame of a media file using libav directly.
+ *
+ * Frames are decoded and downscaled to grayscale, then compared with the previous one. Long files are split
+ * in @param segments time ranges that are scanned in parallel.
+ *
+ * @param uri the media file to process
+ * @param segments maximum number of ranges scanned in parallel
+ * @param progressCallback process callback function, called from the scanning threads
+ * @param isCanceled task cancelled semaphor, 0 = not cancelled, 1 = cancelled
+ * @param scores the score of each frame, the times are relative to the start of the video stream
+ * @return false if the file could not be processed
+ */
+bool sceneScoresLibav(const QString &uri, int segments, const std::function<void(int progress)> &progressCallback, const QAtomicInt &isCanceled,
+                      SceneScores &scores);
+
+/** @brief Detects the scene changes of a media file using libav directly, see sceneScoresLibav().
+ *
+ * @param uri the media file to process
+ * @param threshold minimum score of a scene change, between 0 and 1
+ * @param segments maximum number of ranges scanned in parallel
+ * @param progressCallback process callback function, called from the scanning threads
+ * @param isCanceled task cancelled semaphor, 0 = not cancelled, 1 = cancelled
+ * @param results the timestamps of the scene changes, in seconds from the start of the video stream
+ * @return false if the file could not be processed
+ */
+bool detectScenesLibav(const QString &uri, double threshold, int segments, const std::function<void(int progress)> &progressCallback,
+                       const QAtomicInt &isCanceled, QList<double> &results);
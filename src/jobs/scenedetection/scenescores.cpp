@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "scenescores.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <algorithm>
+#include <cmath>
+
+// Version of the cache file format
+static const qint32 scoresVersion = 1;
+// Scores are stored as integers, 1 being the maximum score
+static const double scoreScale = 65535.;
+
+void SceneScores::append(double seconds, double score)
+{
+    m_times << qint32(std::lround(seconds * 1000.));
+    m_scores << quint16(std::lround(std::clamp(score, 0., 1.) * scoreScale));
+}
+
+void SceneScores::append(const SceneScores &other)
+{
+    m_times << other.m_times;
+    m_scores << other.m_scores;
+}
+
+QList<double> SceneScores::scenes(double threshold) const
+{
+    QList<double> result;
+    for (int i = 0; i < m_scores.count(); ++i) {
+        if (m_scores.at(i) / scoreScale > threshold) {
+            result << m_times.at(i) / 1000.;
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+bool SceneScores::isEmpty() const
+{
+    return m_scores.isEmpty();
+}
+
+int SceneScores::count() const
+{
+    return int(m_scores.count());
+}
+
+std::shared_ptr<SceneScores> SceneScores::load(const QString &cachePath)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    QDataStream in(&file);
+    qint32 version = 0;
+    in >> version;
+    if (version != scoresVersion) {
+        return nullptr;
+    }
+    auto scores = std::make_shared<SceneScores>();
+    in >> scores->m_times >> scores->m_scores;
+    if (in.status() != QDataStream::Ok || scores->m_times.isEmpty() || scores->m_times.count() != scores->m_scores.count()) {
+        return nullptr;
+    }
+    return scores;
+}
+
+bool SceneScores::save(const QString &cachePath) const
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Cannot write scene scores to" << cachePath;
+        return false;
+    }
+    QDataStream out(&file);
+    out << scoresVersion;
+    out << m_times << m_scores;
+    return out.status() == QDataStream::Ok;
+}
@@ -0,0 +1,39 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+/** @class SceneScores
+    @brief The scene change score of each frame of a clip's video stream.
+    Decoding the media is the expensive part of scene detection, so the scores of a scan are cached next to the audio thumbnails.
+    Detecting the scenes with another threshold, or cutting subclips, then only needs the scores.
+    Times are stored in milliseconds from the start of the video stream and scores with 16 bits, 6 bytes per frame.
+ */
+class SceneScores
+{
+public:
+    /** @brief Add the score of the frame at @param seconds, frames must be added in presentation order */
+    void append(double seconds, double score);
+    /** @brief Add the scores of @param other, its frames must follow the ones already added */
+    void append(const SceneScores &other);
+    /** @brief Returns the times (in seconds) of the frames having a score above @param threshold */
+    QList<double> scenes(double threshold) const;
+    bool isEmpty() const;
+    int count() const;
+
+    /** @brief Load the scores previously saved with save(), returns nullptr if the file is missing or invalid */
+    static std::shared_ptr<SceneScores> load(const QString &cachePath);
+    bool save(const QString &cachePath) const;
+
+private:
+    QVector<qint32> m_times;
+    QVector<quint16> m_scores;
+};
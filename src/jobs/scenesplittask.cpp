@@ -5,6 +5,8 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 
 #include "scenesplittask.h"
+#include "jobs/scenedetection/scenedetector.h"
+#include "jobs/scenedetection/scenescores.h"
 #include "bin/bin.h"
 #include "bin/clipcreator.hpp"
 #include "bin/model/markerlistmodel.hpp"
@@ -119,48 +121,78 @@ void SceneSplitTask::run()
         qDebug() << "=== ABORT 1";
         return;
     }
-    if (KdenliveSettings::ffmpegpath().isEmpty()) {
-        // FFmpeg not detected, cannot process the Job
-        QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
-                                  Q_ARG(QString, i18n("FFmpeg not found, please set path in Kdenlive's settings Environment.")),
-                                  Q_ARG(int, int(KMessageWidget::Warning)));
-        qDebug() << "=== ABORT 2";
-        return;
-    }
     m_jobDuration = int(binClip->duration().seconds());
     int producerDuration = binClip->frameDuration();
-    // QStringList parameters =
-    // {QStringLiteral("-loglevel"),QStringLiteral("info"),QStringLiteral("-i"),source,QStringLiteral("-filter:v"),QStringLiteral("scdet"),QStringLiteral("-f"),QStringLiteral("null"),QStringLiteral("-")};
-    QStringList parameters = {QStringLiteral("-y"),
-                              QStringLiteral("-loglevel"),
-                              QStringLiteral("info"),
-                              QStringLiteral("-i"),
-                              source,
-                              QStringLiteral("-filter:v"),
-                              QStringLiteral("select='gt(scene,%1)',showinfo").arg(m_threshold),
-                              QStringLiteral("-vsync"),
-                              QStringLiteral("vfr"),
-                              QStringLiteral("-f"),
-                              QStringLiteral("null"),
-                              QStringLiteral("-")};
+    const QString service = binClip->getProducerProperty(QStringLiteral("mlt_service"));
+    bool detected = false;
+    if (service.startsWith(QLatin1String("avformat"))) {
+        // The scores of a previous scan can be used with any threshold
+        const QString cachePath = binClip->getSceneScoresPath();
+        std::shared_ptr<SceneScores> scores = cachePath.isEmpty() ? nullptr : SceneScores::load(cachePath);
+        if (scores == nullptr) {
+            // Media files are analysed in process, scanning several parts of the file in parallel
+            auto progressCallback = [this](int progress) {
+                m_progress = progress;
+                QMetaObject::invokeMethod(m_object, "updateJobProgress");
+            };
+            auto scanned = std::make_shared<SceneScores>();
+            if (sceneScoresLibav(source, QThread::idealThreadCount(), progressCallback, m_isCanceled, *scanned)) {
+                scores = scanned;
+                if (!cachePath.isEmpty()) {
+                    scores->save(cachePath);
+                }
+            }
+            if (m_isCanceled) {
+                return;
+            }
+        }
+        if (scores) {
+            m_results = scores->scenes(m_threshold);
+            detected = result = true;
+        }
+    }
+    if (!detected) {
+        if (KdenliveSettings::ffmpegpath().isEmpty()) {
+            // FFmpeg not detected, cannot process the Job
+            QMetaObject::invokeMethod(pCore.get(), "displayBinMessage", Qt::QueuedConnection,
+                                      Q_ARG(QString, i18n("FFmpeg not found, please set path in Kdenlive's settings Environment.")),
+                                      Q_ARG(int, int(KMessageWidget::Warning)));
+            qDebug() << "=== ABORT 2";
+            return;
+        }
+        // QStringList parameters =
+        // {QStringLiteral("-loglevel"),QStringLiteral("info"),QStringLiteral("-i"),source,QStringLiteral("-filter:v"),QStringLiteral("scdet"),QStringLiteral("-f"),QStringLiteral("null"),QStringLiteral("-")};
+        QStringList parameters = {QStringLiteral("-y"),
+                                  QStringLiteral("-loglevel"),
+                                  QStringLiteral("info"),
+                                  QStringLiteral("-i"),
+                                  source,
+                                  QStringLiteral("-filter:v"),
+                                  QStringLiteral("select='gt(scene,%1)',showinfo").arg(m_threshold),
+                                  QStringLiteral("-vsync"),
+                                  QStringLiteral("vfr"),
+                                  QStringLiteral("-f"),
+                                  QStringLiteral("null"),
+                                  QStringLiteral("-")};
 
-    m_jobProcess.reset(new QProcess);
-    // m_jobProcess->setStandardErrorFile("/tmp/test_settings.txt");
-    m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-    qDebug() << "=== READY TO START JOB:" << parameters;
-    QObject::connect(this, &SceneSplitTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardOutput, this, &SceneSplitTask::processLogInfo);
-    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &SceneSplitTask::processLogErr);
-    m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters);
-    // m_jobProcess->closeReadChannel(QProcess::StandardError);
-    m_jobProcess->waitForStarted();
-    // QString data;
-    /*while(m_jobProcess->waitForReadyRead()) {
-        //data.append(m_jobProcess->readAll());
-        qDebug()<<"???? READ: \n"<<m_jobProcess->readAll();
-    }*/
-    m_jobProcess->waitForFinished(-1);
-    result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        m_jobProcess.reset(new QProcess);
+        // m_jobProcess->setStandardErrorFile("/tmp/test_settings.txt");
+        m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
+        qDebug() << "=== READY TO START JOB:" << parameters;
+        QObject::connect(this, &SceneSplitTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardOutput, this, &SceneSplitTask::processLogInfo);
+        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &SceneSplitTask::processLogErr);
+        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters);
+        // m_jobProcess->closeReadChannel(QProcess::StandardError);
+        m_jobProcess->waitForStarted();
+        // QString data;
+        /*while(m_jobProcess->waitForReadyRead()) {
+            //data.append(m_jobProcess->readAll());
+            qDebug()<<"???? READ: \n"<<m_jobProcess->readAll();
+        }*/
+        m_jobProcess->waitForFinished(-1);
+        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+    }
 
     // remove temporary playlist if it exists
     m_progress = 100;
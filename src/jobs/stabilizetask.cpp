@@ -17,13 +17,21 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "mainwindow.h"
 #include "profiles/profilemodel.hpp"
 #include "project/clipstabilize.h"
+#include "proxyscheduler.h"
 #include "xml/xml.hpp"
 
+#include <QDir>
 #include <QProcess>
+#include <QTemporaryDir>
 #include <QThread>
 
 #include <KLocalizedString>
 
+namespace {
+/** @brief Frames analysed before each segment, the motion of a frame is measured against the previous one */
+constexpr int analysisOverlap = 1;
+} // namespace
+
 StabilizeTask::StabilizeTask(const ObjectId &owner, const QString &binId, const QString &destination, int in, int out,
                              const std::unordered_map<QString, QVariant> &filterParams, QObject *object)
     : AbstractTask(owner, AbstractTask::STABILIZEJOB, object)
@@ -99,6 +107,9 @@ void StabilizeTask::run()
     QString folderId = QLatin1String("-1");
     QStringList producerArgs = {QStringLiteral("-loglevel"), QStringLiteral("error"), QStringLiteral("progress=1"), QStringLiteral("-profile"),
                                 pCore->getCurrentProfilePath()};
+    QStringList rangeArgs;
+    int firstFrame = 0;
+    int lastFrame = -1;
     if (binClip) {
         // Filter applied on a timeline or bin clip
         folderId = binClip->parent()->clipId();
@@ -112,11 +123,13 @@ void StabilizeTask::run()
         producerArgs << binClip->enforcedParams();
 
         if (m_inPoint > -1) {
-            producerArgs << QStringLiteral("in=%1").arg(m_inPoint);
+            rangeArgs << QStringLiteral("in=%1").arg(m_inPoint);
         }
         if (m_outPoint > -1) {
-            producerArgs << QStringLiteral("out=%1").arg(m_outPoint);
+            rangeArgs << QStringLiteral("out=%1").arg(m_outPoint);
         }
+        firstFrame = qMax(0, m_inPoint);
+        lastFrame = m_outPoint > -1 ? m_outPoint : int(binClip->frameDuration()) - 1;
     } else {
         // Filter applied on a track of master producer, leave config to source job
         // We are on master or track, configure producer accordingly
@@ -136,16 +149,16 @@ void StabilizeTask::run()
         }*/
     }
 
-    producerArgs << QStringLiteral("-attach") << QStringLiteral("vidstab");
+    QStringList filterArgs = {QStringLiteral("-attach"), QStringLiteral("vidstab")};
 
     // Process filter params
     qDebug() << " = = = = = CONFIGURING FILTER PARAMS = = = = =  ";
     for (const auto &it : m_filterParams) {
         qDebug() << ". . ." << it.first << " = " << it.second;
         if (it.second.typeId() == QMetaType::Double) {
-            producerArgs << QStringLiteral("%1=%2").arg(it.first, QString::number(it.second.toDouble()));
+            filterArgs << QStringLiteral("%1=%2").arg(it.first, QString::number(it.second.toDouble()));
         } else {
-            producerArgs << QStringLiteral("%1=%2").arg(it.first, it.second.toString());
+            filterArgs << QStringLiteral("%1=%2").arg(it.first, it.second.toString());
         }
     }
     QString targetFile = m_destination + QStringLiteral(".trf");
@@ -154,16 +167,34 @@ void StabilizeTask::run()
         targetFile = m_destination + QStringLiteral("-%1.trf").arg(count);
         count++;
     }
-    producerArgs << QStringLiteral("filename=%1").arg(targetFile);
+
+    // The analysis of long clips is split in segments processed in parallel
+    const int segmentCount = analysisSegmentCount(firstFrame, lastFrame, pCore->getCurrentFps(), ProxyScheduler::maximumConcurrency(), m_filterParams);
+    if (segmentCount > 1) {
+        if (!analyseSegments(producerArgs, filterArgs, analysisSegments(firstFrame, lastFrame, segmentCount), targetFile)) {
+            QFile::remove(targetFile);
+            if (!m_isCanceled) {
+                QMetaObject::invokeMethod(pCore.get(), "displayBinLogMessage", Qt::QueuedConnection, Q_ARG(QString, i18n("Failed to stabilize.")),
+                                          Q_ARG(int, int(KMessageWidget::Warning)), Q_ARG(QString, m_logDetails));
+            }
+            return;
+        }
+        // The motion is already known, the filter directly applies the transform
+        filterArgs << QStringLiteral("results=%1").arg(targetFile);
+    }
+    producerArgs << rangeArgs << filterArgs << QStringLiteral("filename=%1").arg(targetFile);
 
     // Start the MLT Process
-    QProcess filterProcess;
-    producerArgs << QStringLiteral("-consumer") << QStringLiteral("xml:%1").arg(m_destination) << QStringLiteral("all=1")
-                 << QStringLiteral("terminate_on_pause=1");
+    producerArgs << QStringLiteral("-consumer") << QStringLiteral("xml:%1").arg(m_destination);
+    if (segmentCount <= 1) {
+        // Rendering all frames runs the analysis
+        producerArgs << QStringLiteral("all=1");
+    }
+    producerArgs << QStringLiteral("terminate_on_pause=1");
     m_jobProcess.reset(new QProcess);
     QMetaObject::invokeMethod(m_object, "updateJobProgress");
     QObject::connect(this, &AbstractTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &StabilizeTask::processLogInfo);
+    QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, [this]() { processLogInfo(); });
     qDebug() << "=== STARTING PROCESS: " << producerArgs;
     m_jobProcess->start(KdenliveSettings::meltpath(), producerArgs);
     m_jobProcess->waitForFinished(-1);
@@ -182,13 +213,28 @@ void StabilizeTask::run()
                               Q_ARG(QString, folderId), Q_ARG(QString, QStringLiteral("stabilize")));
 }
 
-void StabilizeTask::processLogInfo()
+void StabilizeTask::processLogInfo(int segment)
 {
-    const QString buffer = QString::fromUtf8(m_jobProcess->readAllStandardError());
+    QProcess *process = segment >= 0 ? m_segmentProcesses.at(size_t(segment)).get() : m_jobProcess.get();
+    if (process == nullptr) {
+        return;
+    }
+    const QString buffer = QString::fromUtf8(process->readAllStandardError());
     m_logDetails.append(buffer);
     // Parse MLT output
     if (buffer.contains(QLatin1String("percentage:"))) {
         int progress = buffer.section(QStringLiteral("percentage:"), 1).simplified().section(QLatin1Char(' '), 0, 0).toInt();
+        if (segment >= 0) {
+            // The progress of the whole analysis, each segment weighted by its length
+            m_segmentProgress[segment] = progress;
+            qint64 done = 0;
+            qint64 total = 0;
+            for (int i = 0; i < m_segmentFrames.count(); ++i) {
+                done += qint64(m_segmentProgress.at(i)) * m_segmentFrames.at(i);
+                total += m_segmentFrames.at(i);
+            }
+            progress = int(done / qMax(qint64(1), total));
+        }
         if (progress == m_progress) {
             return;
         }
@@ -196,3 +242,160 @@ void StabilizeTask::processLogInfo()
         QMetaObject::invokeMethod(m_object, "updateJobProgress");
     }
 }
+
+int StabilizeTask::analysisSegmentCount(int in, int out, double fps, int concurrency, const std::unordered_map<QString, QVariant> &filterParams)
+{
+    const auto tripod = filterParams.find(QStringLiteral("tripod"));
+    if (tripod != filterParams.end() && tripod->second.toInt() != 0) {
+        // All frames are compared to the same reference frame, which a segment may not contain
+        return 1;
+    }
+    return qMin(concurrency, int((out - in + 1) / (ProxyScheduler::MinSegmentDuration * fps)));
+}
+
+QVector<StabilizeTask::AnalysisSegment> StabilizeTask::analysisSegments(int in, int out, int count)
+{
+    QVector<AnalysisSegment> segments;
+    const int frames = out - in + 1;
+    if (frames <= 0 || count < 1) {
+        return segments;
+    }
+    count = qMin(count, frames);
+    for (int i = 0; i < count; ++i) {
+        const int first = in + int(qint64(frames) * i / count);
+        const int last = in + int(qint64(frames) * (i + 1) / count) - 1;
+        const int overlap = i > 0 ? qMin(analysisOverlap, first - in) : 0;
+        segments.append({first - overlap, last, overlap});
+    }
+    return segments;
+}
+
+bool StabilizeTask::mergeMotionData(const QStringList &files, const QVector<AnalysisSegment> &segments, const QString &destination)
+{
+    if (files.isEmpty() || files.count() != segments.count()) {
+        return false;
+    }
+    QFile output(destination);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    // The first frame number of the analysis, vid.stab stores the motion of frame n as "Frame n (List ...)"
+    int frameNumber = -1;
+    for (int i = 0; i < files.count(); ++i) {
+        QFile input(files.at(i));
+        if (!input.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            output.remove();
+            return false;
+        }
+        const AnalysisSegment &segment = segments.at(i);
+        const int kept = segment.out - segment.in + 1 - segment.overlap;
+        int index = 0;
+        int written = 0;
+        while (!input.atEnd() && written < kept) {
+            const QByteArray line = input.readLine();
+            if (!line.startsWith("Frame ")) {
+                // Keep the header and the analysis settings of the first segment
+                if (i == 0 && index == 0) {
+                    output.write(line);
+                }
+                continue;
+            }
+            if (index++ < segment.overlap) {
+                continue;
+            }
+            const int end = line.indexOf(' ', 6);
+            if (end < 0) {
+                continue;
+            }
+            if (frameNumber < 0) {
+                frameNumber = line.mid(6, end - 6).toInt();
+            }
+            output.write("Frame " + QByteArray::number(frameNumber++) + line.mid(end));
+            written++;
+        }
+        if (written != kept) {
+            // The analysis of this segment did not complete
+            output.remove();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StabilizeTask::analyseSegments(const QStringList &producerArgs, const QStringList &filterArgs, const QVector<AnalysisSegment> &segments,
+                                    const QString &targetFile)
+{
+    ProxyScheduler &scheduler = pCore->taskManager.proxyScheduler;
+    const QFileInfo targetInfo(targetFile);
+    QTemporaryDir folder(targetInfo.absoluteDir().absoluteFilePath(targetInfo.completeBaseName() + QStringLiteral("-XXXXXX")));
+    if (!folder.isValid() || segments.isEmpty()) {
+        return false;
+    }
+    QStringList files;
+    m_segmentFrames.clear();
+    for (const AnalysisSegment &segment : segments) {
+        files << folder.filePath(QStringLiteral("%1.trf").arg(files.count(), 3, 10, QLatin1Char('0')));
+        m_segmentFrames << segment.out - segment.in + 1;
+    }
+    m_segmentProgress.fill(0, segments.count());
+    m_segmentProcesses.clear();
+    m_segmentProcesses.resize(segments.size());
+    int next = 0;
+    int running = 0;
+    bool success = true;
+    while (success && (next < segments.count() || running > 0)) {
+        // Start a segment on each free slot, only the first one waits for a slot
+        while (next < segments.count()) {
+            if (!(running == 0 ? scheduler.acquire(false, m_isCanceled) : scheduler.tryAcquire(false))) {
+                break;
+            }
+            const AnalysisSegment &segment = segments.at(next);
+            QStringList args = producerArgs;
+            args << QStringLiteral("in=%1").arg(segment.in) << QStringLiteral("out=%1").arg(segment.out) << filterArgs
+                 << QStringLiteral("filename=%1").arg(files.at(next)) << QStringLiteral("-consumer")
+                 << QStringLiteral("xml:%1").arg(folder.filePath(QStringLiteral("%1.mlt").arg(next))) << QStringLiteral("all=1")
+                 << QStringLiteral("terminate_on_pause=1");
+            std::unique_ptr<QProcess> &process = m_segmentProcesses[next];
+            process.reset(new QProcess);
+            // The worker thread has no event loop, the output is read while waiting for the processes
+            QObject::connect(
+                process.get(), &QProcess::readyReadStandardError, this, [this, segment = next]() { processLogInfo(segment); }, Qt::DirectConnection);
+            process->start(KdenliveSettings::meltpath(), args);
+            if (!process->waitForStarted()) {
+                process.reset();
+                scheduler.release(false);
+                success = false;
+                break;
+            }
+            running++;
+            next++;
+        }
+        if (m_isCanceled || running == 0) {
+            success = false;
+            break;
+        }
+        for (int i = 0; i < next; ++i) {
+            std::unique_ptr<QProcess> &process = m_segmentProcesses[i];
+            if (!process || (!process->waitForFinished(50) && process->state() != QProcess::NotRunning)) {
+                continue;
+            }
+            if (process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0) {
+                m_logDetails.append(i18n("Analysis of segment %1 failed with exit code %2\n", i + 1, process->exitCode()));
+                success = false;
+            }
+            process.reset();
+            scheduler.release(false);
+            running--;
+        }
+    }
+    for (std::unique_ptr<QProcess> &process : m_segmentProcesses) {
+        if (process) {
+            process->kill();
+            process->waitForFinished();
+            process.reset();
+            scheduler.release(false);
+        }
+    }
+    m_segmentProcesses.clear();
+    return success && !m_isCanceled && mergeMotionData(files, segments, targetFile);
+}
@@ -7,21 +7,46 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #pragma once
 
 #include "abstracttask.h"
+#include <QVector>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <mlt++/MltConsumer.h>
 
 class QProcess;
 
+/** @class StabilizeTask
+    @brief Analyses the motion of a clip with the vidstab filter and creates a stabilized clip.
+    Long clips are analysed as several segments in parallel processes. Each segment starts a frame before the previous one
+    ends, so that the motion of its first kept frame is measured, and the motion data of the segments is then merged in a single file.
+ */
 class StabilizeTask : public AbstractTask
 {
 public:
+    /** @brief A range of frames analysed by one process, both ends included */
+    struct AnalysisSegment
+    {
+        int in;
+        int out;
+        /** @brief The number of frames analysed at the start of the segment only to measure the motion of the next one */
+        int overlap;
+    };
+
     StabilizeTask(const ObjectId &owner, const QString &binId, const QString &destination, int in, int out,
                   const std::unordered_map<QString, QVariant> &filterParams, QObject *object);
     static void start(QObject* object, bool force = false);
+    /** @brief The number of segments analysed in parallel for the frames @param in to @param out at @param fps, with at most
+     *  @param concurrency processes. A clip stabilized on the tripod frame of @param filterParams is analysed in a single pass */
+    static int analysisSegmentCount(int in, int out, double fps, int concurrency, const std::unordered_map<QString, QVariant> &filterParams);
+    /** @brief Split the frames from @param in to @param out in @param count overlapping segments of similar length */
+    static QVector<AnalysisSegment> analysisSegments(int in, int out, int count);
+    /** @brief Join the vidstab motion data @param files of each segment in @param destination, numbering the frames again
+     *  @returns false if a file cannot be read or does not contain the motion of all the frames of its segment */
+    static bool mergeMotionData(const QStringList &files, const QVector<AnalysisSegment> &segments, const QString &destination);
 
 private Q_SLOTS:
-    void processLogInfo();
+    /** @brief Parse the output of the process analysing @param segment, or of the main process if it is -1 */
+    void processLogInfo(int segment = -1);
 
 protected:
     void run() override;
@@ -36,4 +61,11 @@ private:
     QString m_errorMessage;
     QString m_logDetails;
     std::unique_ptr<QProcess> m_jobProcess;
+    /** @brief The processes analysing the segments of a long clip, and their progress */
+    std::vector<std::unique_ptr<QProcess>> m_segmentProcesses;
+    QVector<int> m_segmentProgress;
+    QVector<int> m_segmentFrames;
+    /** @brief Run the motion analysis of the clip described by @param producerArgs and @param filterArgs in parallel segments */
+    bool analyseSegments(const QStringList &producerArgs, const QStringList &filterArgs, const QVector<AnalysisSegment> &segments,
+                         const QString &targetFile);
 };
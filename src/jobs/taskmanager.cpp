@@ -18,6 +18,9 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QFuture>
 #include <QThread>
 
+// Time in milliseconds during which the next tasks of a reloaded clip are started at low priority
+static const int lowPriorityLifetime = 60000;
+
 TaskManager::TaskManager(QObject *parent)
     : QObject(parent)
     , displayedClip(-1)
@@ -26,7 +29,8 @@ TaskManager::TaskManager(QObject *parent)
 {
     int maxThreads = qMin(4, QThread::idealThreadCount() - 1);
     m_taskPool.setMaxThreadCount(qMax(maxThreads, 1));
-    m_transcodePool.setMaxThreadCount(KdenliveSettings::proxythreads());
+    // The number of encoding processes is limited by the proxy scheduler
+    m_transcodePool.setMaxThreadCount(ProxyScheduler::maximumConcurrency());
 }
 
 TaskManager::~TaskManager()
@@ -41,7 +45,7 @@ bool TaskManager::isBlocked() const
 
 void TaskManager::updateConcurrency()
 {
-    m_transcodePool.setMaxThreadCount(KdenliveSettings::proxythreads());
+    proxyScheduler.updateSettings();
 }
 
 void TaskManager::discardJobs(const ObjectId &owner, AbstractTask::JOBTYPE type, bool softDelete, const QVector<AbstractTask::JOBTYPE> exceptions)
@@ -270,6 +274,7 @@ void TaskManager::slotCancelJobs(bool leaveBlocked, const QVector<AbstractTask::
         }
         QWriteLocker lock(&m_tasksListLock);
         m_taskList.clear();
+        m_lowPriorityTasks.clear();
         m_taskPool.clear();
     }
     if (!leaveBlocked) {
@@ -292,6 +297,17 @@ void TaskManager::startTask(int ownerId, AbstractTask *task)
         return;
     }
     m_tasksListLock.lockForWrite();
+    auto lowPriority = m_lowPriorityTasks.find(ownerId);
+    if (lowPriority != m_lowPriorityTasks.end()) {
+        if (lowPriority->second.expiry.hasExpired()) {
+            m_lowPriorityTasks.erase(lowPriority);
+        } else if (lowPriority->second.types.removeOne(task->m_type)) {
+            task->m_priority = 0;
+            if (lowPriority->second.types.isEmpty()) {
+                m_lowPriorityTasks.erase(lowPriority);
+            }
+        }
+    }
     if (m_taskList.find(ownerId) == m_taskList.end()) {
         // First task for this clip
         m_taskList[ownerId] = {task};
@@ -306,13 +322,28 @@ void TaskManager::startTask(int ownerId, AbstractTask *task)
     // Set jobs count
     Q_EMIT jobCount(count);
     if (task->m_type == AbstractTask::TRANSCODEJOB || task->m_type == AbstractTask::PROXYJOB) {
-        // We only want a limited concurrent jobs for those as for example GPU usually only accept 2 concurrent encoding jobs
+        // The proxy scheduler limits the concurrent encoding processes, for example GPU usually only accept 2 concurrent encoding jobs
         m_transcodePool.start(task, task->m_priority);
     } else {
         m_taskPool.start(task, task->m_priority);
     }
 }
 
+void TaskManager::lowerNextTasksPriority(const ObjectId &owner, const QVector<AbstractTask::JOBTYPE> &types)
+{
+    QWriteLocker lk(&m_tasksListLock);
+    // Drop the expired requests of other owners
+    for (auto it = m_lowPriorityTasks.begin(); it != m_lowPriorityTasks.end();) {
+        if (it->second.expiry.hasExpired()) {
+            it = m_lowPriorityTasks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    // The tasks of a reload are started once the clip is loaded, leave enough time for a busy task queue
+    m_lowPriorityTasks[owner.itemId] = {types, QDeadlineTimer(lowPriorityLifetime)};
+}
+
 int TaskManager::getJobProgressForClip(const ObjectId &owner)
 {
     QStringList jobNames;
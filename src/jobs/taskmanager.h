@@ -10,8 +10,10 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #include "abstracttask.h"
 #include "definitions.h"
+#include "proxyscheduler.h"
 
 #include <QAbstractListModel>
+#include <QDeadlineTimer>
 #include <QFutureWatcher>
 #include <QObject>
 #include <QReadWriteLock>
@@ -59,6 +61,11 @@ public:
     /** @brief Add a task in the list and push it on the thread pool */
     void startTask(int ownerId, AbstractTask *task);
 
+    /** @brief The next tasks of the given @param types for @param owner are started after all other pending tasks.
+     *  Used to regenerate the thumbnails of clips reloaded in the background without delaying the loading of other clips.
+     *  The request expires after a minute */
+    void lowerNextTasksPriority(const ObjectId &owner, const QVector<AbstractTask::JOBTYPE> &types);
+
     /** @brief Remove a finished task */
     void taskDone(int cid, AbstractTask *task);
 
@@ -74,6 +81,9 @@ public:
     /** @brief Allow starting new tasks */
     void unBlock();
 
+    /** @brief Limits the concurrent proxy and transcode processes */
+    ProxyScheduler proxyScheduler;
+
 public Q_SLOTS:
     /** @brief Discard all running jobs. */
     void slotCancelJobs(bool leaveBlocked = false, const QVector<AbstractTask::JOBTYPE> exceptions = {});
@@ -82,6 +92,14 @@ private:
     QThreadPool m_taskPool;
     QThreadPool m_transcodePool;
     std::unordered_map<int, std::vector<AbstractTask*> > m_taskList;
+    /** @brief The types of the next tasks of an owner started at low priority. The request expires, so that the types which are
+     *  not started by the reload do not lower the priority of a later task */
+    struct LowPriorityTasks
+    {
+        QVector<AbstractTask::JOBTYPE> types;
+        QDeadlineTimer expiry;
+    };
+    std::unordered_map<int, LowPriorityTasks> m_lowPriorityTasks;
     mutable QReadWriteLock m_tasksListLock;
     bool m_blockUpdates;
 
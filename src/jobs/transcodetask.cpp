@@ -117,7 +117,7 @@ void TranscodeTask::run()
     }
     QString destUrl = dir.absoluteFilePath(path.section(QLatin1Char('.'), 0, -2));
 
-    bool result;
+    bool result = false;
     if (type == ClipType::Playlist || type == ClipType::SlideShow || type == ClipType::Text || type == ClipType::Timeline) {
         // change FFmpeg params to MLT format
         m_isFfmpegJob = false;
@@ -165,14 +165,18 @@ void TranscodeTask::run()
         mltParameters.prepend(source);
         mltParameters.prepend(QStringLiteral("error"));
         mltParameters.prepend(QStringLiteral("-loglevel"));
-        m_jobProcess.reset(new QProcess);
-        // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
-        QObject::connect(this, &TranscodeTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &TranscodeTask::processLogInfo);
-        m_jobProcess->start(KdenliveSettings::meltpath(), mltParameters);
-        AbstractTask::setPreferredPriority(m_jobProcess->processId());
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        // Share the encoding processes with the proxy tasks
+        if (pCore->taskManager.proxyScheduler.acquire(false, m_isCanceled)) {
+            m_jobProcess.reset(new QProcess);
+            // m_jobProcess->setProcessChannelMode(QProcess::MergedChannels);
+            QObject::connect(this, &TranscodeTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+            QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &TranscodeTask::processLogInfo);
+            m_jobProcess->start(KdenliveSettings::meltpath(), mltParameters);
+            AbstractTask::setPreferredPriority(m_jobProcess->processId());
+            m_jobProcess->waitForFinished(-1);
+            result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+            pCore->taskManager.proxyScheduler.release(false);
+        }
     } else {
         m_isFfmpegJob = true;
         QStringList parameters;
@@ -213,13 +217,16 @@ void TranscodeTask::run()
             }
         }
         qDebug() << "/// FULL TRANSCODE PARAMS:\n" << parameters << "\n------";
-        m_jobProcess.reset(new QProcess);
-        QObject::connect(this, &TranscodeTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
-        QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &TranscodeTask::processLogInfo, Qt::DirectConnection);
-        m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
-        AbstractTask::setPreferredPriority(m_jobProcess->processId());
-        m_jobProcess->waitForFinished(-1);
-        result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+        if (pCore->taskManager.proxyScheduler.acquire(false, m_isCanceled)) {
+            m_jobProcess.reset(new QProcess);
+            QObject::connect(this, &TranscodeTask::jobCanceled, m_jobProcess.get(), &QProcess::kill, Qt::DirectConnection);
+            QObject::connect(m_jobProcess.get(), &QProcess::readyReadStandardError, this, &TranscodeTask::processLogInfo, Qt::DirectConnection);
+            m_jobProcess->start(KdenliveSettings::ffmpegpath(), parameters, QIODevice::ReadOnly);
+            AbstractTask::setPreferredPriority(m_jobProcess->processId());
+            m_jobProcess->waitForFinished(-1);
+            result = m_jobProcess->exitStatus() == QProcess::NormalExit;
+            pCore->taskManager.proxyScheduler.release(false);
+        }
     }
     destUrl.append(transcoderExt);
     // remove temporary playlist if it exists
@@ -22,6 +22,7 @@
 #include <rttr/registration>
 #pragma GCC diagnostic pop
 
+std::atomic<bool> Logger::enabled{false};
 thread_local bool Logger::is_executing = false;
 std::mutex Logger::mut;
 std::vector<rttr::variant> Logger::operations;
@@ -112,6 +113,9 @@ void Logger::log_res(rttr::variant result)
 
 void Logger::log_create_producer(const std::string &type, std::vector<rttr::variant> args)
 {
+    if (!isEnabled()) {
+        return;
+    }
     std::unique_lock<std::mutex> lk(mut);
     for (auto &a : args) {
         // this will rewove shared/weak/unique ptrs
@@ -407,23 +411,17 @@ void Logger::clear()
     constr.clear();
 }
 
-LogGuard::LogGuard()
-{
-    m_hasGuard = Logger::start_logging();
-}
-LogGuard::~LogGuard()
-{
-    if (m_hasGuard) {
-        Logger::stop_logging();
-    }
-}
-bool LogGuard::hasGuard() const
+void Logger::setEnabled(bool enable)
 {
-    return m_hasGuard;
+    enabled.store(enable, std::memory_order_relaxed);
 }
 
 void Logger::log_undo(bool undo)
 {
+    if (!isEnabled()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lk(mut);
     Logger::Undo u;
     u.undo = undo;
     operations.push_back(u);
@@ -6,6 +6,7 @@
 */
 
 #pragma once
+#include <atomic>
 #include <climits>
 #include <iostream>
 #include <memory>
@@ -31,6 +32,13 @@ public:
     /** @brief Inits the logger. Must be called at startup */
     static void init();
 
+    /** @brief Enables or disables the logging at runtime. The logger is disabled by default, so that the instrumentation of the models only costs a
+     * single branch. It must be enabled before the models are created, otherwise their construction is not logged and later calls cannot be traced. */
+    static void setEnabled(bool enabled);
+
+    /** @brief Returns true if the logging is enabled, see setEnabled */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
     /** @brief Notify the logger that the current thread wants to start logging.
      * This function returns true if this is a top-level call, meaning that we indeed want to log it. If the function returns false, the  caller must not log.
      */
@@ -88,6 +96,7 @@ protected:
         std::vector<rttr::variant> args;
         rttr::variant res;
     };
+    static std::atomic<bool> enabled;
     thread_local static bool is_executing;
     thread_local static size_t result_awaiting;
     static std::mutex mut;
@@ -97,14 +106,23 @@ protected:
     static int dump_count;
 };
 
-/** @brief This class provides a RAII mechanism to log the execution of a function */
+/** @brief This class provides a RAII mechanism to log the execution of a function.
+ * It is inlined so that, when the logger is disabled, a traced function only checks Logger::isEnabled() */
 class LogGuard
 {
 public:
-    LogGuard();
-    ~LogGuard();
+    LogGuard()
+        : m_hasGuard(Logger::isEnabled() && Logger::start_logging())
+    {
+    }
+    ~LogGuard()
+    {
+        if (m_hasGuard) {
+            Logger::stop_logging();
+        }
+    }
     /** @brief Returns true if we are the top-level caller. */
-    bool hasGuard() const;
+    bool hasGuard() const { return m_hasGuard; }
 
 protected:
     bool m_hasGuard = false;
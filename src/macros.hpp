@@ -16,6 +16,8 @@
     Note that there also exists a version of update_undo_redo without the need for a lock (but prefer the mutex version where applicable)
 */
 
+#include <QReadWriteLock>
+
 /** This convenience macro adds lock/unlock ability to a given lambda function
    Note that it is automatically called when you push the lambda so you shouldn't have
    to call it directly yourself
@@ -28,20 +30,45 @@
         return res_lambda;                                                                                                                                     \
     };
 
+/** @class ModelReadLocker
+    @brief Scoped lock used by the READ_LOCK and SHARED_READ_LOCK macros.
+    It lives on the stack, so unlike a pair of QReadLocker / QWriteLocker wrapped in unique_ptrs it does not allocate.
+    Note that the lock must be recursive.
+*/
+class ModelReadLocker
+{
+public:
+    enum Mode { Exclusive, Shared };
+    ModelReadLocker(QReadWriteLock &lock, Mode mode)
+        : m_lock(lock)
+    {
+        if (mode == Shared && m_lock.tryLockForRead()) {
+            return;
+        }
+        // Either uncontended, or this thread is already executing a write operation (the lock is recursive)
+        if (!m_lock.tryLockForWrite()) {
+            m_lock.lockForRead();
+        }
+    }
+    ~ModelReadLocker() { m_lock.unlock(); }
+    Q_DISABLE_COPY(ModelReadLocker)
+
+private:
+    QReadWriteLock &m_lock;
+};
+
 /** This convenience macro locks the mutex for reading.
 Note that it might happen that a thread is executing a write operation that requires
 reading a Read-protected property. In that case, we try to write lock it first (this will be granted since the lock is recursive)
 */
-#define READ_LOCK()                                                                                                                                            \
-    std::unique_ptr<QReadLocker> rlocker(new QReadLocker(nullptr));                                                                                            \
-    std::unique_ptr<QWriteLocker> wlocker(new QWriteLocker(nullptr));                                                                                          \
-    if (m_lock.tryLockForWrite()) {                                                                                                                            \
-        /*we yield ownership of the lock to the WriteLocker*/                                                                                                  \
-        m_lock.unlock();                                                                                                                                       \
-        wlocker.reset(new QWriteLocker(&m_lock));                                                                                                              \
-    } else {                                                                                                                                                   \
-        rlocker.reset(new QReadLocker(&m_lock));                                                                                                               \
-    }
+#define READ_LOCK() ModelReadLocker rlocker(m_lock, ModelReadLocker::Exclusive)
+
+/** This macro locks the mutex for reading, allowing several threads to read at the same time.
+It is meant for the hot getters queried by the views (position, duration, track...), and must only be used in functions that do not modify
+the object, even indirectly. Since Qt does not allow to lock for read a lock that is held for write by the same thread, we fall back to a
+recursive write lock in that case.
+*/
+#define SHARED_READ_LOCK() ModelReadLocker rlocker(m_lock, ModelReadLocker::Shared)
 
 /** @brief This macro takes some lambdas that represent undo/redo for an operation and the text (name) associated with this operation
  * The lambdas are transformed to make sure they lock access to the class they operate on.
@@ -55,6 +82,31 @@ reading a Read-protected property. In that case, we try to write lock it first (
         Q_ASSERT(false);                                                                                                                                       \
     }
 
+/** @brief Same as PUSH_UNDO, but the command can be merged with the next identical one done on the same object and @param key (for example a keyframe
+ * position), see FunctionalUndoCommand::mergeWith. Use it for fine-grained operations that are repeated many times in a row, like value changes while dragging
+ */
+#define PUSH_MERGEABLE_UNDO(undo, redo, text, key)                                                                                                             \
+    if (auto ptr = m_undoStack.lock()) {                                                                                                                       \
+        auto *command = new FunctionalUndoCommand(undo, redo, text);                                                                                           \
+        command->setMergeable(true, this, key);                                                                                                                \
+        ptr->push(command);                                                                                                                                    \
+    } else {                                                                                                                                                   \
+        qDebug() << "ERROR : unable to access undo stack";                                                                                                     \
+        Q_ASSERT(false);                                                                                                                                       \
+    }
+
+/** @brief Same as PUSH_UNDO, declaring the size in bytes of the large data (producers, xml) captured by the lambdas, see FunctionalUndoCommand::addMemoryCost
+ */
+#define PUSH_UNDO_WITH_COST(undo, redo, text, cost)                                                                                                            \
+    if (auto ptr = m_undoStack.lock()) {                                                                                                                       \
+        auto *command = new FunctionalUndoCommand(undo, redo, text);                                                                                           \
+        command->addMemoryCost(cost);                                                                                                                          \
+        ptr->push(command);                                                                                                                                    \
+    } else {                                                                                                                                                   \
+        qDebug() << "ERROR : unable to access undo stack";                                                                                                     \
+        Q_ASSERT(false);                                                                                                                                       \
+    }
+
 /** @brief This macro takes as parameter one atomic operation and its reverse, and update
  * the undo and redo functional stacks/queue accordingly
  * This should be used in the rare case where we don't need a lock mutex. In general, prefer the other version
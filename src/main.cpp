@@ -175,6 +175,8 @@ int main(int argc, char *argv[])
 
 #ifdef CRASH_AUTO_TEST
     Logger::init();
+    // Model calls are only traced on request, tracing every call slows down bulk timeline operations
+    Logger::setEnabled(qEnvironmentVariableIsSet("KDENLIVE_MODEL_TRACE"));
 #endif
 
 #if defined(Q_OS_WIN)
@@ -0,0 +1,306 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "framecache.h"
+#include "core.h"
+#include "kdenlivesettings.h"
+
+#include <QDebug>
+#include <QReadLocker>
+#include <QtConcurrent/QtConcurrentRun>
+#include <cstring>
+#include <mlt++/Mlt.h>
+
+namespace {
+bool isCacheable(mlt_image_format format)
+{
+    // GPU textures cannot be copied
+    return format != mlt_image_none && format != mlt_image_movit && format != mlt_image_opengl_texture;
+}
+
+int cacheGetImage(mlt_frame frame, uint8_t **image, mlt_image_format *format, int *width, int *height, int writable)
+{
+    auto filter = static_cast<mlt_filter>(mlt_frame_pop_service(frame));
+    auto *cache = static_cast<std::shared_ptr<FrameCache> *>(mlt_properties_get_data(MLT_FILTER_PROPERTIES(filter), "_framecache", nullptr));
+    if (cache == nullptr || !isCacheable(*format)) {
+        return mlt_frame_get_image(frame, image, format, width, height, writable);
+    }
+    const int position = int(mlt_frame_get_position(frame));
+    const mlt_image_format requestFormat = *format;
+    const int requestWidth = *width;
+    const int requestHeight = *height;
+    FrameCache::Image cached;
+    if ((*cache)->fetch(position, requestFormat, requestWidth, requestHeight, cached)) {
+        // Serve a copy of the cached image, the timeline is not rendered at all
+        const int size = int(cached.data.size());
+        auto *buffer = static_cast<uint8_t *>(mlt_pool_alloc(size));
+        memcpy(buffer, cached.data.constData(), size_t(size));
+        mlt_frame_set_image(frame, buffer, size, mlt_pool_release);
+        mlt_properties properties = MLT_FRAME_PROPERTIES(frame);
+        mlt_properties_set_int(properties, "format", requestFormat);
+        mlt_properties_set_int(properties, "width", cached.width);
+        mlt_properties_set_int(properties, "height", cached.height);
+        *image = buffer;
+        *width = cached.width;
+        *height = cached.height;
+        return 0;
+    }
+    const quint64 generation = (*cache)->generation();
+    const int error = mlt_frame_get_image(frame, image, format, width, height, writable);
+    if (error == 0 && *image && *format == requestFormat) {
+        const int size = mlt_image_format_size(*format, *width, *height, nullptr);
+        (*cache)->insert(position, generation, requestFormat, requestWidth, requestHeight,
+                         {QByteArray(reinterpret_cast<const char *>(*image), size), *width, *height});
+    }
+    return error;
+}
+
+mlt_frame cacheProcess(mlt_filter filter, mlt_frame frame)
+{
+    mlt_frame_push_service(frame, filter);
+    mlt_frame_push_get_image(frame, cacheGetImage);
+    return frame;
+}
+} // namespace
+
+FrameCache::FrameCache(qint64 budget)
+    : m_budget(budget)
+{
+}
+
+FrameCache::~FrameCache()
+{
+    stopPrefetch();
+}
+
+void FrameCache::setBudget(qint64 budget)
+{
+    QMutexLocker lock(&m_mutex);
+    m_budget = budget;
+    if (m_budget <= 0) {
+        m_frames.clear();
+        m_size = 0;
+        return;
+    }
+    makeRoom(m_playhead, 0);
+}
+
+qint64 FrameCache::budget() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_budget;
+}
+
+qint64 FrameCache::size() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_size;
+}
+
+int FrameCache::count() const
+{
+    QMutexLocker lock(&m_mutex);
+    return int(m_frames.size());
+}
+
+bool FrameCache::contains(int position) const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_frames.count(position) > 0;
+}
+
+void FrameCache::setPlayhead(int position)
+{
+    QMutexLocker lock(&m_mutex);
+    m_playhead = position;
+}
+
+bool FrameCache::fetch(int position, mlt_image_format format, int requestWidth, int requestHeight, Image &image)
+{
+    QMutexLocker lock(&m_mutex);
+    m_playhead = position;
+    if (format != m_format || requestWidth != m_requestWidth || requestHeight != m_requestHeight) {
+        return false;
+    }
+    auto it = m_frames.find(position);
+    if (it == m_frames.end()) {
+        return false;
+    }
+    // The image data is implicitly shared, the copy is done by the caller outside of the lock
+    image = it->second;
+    return true;
+}
+
+bool FrameCache::insert(int position, quint64 generation, mlt_image_format format, int requestWidth, int requestHeight, Image image)
+{
+    QMutexLocker lock(&m_mutex);
+    if (generation != m_generation || m_budget <= 0) {
+        // The timeline changed while the frame was rendered
+        return false;
+    }
+    if (format != m_format || requestWidth != m_requestWidth || requestHeight != m_requestHeight) {
+        // The monitor rendering settings changed, all cached images are obsolete
+        m_frames.clear();
+        m_size = 0;
+        m_format = format;
+        m_requestWidth = requestWidth;
+        m_requestHeight = requestHeight;
+    }
+    auto existing = m_frames.find(position);
+    if (existing != m_frames.end()) {
+        m_size -= existing->second.data.size();
+        m_frames.erase(existing);
+    }
+    const qint64 bytes = image.data.size();
+    if (!makeRoom(position, bytes)) {
+        return false;
+    }
+    m_size += bytes;
+    m_frames.emplace(position, std::move(image));
+    return true;
+}
+
+bool FrameCache::makeRoom(int position, qint64 bytes)
+{
+    if (bytes > m_budget) {
+        return false;
+    }
+    while (!m_frames.empty() && m_size + bytes > m_budget) {
+        // The farthest frame from the playhead is either the first or the last one
+        auto first = m_frames.begin();
+        auto last = std::prev(m_frames.end());
+        auto farthest = qAbs(first->first - m_playhead) >= qAbs(last->first - m_playhead) ? first : last;
+        if (bytes > 0 && qAbs(farthest->first - m_playhead) < qAbs(position - m_playhead)) {
+            return false;
+        }
+        m_size -= farthest->second.data.size();
+        m_frames.erase(farthest);
+    }
+    return true;
+}
+
+quint64 FrameCache::generation() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_generation;
+}
+
+void FrameCache::invalidate(int start, int end)
+{
+    QMutexLocker lock(&m_mutex);
+    m_generation++;
+    auto first = m_frames.lower_bound(start);
+    auto last = end < 0 ? m_frames.end() : m_frames.upper_bound(end);
+    for (auto it = first; it != last; ++it) {
+        m_size -= it->second.data.size();
+    }
+    m_frames.erase(first, last);
+}
+
+void FrameCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_generation++;
+    m_frames.clear();
+    m_size = 0;
+}
+
+std::unique_ptr<Mlt::Filter> FrameCache::createFilter()
+{
+    mlt_filter filter = mlt_filter_new();
+    if (filter == nullptr) {
+        return nullptr;
+    }
+    filter->process = cacheProcess;
+    mlt_properties_set_data(MLT_FILTER_PROPERTIES(filter), "_framecache", new std::shared_ptr<FrameCache>(shared_from_this()), 0,
+                            [](void *ptr) { delete static_cast<std::shared_ptr<FrameCache> *>(ptr); }, nullptr);
+    auto result = std::make_unique<Mlt::Filter>(filter);
+    // The Mlt::Filter holds its own reference
+    mlt_filter_close(filter);
+    return result;
+}
+
+bool FrameCache::sceneOutdated() const
+{
+    return m_sceneGeneration.loadAcquire() != generation();
+}
+
+void FrameCache::prefetch(int start, int end, const QString &scene)
+{
+    stopPrefetch();
+    m_cancelPrefetch = 0;
+    m_prefetchFuture = QtConcurrent::run([this, start, end, scene]() { runPrefetch(start, end, scene); });
+}
+
+void FrameCache::cancelPrefetch()
+{
+    m_cancelPrefetch = 1;
+}
+
+void FrameCache::stopPrefetch()
+{
+    m_cancelPrefetch = 1;
+    m_prefetchFuture.waitForFinished();
+}
+
+void FrameCache::runPrefetch(int start, int end, const QString &scene)
+{
+    quint64 generation;
+    mlt_image_format format;
+    int requestWidth;
+    int requestHeight;
+    {
+        QMutexLocker lock(&m_mutex);
+        if (m_budget <= 0 || m_requestWidth <= 0 || !isCacheable(m_format)) {
+            // Nothing was displayed yet, we don't know the image parameters used by the monitor
+            return;
+        }
+        generation = m_generation;
+        format = m_format;
+        requestWidth = m_requestWidth;
+        requestHeight = m_requestHeight;
+    }
+    if (m_sceneGeneration.loadAcquire() != generation) {
+        if (scene.isEmpty()) {
+            return;
+        }
+        QReadLocker lock(&pCore->xmlMutex);
+        m_prefetchProducer = std::make_unique<Mlt::Producer>(pCore->getProjectProfile(), "xml-string", scene.toUtf8().constData());
+        lock.unlock();
+        if (!m_prefetchProducer->is_valid()) {
+            qWarning() << "Cannot load the timeline for frame prefetching";
+            m_prefetchProducer.reset();
+            return;
+        }
+        m_sceneGeneration.storeRelease(generation);
+    }
+    const QByteArray rescale = KdenliveSettings::mltinterpolation().toUtf8();
+    const QByteArray deinterlacer = KdenliveSettings::mltdeinterlacer().toUtf8();
+    for (int position = start; position <= end && !m_cancelPrefetch; ++position) {
+        if (contains(position)) {
+            continue;
+        }
+        m_prefetchProducer->seek(position);
+        std::unique_ptr<Mlt::Frame> frame(m_prefetchProducer->get_frame());
+        if (frame == nullptr || !frame->is_valid()) {
+            break;
+        }
+        frame->set("consumer.rescale", rescale.constData());
+        frame->set("consumer.deinterlacer", deinterlacer.constData());
+        mlt_image_format imageFormat = format;
+        int width = requestWidth;
+        int height = requestHeight;
+        const uint8_t *image = frame->get_image(imageFormat, width, height);
+        if (image == nullptr || imageFormat != format) {
+            break;
+        }
+        const int size = mlt_image_format_size(imageFormat, width, height, nullptr);
+        if (!insert(position, generation, format, requestWidth, requestHeight, {QByteArray(reinterpret_cast<const char *>(image), size), width, height})) {
+            // The cache is full or the timeline changed
+            break;
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QFuture>
+#include <QMutex>
+#include <map>
+#include <memory>
+#include <mlt++/MltFilter.h>
+#include <mlt++/MltProducer.h>
+
+/** @class FrameCache
+    @brief A memory bounded cache of the images rendered by the project monitor (RAM preview).
+    The cache is filled by a filter attached to the monitor consumer, which also serves the cached images instead of rendering the
+    timeline again, and by a background prefetch of the frames around the playhead. When the memory budget is reached, the frames
+    farthest from the playhead are discarded first.
+    All the cached images share the same format and size, a request with other parameters (for example after changing the preview
+    resolution) discards the cache.
+ */
+class FrameCache : public std::enable_shared_from_this<FrameCache>
+{
+public:
+    struct Image
+    {
+        QByteArray data;
+        int width{0};
+        int height{0};
+    };
+
+    /** @param budget the maximum memory used by the cached images, in bytes */
+    explicit FrameCache(qint64 budget);
+    ~FrameCache();
+    void setBudget(qint64 budget);
+    qint64 budget() const;
+    /** @brief The memory used by the cached images, in bytes */
+    qint64 size() const;
+    int count() const;
+    bool contains(int position) const;
+    /** @brief The frames are discarded by distance to this position */
+    void setPlayhead(int position);
+
+    /** @brief Get the image cached for @param position if it was rendered with the same format and requested size.
+     *  This also moves the playhead to @param position */
+    bool fetch(int position, mlt_image_format format, int requestWidth, int requestHeight, Image &image);
+    /** @brief Store a rendered image
+     *  @param generation the value of generation() before the frame was rendered, outdated images are rejected
+     *  @return false if the image was not stored */
+    bool insert(int position, quint64 generation, mlt_image_format format, int requestWidth, int requestHeight, Image image);
+    /** @brief Incremented each time cached images are discarded because the timeline changed */
+    quint64 generation() const;
+    /** @brief Discard the images between @param start and @param end (included), a negative @param end means until the end */
+    void invalidate(int start, int end);
+    void clear();
+
+    /** @brief Create the filter serving and filling the cache, to be attached to the monitor consumer */
+    std::unique_ptr<Mlt::Filter> createFilter();
+    /** @brief Returns true if the prefetch requires a new copy of the timeline */
+    bool sceneOutdated() const;
+    /** @brief Render in the background the frames between @param start and @param end that are not cached yet
+     *  @param scene the timeline xml, only used if sceneOutdated() returned true */
+    void prefetch(int start, int end, const QString &scene);
+    /** @brief Ask the prefetch to stop, without waiting */
+    void cancelPrefetch();
+    /** @brief Stop the prefetch and wait until it is finished */
+    void stopPrefetch();
+
+private:
+    mutable QMutex m_mutex;
+    std::map<int, Image> m_frames;
+    qint64 m_budget;
+    qint64 m_size{0};
+    int m_playhead{0};
+    quint64 m_generation{0};
+    mlt_image_format m_format{mlt_image_none};
+    int m_requestWidth{0};
+    int m_requestHeight{0};
+
+    /** @brief The timeline copy used for prefetching, only accessed from the prefetch thread */
+    std::unique_ptr<Mlt::Producer> m_prefetchProducer;
+    QAtomicInteger<quint64> m_sceneGeneration{~quint64(0)};
+    QAtomicInt m_cancelPrefetch;
+    QFuture<void> m_prefetchFuture;
+
+    /** @brief Discard the frames farthest from the playhead until @param bytes can be stored for @param position.
+     *  Must be called with the mutex locked, returns false if @param position is farther than all the cached frames */
+    bool makeRoom(int position, qint64 bytes);
+    void runPrefetch(int start, int end, const QString &scene);
+};
@@ -13,9 +13,11 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "doc/kdenlivedoc.h"
 #include "doc/kthumb.h"
 #include "jobs/cuttask.h"
+#include "jobs/keyframeindex/keyframeindex.h"
 #include "kdenlivesettings.h"
 #include "lib/audio/audioStreamInfo.h"
 #include "lib/localeHandling.h"
+#include "framecache.h"
 #include "mainwindow.h"
 #include "mltcontroller/clipcontroller.h"
 #include "project/dialogs/guideslist.h"
@@ -39,6 +41,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "recmanager.h"
 #include "scopes/monitoraudiolevel.h"
 #include "timeline2/model/snapmodel.hpp"
+#include "timeline2/model/timelineitemmodel.hpp"
 #include "timeline2/view/timelinecontroller.h"
 #include "timeline2/view/timelinewidget.h"
 #include "transitions/transitionsrepository.hpp"
@@ -504,16 +507,13 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     m_toolbar->addAction(m_configMenuAction);
     m_toolbar->addSeparator();
     QMargins mrg = m_toolbar->contentsMargins();
-    m_audioMeterWidget = new MonitorAudioLevel(m_toolbar->height() - mrg.top() - mrg.bottom(), this);
+    m_audioMeterWidget = new MonitorAudioLevel(m_toolbar->height() - mrg.top() - mrg.bottom(), id == Kdenlive::ProjectMonitor, this);
     m_toolbar->addWidget(m_audioMeterWidget);
     if (!m_audioMeterWidget->isValid) {
         KdenliveSettings::setMonitoraudio(0x01);
         m_audioMeterWidget->setVisibility(false);
     } else {
         m_audioMeterWidget->setVisibility((KdenliveSettings::monitoraudio() & m_id) != 0);
-        if (id == Kdenlive::ProjectMonitor) {
-            connect(m_audioMeterWidget, &MonitorAudioLevel::audioLevelsAvailable, pCore.get(), &Core::audioLevelsAvailable);
-        }
     }
 
     // Trimming tool bar buttons
@@ -564,6 +564,15 @@ Monitor::Monitor(Kdenlive::MonitorId id, MonitorManager *manager, QWidget *paren
     m_droppedTimer.setSingleShot(false);
     connect(&m_droppedTimer, &QTimer::timeout, this, &Monitor::checkDrops);
 
+    // Frames are prefetched once the project monitor stays paused
+    m_prefetchTimer.setInterval(1000);
+    m_prefetchTimer.setSingleShot(true);
+    connect(&m_prefetchTimer, &QTimer::timeout, this, &Monitor::prefetchFrames);
+
+    m_exactSeekTimer.setInterval(150);
+    m_exactSeekTimer.setSingleShot(true);
+    connect(&m_exactSeekTimer, &QTimer::timeout, this, [this]() { m_glMonitor->requestSeek(m_glMonitor->getControllerProxy()->getPosition(), true); });
+
     // Info message widget
     m_infoMessage = new KMessageWidget(this);
     layout->addWidget(m_infoMessage);
@@ -1906,6 +1915,7 @@ bool Monitor::slotOpenClip(const std::shared_ptr<ProjectClip> &controller, int i
         return true;
     }
     disconnect(this, &Monitor::seekPosition, this, &Monitor::seekRemap);
+    m_exactSeekTimer.stop();
     m_controller = controller;
     m_glMonitor->getControllerProxy()->setAudioStream(QString());
     m_snaps.reset(new SnapModel());
@@ -2831,7 +2841,20 @@ void Monitor::processSeek(int pos, bool noAudioScrub)
             m_glMonitor->setVolume(KdenliveSettings::volume() / 100.);
         }
     }
-    m_glMonitor->requestSeek(pos, noAudioScrub);
+    int seekPos = pos;
+    m_exactSeekTimer.stop();
+    if (m_id == Kdenlive::ClipMonitor && m_controller && !m_controller->hasProxy() && !m_glMonitor->getControllerProxy()->seekFinished()) {
+        // The previous seek is still decoding, we are scrubbing faster than the clip can be decoded.
+        // On long GOP footage, display the nearest keyframe and only decode the exact frame once the user stops
+        const auto index = m_controller->keyframeIndex();
+        if (index && index->isLongGop(qRound(pCore->getCurrentFps()))) {
+            seekPos = index->nearestKeyframe(pos);
+            if (seekPos != pos) {
+                m_exactSeekTimer.start();
+            }
+        }
+    }
+    m_glMonitor->requestSeek(seekPos, noAudioScrub);
     Q_EMIT m_monitorManager->cleanMixer();
 }
 
@@ -2886,6 +2909,52 @@ void Monitor::slotSeekPosition(int pos)
     Q_EMIT seekPosition(pos);
     m_timePos->setValue(pos);
     checkOverlay();
+    if (const auto cache = m_glMonitor->frameCache()) {
+        // Don't compete with playback or seeking, prefetch again once the monitor is idle
+        cache->cancelPrefetch();
+        m_prefetchTimer.start();
+    }
+}
+
+void Monitor::invalidateFrameCache(const QUuid &uuid, int in, int out)
+{
+    const auto cache = m_glMonitor->frameCache();
+    if (!cache || uuid != m_displayedUuid) {
+        return;
+    }
+    cache->cancelPrefetch();
+    cache->invalidate(in, out);
+    QMetaObject::invokeMethod(this, [this]() { m_prefetchTimer.start(); }, Qt::QueuedConnection);
+}
+
+void Monitor::prefetchFrames()
+{
+    const auto cache = m_glMonitor->frameCache();
+    if (!cache || m_playAction->isActive() || m_displayedUuid.isNull() || !pCore->currentDoc()) {
+        return;
+    }
+    std::shared_ptr<TimelineItemModel> timeline = pCore->currentDoc()->getTimeline(m_displayedUuid);
+    if (!timeline) {
+        return;
+    }
+    // Prefetch the zone if the playhead is inside, otherwise the next seconds
+    const int pos = m_glMonitor->getCurrentPos();
+    const int zoneIn = m_glMonitor->getControllerProxy()->zoneIn();
+    const int zoneOut = m_glMonitor->getControllerProxy()->zoneOut();
+    int start = pos;
+    int end = pos + qRound(pCore->getCurrentFps() * 5);
+    if (zoneOut > zoneIn && pos >= zoneIn && pos < zoneOut) {
+        start = zoneIn;
+        end = zoneOut;
+    }
+    end = qMin(end, m_glMonitor->duration() - 1);
+    if (end <= start) {
+        return;
+    }
+    cache->setPlayhead(pos);
+    // The tractor, the effect stacks and the bin producers are edited from the GUI thread without a common lock, so the timeline is
+    // serialized here, and only when the copy used by the prefetch is outdated. The worker only receives the xml
+    cache->prefetch(start, end, cache->sceneOutdated() ? timeline->sceneList(pCore->currentDoc()->documentRoot()) : QString());
 }
 
 void Monitor::slotStart()
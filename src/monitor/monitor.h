@@ -119,6 +119,9 @@ public:
     void updateGuidesList();
     /** @brief Prepare split effect from timeline clip producer **/
     void activateSplit();
+    /** @brief Discard the cached frames of timeline @param uuid between @param in and @param out, a negative @param out means until the end.
+     *  Can be called from any thread */
+    void invalidateFrameCache(const QUuid &uuid, int in, int out);
     /** @brief Clear monitor display **/
     void clearDisplay();
     void reconfigure();
@@ -253,6 +256,9 @@ private:
     MonitorSceneType m_nextSceneType{MonitorSceneType::MonitorSceneNone};
     MonitorAudioLevel *m_audioMeterWidget;
     QTimer m_droppedTimer;
+    /** @brief While scrubbing long GOP clips, we first display the nearest keyframe, this timer triggers the seek to the exact frame */
+    QTimer m_exactSeekTimer;
+    QTimer m_prefetchTimer;
     double m_displayedFps;
     int m_speedIndex;
     QMetaObject::Connection m_switchConnection;
@@ -306,6 +312,8 @@ private Q_SLOTS:
     void processSeek(int pos, bool noAudioScrub = false);
     /** @brief Check and display dropped frames */
     void checkDrops();
+    /** @brief Fill the frame cache around the playhead while the project monitor is paused */
+    void prefetchFrames();
     /** @brief En/Disable the show record timecode feature in clip monitor */
     void slotSwitchRecTimecode(bool enable);
     void addControlPoint(double x, double y, bool extend, bool exclude);
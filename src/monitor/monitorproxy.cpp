@@ -71,6 +71,11 @@ int MonitorProxy::getPosition() const
     return m_position;
 }
 
+bool MonitorProxy::seekFinished() const
+{
+    return m_seekFinished;
+}
+
 void MonitorProxy::updateClipName(int id, const QString newName)
 {
     for (int i = 0; i < m_lastClipsIds.size(); i++) {
@@ -90,6 +90,8 @@ public:
     const QString trimmingTC2() const;
     const QString timecode() const;
     int getPosition() const;
+    /** @brief Returns false while the last requested seek position was not displayed yet */
+    bool seekFinished() const;
     /** @brief update position and end seeking if we reached the requested seek position.
      *  returns true if the position was unchanged, false otherwise
      * */
@@ -6,6 +6,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 */
 
 #include "monitoraudiolevel.h"
+#include "audiomixer/audiometerbus.h"
 #include "audiomixer/iecscale.h"
 #include "core.h"
 #include "profiles/profilemodel.hpp"
@@ -18,23 +19,31 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QPaintEvent>
 #include <QPainter>
 
-MonitorAudioLevel::MonitorAudioLevel(int height, QWidget *parent)
+MonitorAudioLevel::MonitorAudioLevel(int height, bool masterLevels, QWidget *parent)
     : ScopeWidget(parent)
     , audioChannels(2)
     , m_height(height)
     , m_channelHeight(height / 2)
     , m_channelDistance(1)
     , m_channelFillHeight(m_channelHeight)
+    , m_meterId(masterLevels ? AudioMeterBus::MasterMeter : AudioMeterBus::get().acquire())
+    , m_meter(AudioMeterBus::get().ring(m_meterId))
+    , m_shownLevels(0)
 {
     setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Preferred);
     isValid = true;
-    connect(this, &MonitorAudioLevel::audioLevelsAvailable, this, &MonitorAudioLevel::setAudioValues);
 }
 
-MonitorAudioLevel::~MonitorAudioLevel() = default;
+MonitorAudioLevel::~MonitorAudioLevel()
+{
+    AudioMeterBus::get().release(m_meterId);
+}
 
 void MonitorAudioLevel::refreshScope(const QSize & /*size*/, bool /*full*/)
 {
+    if (m_meter == nullptr) {
+        return;
+    }
     SharedFrame sFrame;
     while (m_queue.count() > 0) {
         sFrame = m_queue.pop();
@@ -46,23 +55,26 @@ void MonitorAudioLevel::refreshScope(const QSize & /*size*/, bool /*full*/)
             // TODO: the 200 value is aligned with the MLT audiolevel filter, but seems arbitrary.
             samples = qMin(200, samples);
             int channels = sFrame.get_audio_channels();
-            QVector<double> levels;
+            AudioMeterLevels levels;
+            levels.position = sFrame.get_position();
+            levels.channels = qMin(channels, AudioMeterLevels::MaxChannels);
             const int16_t *audio = sFrame.get_audio();
-            for (int c = 0; c < channels; c++) {
+            for (int c = 0; c < levels.channels; c++) {
                 int16_t peak = 0;
+                double squares = 0.;
                 const int16_t *p = audio + c;
                 for (int s = 0; s < samples; s++) {
                     int16_t sample = abs(*p);
                     if (sample > peak) peak = sample;
+                    squares += double(*p) * double(*p);
                     p += channels;
                 }
-                if (peak == 0) {
-                    levels << -100;
-                } else {
-                    levels << 20 * log10((double)peak / (double)std::numeric_limits<int16_t>::max());
-                }
+                const double rms = sqrt(squares / samples);
+                levels.peak[size_t(c)] = peak == 0 ? -100 : float(20 * log10((double)peak / (double)std::numeric_limits<int16_t>::max()));
+                levels.rms[size_t(c)] = rms < 1. ? -100 : float(20 * log10(rms / (double)std::numeric_limits<int16_t>::max()));
             }
-            Q_EMIT audioLevelsAvailable(levels);
+            // The levels are displayed on next paint, and by the audio mixer for the master levels
+            m_meter->publish(levels);
         }
     }
 }
@@ -159,13 +171,20 @@ void MonitorAudioLevel::drawBackground(int channels)
     p.end();
 }
 
-// cppcheck-suppress unusedFunction
-void MonitorAudioLevel::setAudioValues(const QVector<double> &values)
+bool MonitorAudioLevel::updateLevels()
 {
-    m_values = values;
+    if (m_meter == nullptr || m_meter->published() == m_shownLevels) {
+        return false;
+    }
+    m_shownLevels = m_meter->published();
+    AudioMeterLevels levels;
+    if (!m_meter->latest(levels)) {
+        return false;
+    }
+    m_values = levels.peakValues();
     if (m_peaks.size() != m_values.size()) {
-        m_peaks = values;
-        drawBackground(values.size());
+        m_peaks = m_values;
+        drawBackground(m_values.size());
     } else {
         for (int i = 0; i < m_values.size(); i++) {
             m_peaks[i] -= 0.2;
@@ -174,7 +193,7 @@ void MonitorAudioLevel::setAudioValues(const QVector<double> &values)
             }
         }
     }
-    update();
+    return true;
 }
 
 void MonitorAudioLevel::setVisibility(bool enable)
@@ -194,6 +213,9 @@ void MonitorAudioLevel::paintEvent(QPaintEvent *pe)
     if (!isVisible()) {
         return;
     }
+    // Repaints are requested after each refresh of the scope and synchronized with the screen, so this is where we
+    // pick the last published levels
+    updateLevels();
     QPainter p(this);
     p.setClipRect(pe->rect());
     QRect rect(0, 0, width(), height());
@@ -11,11 +11,14 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QWidget>
 #include <memory>
 
+class AudioMeterRing;
+
 class MonitorAudioLevel : public ScopeWidget
 {
     Q_OBJECT
 public:
-    explicit MonitorAudioLevel(int height, QWidget *parent = nullptr);
+    /** @param masterLevels true if the levels are published as the master levels of the audio mixer */
+    explicit MonitorAudioLevel(int height, bool masterLevels, QWidget *parent = nullptr);
     ~MonitorAudioLevel() override;
     void refreshPixmap();
     int audioChannels;
@@ -35,12 +38,12 @@ private:
     int m_channelHeight;
     int m_channelDistance;
     int m_channelFillHeight;
+    /** @brief Our ring in the AudioMeterBus, written by refreshScope */
+    int m_meterId;
+    AudioMeterRing *m_meter;
+    quint64 m_shownLevels;
     void drawBackground(int channels = 2);
     void refreshScope(const QSize &size, bool full) override;
-
-public Q_SLOTS:
-    void setAudioValues(const QVector<double> &values);
-
-Q_SIGNALS:
-    void audioLevelsAvailable(const QVector<double>& levels);
+    /** @brief Read the last published levels, returns false if there is nothing new */
+    bool updateLevels();
 };
@@ -33,6 +33,7 @@
 
 #include "bin/model/markersortmodel.h"
 #include "core.h"
+#include "framecache.h"
 #include "monitorproxy.h"
 #include "profiles/profilemodel.hpp"
 #include "timeline2/view/qml/timelineitems.h"
@@ -591,6 +592,11 @@ int VideoWidget::setProducer(const std::shared_ptr<Mlt::Producer> &producer, boo
         consumerPosition = m_consumer->position();
     }
     pause();
+    if (m_frameCache && (!producer || !m_producer || producer->get_producer() != m_producer->get_producer())) {
+        // Cached frames belong to another timeline
+        m_frameCache->stopPrefetch();
+        m_frameCache->clear();
+    }
     if (producer) {
         m_producer = producer;
     } else {
@@ -736,6 +742,7 @@ int VideoWidget::reconfigure()
         if (m_producer) {
             m_consumer->connect(*m_producer.get());
             // m_producer->set_speed(0.0);
+            attachFrameCache();
         }
 
         int dropFrames = 1;
@@ -926,6 +933,34 @@ Mlt::Producer *VideoWidget::producer()
     return m_producer.get();
 }
 
+std::shared_ptr<FrameCache> VideoWidget::frameCache() const
+{
+    return m_frameCache;
+}
+
+void VideoWidget::attachFrameCache()
+{
+    if (m_id != Kdenlive::ProjectMonitor || m_glslManager) {
+        return;
+    }
+    const qint64 budget = qint64(KdenliveSettings::rampreviewmemory()) * 1024 * 1024;
+    if (m_frameCache) {
+        m_frameCache->setBudget(budget);
+    } else if (budget > 0) {
+        m_frameCache = std::make_shared<FrameCache>(budget);
+    } else {
+        return;
+    }
+    if (m_consumer->get_int("_kdenlive_framecache") == 1) {
+        // Already attached to this consumer, later producers are connected through the filter
+        return;
+    }
+    std::unique_ptr<Mlt::Filter> filter = m_frameCache->createFilter();
+    if (filter && static_cast<Mlt::FilteredConsumer *>(m_consumer.get())->attach(*filter.get()) == 0) {
+        m_consumer->set("_kdenlive_framecache", 1);
+    }
+}
+
 void VideoWidget::resetConsumer(bool fullReset)
 {
     if (fullReset && m_consumer) {
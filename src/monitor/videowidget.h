@@ -34,6 +34,7 @@ class Consumer;
 } // namespace Mlt
 
 class RenderThread;
+class FrameCache;
 class FrameRenderer;
 class MonitorProxy;
 class MarkerSortModel;
@@ -123,6 +124,8 @@ public:
     virtual const QStringList getGPUInfo();
     /** @brief Returns the current frame as image */
     QImage image() const;
+    /** @brief Returns the cache of rendered frames of the project monitor, nullptr if disabled */
+    std::shared_ptr<FrameCache> frameCache() const;
 
 protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -233,6 +236,7 @@ private:
     MonitorProxy *m_proxy;
     std::unique_ptr<RenderThread> m_renderThread;
     std::shared_ptr<Mlt::Producer> m_blackClip;
+    std::shared_ptr<FrameCache> m_frameCache;
     static void on_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_data);
     static void on_frame_render(mlt_consumer, VideoWidget *widget, mlt_frame frame);
     /*static void on_gl_frame_show(mlt_consumer, VideoWidget *widget, mlt_event_data data);
@@ -242,6 +246,8 @@ private:
     void resetZoneMode();
     bool initGPUAccel();
     void disableGPUAccel();
+    /** @brief Attach the rendered frames cache to the consumer (project monitor only) */
+    void attachFrameCache();
     /** @brief Restart consumer, keeping preview scaling settings */
     bool restartConsumer();
     /** @brief Play between in and out
@@ -0,0 +1,440 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "archivecopier.h"
+#include "jobs/keyframeindex/keyframeindex.h"
+#include "kdenlivesettings.h"
+
+#include <KLocalizedString>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr qint64 copyChunkSize = 4 * 1024 * 1024;
+} // namespace
+
+QVector<ArchiveCopier::Segment> ArchiveCopier::mergeSegments(QVector<Segment> used, int handles, int length, const KeyframeIndex *index)
+{
+    std::sort(used.begin(), used.end(), [](const Segment &a, const Segment &b) { return a.in < b.in; });
+    QVector<Segment> result;
+    for (const Segment &range : std::as_const(used)) {
+        int in = qMax(0, range.in - handles);
+        int out = range.out + handles;
+        if (length > 0) {
+            out = qMin(length - 1, out);
+        }
+        if (index != nullptr && !index->isEmpty()) {
+            // Stream copy can only start on a keyframe
+            in = index->previousKeyframe(in);
+        }
+        if (in > out) {
+            continue;
+        }
+        if (!result.isEmpty() && in <= result.last().out + 1) {
+            result.last().out = qMax(result.last().out, out);
+        } else {
+            result.append({in, out});
+        }
+    }
+    return result;
+}
+
+int ArchiveCopier::segmentIndex(const QVector<Segment> &segments, int frame)
+{
+    for (int i = 0; i < segments.count(); ++i) {
+        if (frame >= segments.at(i).in && frame <= segments.at(i).out) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int ArchiveCopier::timeToFrames(const QString &time, double fps)
+{
+    if (!time.contains(QLatin1Char(':'))) {
+        return time.toInt();
+    }
+    const QStringList parts = time.split(QLatin1Char(':'));
+    double seconds = 0;
+    for (const QString &part : parts) {
+        seconds = seconds * 60 + part.toDouble();
+    }
+    return int(lrint(seconds * fps));
+}
+
+void ArchiveCopier::rebaseFilters(const QDomElement &element, const Segment &segment, double fps)
+{
+    const int last = segment.count() - 1;
+    for (QDomElement filter = element.firstChildElement(QStringLiteral("filter")); !filter.isNull();
+         filter = filter.nextSiblingElement(QStringLiteral("filter"))) {
+        if (filter.hasAttribute(QStringLiteral("in")) || filter.hasAttribute(QStringLiteral("out"))) {
+            // The keyframes are relative to the start of the filter, only its range moves
+            for (const QString &attribute : {QStringLiteral("in"), QStringLiteral("out")}) {
+                if (filter.hasAttribute(attribute)) {
+                    const int frame = timeToFrames(filter.attribute(attribute), fps) - segment.in;
+                    filter.setAttribute(attribute, QString::number(qBound(0, frame, last)));
+                }
+            }
+            continue;
+        }
+        for (QDomElement property = filter.firstChildElement(QStringLiteral("property")); !property.isNull();
+             property = property.nextSiblingElement(QStringLiteral("property"))) {
+            if (property.attribute(QStringLiteral("name")).startsWith(QLatin1String("kdenlive:"))) {
+                continue;
+            }
+            const QString shifted = shiftKeyframes(property.text(), segment.in, fps);
+            if (shifted.isNull()) {
+                continue;
+            }
+            while (property.hasChildNodes()) {
+                property.removeChild(property.firstChild());
+            }
+            property.appendChild(property.ownerDocument().createTextNode(shifted));
+        }
+    }
+}
+
+QString ArchiveCopier::shiftKeyframes(const QString &value, int offset, double fps)
+{
+    // A position in frames or as a clock value, an optional keyframe type and the value
+    static const QRegularExpression keyframe(QStringLiteral("^(-?\\d+(?::\\d+:\\d+(?:[.,]\\d+)?)?)([^0-9=:.,]?)=(.*)$"),
+                                             QRegularExpression::DotMatchesEverythingOption);
+    const QStringList items = value.split(QLatin1Char(';'), Qt::SkipEmptyParts);
+    if (items.isEmpty()) {
+        return QString();
+    }
+    QStringList shifted;
+    QString beforeStart;
+    bool hasStart = false;
+    for (const QString &item : items) {
+        const QRegularExpressionMatch match = keyframe.match(item);
+        if (!match.hasMatch()) {
+            return QString();
+        }
+        const QString position = match.captured(1);
+        if (position.startsWith(QLatin1Char('-'))) {
+            // Relative to the end
+            shifted << item;
+            continue;
+        }
+        const int frame = timeToFrames(position, fps) - offset;
+        if (frame < 0) {
+            // Only the last keyframe before the segment is needed for the value at its start
+            beforeStart = QStringLiteral("0%1=%2").arg(match.captured(2), match.captured(3));
+            continue;
+        }
+        hasStart = hasStart || frame == 0;
+        shifted << QStringLiteral("%1%2=%3").arg(QString::number(frame), match.captured(2), match.captured(3));
+    }
+    if (!beforeStart.isEmpty() && !hasStart) {
+        shifted.prepend(beforeStart);
+    }
+    return shifted.join(QLatin1Char(';'));
+}
+
+QString ArchiveCopier::segmentPath(const QString &destination, int segment)
+{
+    const QFileInfo info(destination);
+    QString path = info.completeBaseName() + QStringLiteral("_%1").arg(segment + 1, 3, 10, QLatin1Char('0'));
+    if (!info.suffix().isEmpty()) {
+        path.append(QLatin1Char('.') + info.suffix());
+    }
+    const QString folder = info.path();
+    return folder == QLatin1String(".") ? path : folder + QLatin1Char('/') + path;
+}
+
+qint64 ArchiveCopier::estimatedSize(const Item &item)
+{
+    if (item.segments.isEmpty() || item.length <= 0) {
+        return item.size;
+    }
+    if (item.trimmedSize >= 0) {
+        return qMin(item.size, item.trimmedSize);
+    }
+    qint64 kept = 0;
+    for (const Segment &segment : item.segments) {
+        kept += segment.count();
+    }
+    // Without the keyframe offsets (audio files), the bitrate is considered constant
+    return qMin(item.size, item.size * qMin(kept, qint64(item.length)) / item.length);
+}
+
+QByteArray ArchiveCopier::contentHash(const QString &path, const QAtomicInt &abort)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    while (!file.atEnd()) {
+        if (abort.loadRelaxed()) {
+            return QByteArray();
+        }
+        const QByteArray data = file.read(copyChunkSize);
+        if (data.isEmpty()) {
+            return QByteArray();
+        }
+        hash.addData(data);
+    }
+    return hash.result();
+}
+
+void ArchiveCopier::findDuplicates(QVector<Item> &items, const QAtomicInt &abort)
+{
+    // Only files with the same size can be identical, so most files are never read
+    QHash<qint64, QVector<int>> bySize;
+    for (int i = 0; i < items.count(); ++i) {
+        items[i].duplicateOf = -1;
+        if (items.at(i).size > 0) {
+            bySize[items.at(i).size].append(i);
+        }
+    }
+    for (auto it = bySize.cbegin(); it != bySize.cend(); ++it) {
+        const QVector<int> &candidates = it.value();
+        if (candidates.count() < 2) {
+            continue;
+        }
+        QHash<QByteArray, int> byHash;
+        QHash<QString, int> byPath;
+        for (int ix : candidates) {
+            const QString path = QFileInfo(items.at(ix).source).absoluteFilePath();
+            if (byPath.contains(path)) {
+                items[ix].duplicateOf = byPath.value(path);
+                continue;
+            }
+            byPath.insert(path, ix);
+            const QByteArray hash = contentHash(path, abort);
+            if (abort.loadRelaxed()) {
+                return;
+            }
+            if (hash.isEmpty()) {
+                continue;
+            }
+            if (byHash.contains(hash)) {
+                items[ix].duplicateOf = byHash.value(hash);
+            } else {
+                byHash.insert(hash, ix);
+            }
+        }
+    }
+    // Always point to the copied item
+    for (Item &item : items) {
+        while (item.duplicateOf >= 0 && items.at(item.duplicateOf).duplicateOf >= 0) {
+            item.duplicateOf = items.at(item.duplicateOf).duplicateOf;
+        }
+    }
+}
+
+ArchiveCopier::ArchiveCopier(QVector<Item> items, double fps, QObject *parent)
+    : QObject(parent)
+    , m_items(std::move(items))
+    , m_fps(fps)
+{
+    // Copying is limited by the disks, a few parallel jobs are enough to hide the latency of each file
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 4));
+}
+
+ArchiveCopier::~ArchiveCopier()
+{
+    abort();
+    m_pool.waitForDone();
+}
+
+const QVector<ArchiveCopier::Item> &ArchiveCopier::items() const
+{
+    return m_items;
+}
+
+qint64 ArchiveCopier::totalSize(bool trimmedOnly) const
+{
+    qint64 total = 0;
+    for (const Item &item : m_items) {
+        if (item.duplicateOf >= 0 || (trimmedOnly && item.segments.isEmpty())) {
+            continue;
+        }
+        total += estimatedSize(item);
+    }
+    return total;
+}
+
+void ArchiveCopier::abort()
+{
+    m_abort = 1;
+}
+
+void ArchiveCopier::start(const QString &folder, bool trimmedOnly)
+{
+    m_folder = folder;
+    m_abort = 0;
+    m_errors.clear();
+    m_processedSize = 0;
+    m_totalSize = totalSize(trimmedOnly);
+    QVector<int> jobs;
+    for (int i = 0; i < m_items.count(); ++i) {
+        const Item &item = m_items.at(i);
+        if (item.duplicateOf >= 0 || (trimmedOnly && item.segments.isEmpty())) {
+            continue;
+        }
+        jobs << i;
+    }
+    if (jobs.isEmpty()) {
+        Q_EMIT finished(true, QString());
+        return;
+    }
+    m_remaining = jobs.count();
+    // Start with the largest files so that the pool does not end with a single long copy
+    std::sort(jobs.begin(), jobs.end(), [this](int a, int b) { return estimatedSize(m_items.at(a)) > estimatedSize(m_items.at(b)); });
+    for (int ix : std::as_const(jobs)) {
+        m_pool.start([this, ix]() {
+            const Item &item = m_items.at(ix);
+            if (!m_abort.loadRelaxed()) {
+                if (item.segments.isEmpty()) {
+                    copyFile(item);
+                } else {
+                    trimFile(item);
+                }
+            }
+            itemDone();
+        });
+    }
+}
+
+void ArchiveCopier::copyFile(const Item &item)
+{
+    const QString output = QDir(m_folder).absoluteFilePath(item.destination);
+    if (!QDir().mkpath(QFileInfo(output).absolutePath())) {
+        addError(i18n("Cannot create directory %1", QFileInfo(output).absolutePath()));
+        return;
+    }
+    QFile source(item.source);
+    QFile destination(output);
+    if (!source.open(QIODevice::ReadOnly)) {
+        addError(i18n("Cannot read file %1", item.source));
+        return;
+    }
+    if (!destination.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        addError(i18n("Cannot write to file %1", output));
+        return;
+    }
+    while (!source.atEnd()) {
+        if (m_abort.loadRelaxed()) {
+            destination.remove();
+            return;
+        }
+        const QByteArray data = source.read(copyChunkSize);
+        if (data.isEmpty() || destination.write(data) != data.size()) {
+            addError(i18n("Cannot copy file %1 to %2.", item.source, output));
+            destination.remove();
+            return;
+        }
+        addProgress(data.size());
+    }
+}
+
+void ArchiveCopier::trimFile(const Item &item)
+{
+    const qint64 estimate = estimatedSize(item);
+    qint64 kept = 0;
+    for (const Segment &segment : item.segments) {
+        kept += segment.count();
+    }
+    for (int i = 0; i < item.segments.count(); ++i) {
+        if (m_abort.loadRelaxed()) {
+            return;
+        }
+        const QString output = QDir(m_folder).absoluteFilePath(segmentPath(item.destination, i));
+        if (!QDir().mkpath(QFileInfo(output).absolutePath())) {
+            addError(i18n("Cannot create directory %1", QFileInfo(output).absolutePath()));
+            return;
+        }
+        if (!cutSegment(item.source, item.segments.at(i), output)) {
+            if (!m_abort.loadRelaxed()) {
+                addError(i18n("Cannot copy file %1 to %2.", item.source, output));
+            }
+            QFile::remove(output);
+            return;
+        }
+        addProgress(kept > 0 ? estimate * item.segments.at(i).count() / kept : 0);
+    }
+}
+
+bool ArchiveCopier::cutSegment(const QString &source, const Segment &segment, const QString &output)
+{
+    // The seek position is half a frame after the first frame, so that FFmpeg starts on that keyframe and never on the previous one
+    const QStringList params = {QStringLiteral("-y"),
+                                QStringLiteral("-v"),
+                                QStringLiteral("error"),
+                                QStringLiteral("-noaccurate_seek"),
+                                QStringLiteral("-ss"),
+                                QString::number((segment.in + 0.5) / m_fps, 'f', 6),
+                                QStringLiteral("-i"),
+                                source,
+                                QStringLiteral("-t"),
+                                QString::number(segment.count() / m_fps, 'f', 6),
+                                QStringLiteral("-map"),
+                                QStringLiteral("0"),
+                                QStringLiteral("-sn"),
+                                QStringLiteral("-dn"),
+                                QStringLiteral("-c"),
+                                QStringLiteral("copy"),
+                                QStringLiteral("-avoid_negative_ts"),
+                                QStringLiteral("make_zero"),
+                                output};
+    QProcess process;
+    process.start(KdenliveSettings::ffmpegpath(), params, QIODevice::ReadOnly);
+    if (!process.waitForStarted()) {
+        return false;
+    }
+    while (!process.waitForFinished(200)) {
+        if (m_abort.loadRelaxed()) {
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+        if (process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0 && QFileInfo(output).size() > 0;
+}
+
+void ArchiveCopier::addProgress(qint64 size)
+{
+    QMutexLocker lock(&m_mutex);
+    const int previous = m_totalSize > 0 ? int(100 * m_processedSize / m_totalSize) : 0;
+    m_processedSize += size;
+    const int current = m_totalSize > 0 ? int(qMin(qint64(100), 100 * m_processedSize / m_totalSize)) : 100;
+    lock.unlock();
+    if (current != previous) {
+        Q_EMIT progress(current);
+    }
+}
+
+void ArchiveCopier::addError(const QString &error)
+{
+    QMutexLocker lock(&m_mutex);
+    m_errors << error;
+}
+
+void ArchiveCopier::itemDone()
+{
+    if (m_remaining.fetchAndAddOrdered(-1) != 1) {
+        return;
+    }
+    QMutexLocker lock(&m_mutex);
+    const QString errors = m_errors.join(QLatin1Char('\n'));
+    lock.unlock();
+    const bool success = errors.isEmpty() && !m_abort.loadRelaxed();
+    Q_EMIT finished(success, errors);
+}
@@ -0,0 +1,114 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QAtomicInt>
+#include <QDomElement>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+class KeyframeIndex;
+
+/** @class ArchiveCopier
+    @brief Copies the media files of a project archive on a pool of worker threads.
+    Identical files (same size and content) are only copied once. Media files can be trimmed to the frames used in the
+    timeline: each used range, extended by some handles, is stream copied with FFmpeg to its own file, without re-encoding.
+    The segments start on a keyframe so that the first frame of each file is known exactly.
+ */
+class ArchiveCopier : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @brief A range of source frames, both ends included */
+    struct Segment
+    {
+        int in{0};
+        int out{0};
+        int count() const { return out - in + 1; }
+        bool operator==(const Segment &other) const { return in == other.in && out == other.out; }
+    };
+
+    struct Item
+    {
+        /** @brief The file to archive */
+        QString source;
+        /** @brief The path of the copy, relative to the archive folder */
+        QString destination;
+        /** @brief The segments to keep, the whole file is copied if empty */
+        QVector<Segment> segments;
+        /** @brief The duration of the source in frames, only used for trimmed files */
+        int length{0};
+        qint64 size{0};
+        /** @brief The bytes of the source covered by the segments, read from its keyframe index. -1 if unknown */
+        qint64 trimmedSize{-1};
+        /** @brief The index of an identical item that is copied instead of this one, -1 if there is none */
+        int duplicateOf{-1};
+    };
+
+    /** @brief Extend the @param used ranges by @param handles frames on each side and merge them.
+     *  @param length the duration of the source, the segments are not clamped at the end if it is not known (0)
+     *  @param index the keyframes of the source, segments are moved back to start on a keyframe */
+    static QVector<Segment> mergeSegments(QVector<Segment> used, int handles, int length, const KeyframeIndex *index);
+    /** @brief Returns the index of the segment containing @param frame, -1 if it was not kept */
+    static int segmentIndex(const QVector<Segment> &segments, int frame);
+    /** @brief Convert an MLT time (frames or clock value) to frames */
+    static int timeToFrames(const QString &time, double fps);
+    /** @brief Move the effects of @param element (a producer or a timeline entry) to the file of @param segment, which starts at frame 0.
+     *  The filter ranges are given in source frames, like the keyframes of filters without a range */
+    static void rebaseFilters(const QDomElement &element, const Segment &segment, double fps);
+    /** @brief Subtract @param offset from the positions of the keyframes in @param value. Keyframes moved before 0 are replaced by a
+     *  single one at 0, positions relative to the end are kept.
+     *  @returns a null string if @param value is not an animation */
+    static QString shiftKeyframes(const QString &value, int offset, double fps);
+    /** @brief The path of the file containing @param segment of a trimmed item */
+    static QString segmentPath(const QString &destination, int segment);
+    /** @brief The size of the files written for @param item. For trimmed items, this is the trimmed size if known, otherwise
+     *  it is estimated from the ratio of kept frames */
+    static qint64 estimatedSize(const Item &item);
+    /** @brief Flag the items having the same content as a previous one, only files with the same size are hashed */
+    static void findDuplicates(QVector<Item> &items, const QAtomicInt &abort);
+    /** @brief A hash of the whole content of a file, empty on error or if aborted */
+    static QByteArray contentHash(const QString &path, const QAtomicInt &abort);
+
+    ArchiveCopier(QVector<Item> items, double fps, QObject *parent = nullptr);
+    /** @brief Aborts the copy and waits for the workers */
+    ~ArchiveCopier() override;
+    /** @brief Start writing the files in @param folder
+     *  @param trimmedOnly if true, only the trimmed items are written, the other files are archived from their original location */
+    void start(const QString &folder, bool trimmedOnly);
+    void abort();
+    const QVector<Item> &items() const;
+    /** @brief The size of the files that will be written by start() */
+    qint64 totalSize(bool trimmedOnly) const;
+
+private:
+    QVector<Item> m_items;
+    double m_fps;
+    QString m_folder;
+    QThreadPool m_pool;
+    QAtomicInt m_abort;
+    QAtomicInt m_remaining;
+    QMutex m_mutex;
+    qint64 m_totalSize{0};
+    qint64 m_processedSize{0};
+    QStringList m_errors;
+    void copyFile(const Item &item);
+    void trimFile(const Item &item);
+    bool cutSegment(const QString &source, const Segment &segment, const QString &output);
+    void addProgress(qint64 size);
+    void addError(const QString &error);
+    void itemDone();
+
+Q_SIGNALS:
+    void progress(int percent);
+    /** @brief Emitted once all the files were written */
+    void finished(bool success, const QString &errorString);
+};
@@ -11,6 +11,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include "bin/projectfolder.h"
 #include "bin/projectitemmodel.h"
 #include "core.h"
+#include "jobs/keyframeindex/keyframeindex.h"
 #include "projectsettings.h"
 #include "titler/titlewidget.h"
 #include "utils/qstringutils.h"
@@ -26,11 +27,16 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <KZip>
 #include <kio/directorysizejob.h>
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMimeDatabase>
 #include <QStorageInfo>
 #include <QTreeWidget>
+#include <QUuid>
 #include <QtConcurrent/QtConcurrentRun>
 #include <utility>
+
 ArchiveWidget::ArchiveWidget(const QString &projectName, const QString &xmlData, const QStringList &luma_list, const QStringList &other_list, QWidget *parent)
     : QDialog(parent)
     , m_requestedSize(0)
@@ -44,6 +50,8 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QString &xmlData,
     , m_progressTimer(nullptr)
     , m_archive(nullptr)
     , m_missingClips(0)
+    , m_planId(0)
+    , m_copierRunning(false)
 {
     setAttribute(Qt::WA_DeleteOnClose);
     setupUi(this);
@@ -55,13 +63,21 @@ ArchiveWidget::ArchiveWidget(const QString &projectName, const QString &xmlData,
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
     connect(proxy_only, &QCheckBox::checkStateChanged, this, &ArchiveWidget::slotProxyOnly);
     connect(timeline_archive, &QCheckBox::checkStateChanged, this, &ArchiveWidget::onlyTimelineItems);
+    connect(trimmed_archive, &QCheckBox::checkStateChanged, this, &ArchiveWidget::slotTrimmedArchive);
+    connect(compressed_archive, &QCheckBox::checkStateChanged, this, &ArchiveWidget::updateTrimmedSize);
 #else
     connect(proxy_only, &QCheckBox::stateChanged, this, &ArchiveWidget::slotProxyOnly);
     connect(timeline_archive, &QCheckBox::stateChanged, this, &ArchiveWidget::onlyTimelineItems);
+    connect(trimmed_archive, &QCheckBox::stateChanged, this, &ArchiveWidget::slotTrimmedArchive);
+    connect(compressed_archive, &QCheckBox::stateChanged, this, &ArchiveWidget::updateTrimmedSize);
 #endif
+    connect(trim_handles, &QSpinBox::valueChanged, this, &ArchiveWidget::startArchivePlan);
+    connect(this, &ArchiveWidget::archivePlanReady, this, &ArchiveWidget::slotArchivePlanReady);
+    trim_handles->setEnabled(false);
 
     // Prepare xml
     m_doc.setContent(xmlData);
+    collectUsedRanges();
 
     // Setup categories
     QTreeWidgetItem *videos = new QTreeWidgetItem(files_list, QStringList() << i18n("Video Clips"));
@@ -284,6 +300,8 @@ ArchiveWidget::ArchiveWidget(QUrl url, QWidget *parent)
     , m_archive(nullptr)
     , m_missingClips(0)
     , m_infoMessage(nullptr)
+    , m_planId(0)
+    , m_copierRunning(false)
 {
     // setAttribute(Qt::WA_DeleteOnClose);
 
@@ -300,6 +318,9 @@ ArchiveWidget::ArchiveWidget(QUrl url, QWidget *parent)
     project_files->setHidden(true);
     files_list->setHidden(true);
     timeline_archive->setHidden(true);
+    trimmed_archive->setHidden(true);
+    handles_label->setHidden(true);
+    trim_handles->setHidden(true);
     compression_type->setHidden(true);
     label->setText(i18n("Extract to"));
     setWindowTitle(i18nc("@title:window", "Open Archived Project"));
@@ -313,6 +334,8 @@ ArchiveWidget::ArchiveWidget(QUrl url, QWidget *parent)
 
 ArchiveWidget::~ArchiveWidget()
 {
+    abortArchivePlan();
+    m_copier.reset();
     delete m_archive;
     delete m_progressTimer;
 }
@@ -331,8 +354,10 @@ void ArchiveWidget::slotJobResult(bool success, const QString &text)
     archive_url->setEnabled(true);
     compressed_archive->setEnabled(true);
     compression_type->setEnabled(true);
-    proxy_only->setEnabled(true);
-    timeline_archive->setEnabled(true);
+    proxy_only->setEnabled(!trimmed_archive->isChecked());
+    timeline_archive->setEnabled(!trimmed_archive->isChecked());
+    trimmed_archive->setEnabled(true);
+    trim_handles->setEnabled(trimmed_archive->isChecked());
     buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
     buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Archive"));
 }
@@ -407,8 +432,12 @@ bool ArchiveWidget::closeAccepted()
         if (m_copyJob) {
             m_copyJob->kill();
         }
+        if (m_copier) {
+            m_copier->abort();
+        }
         m_archiveThread.waitForFinished();
     }
+    abortArchivePlan();
     return true;
 }
 
@@ -584,8 +613,8 @@ void ArchiveWidget::slotCheckSpace()
     QStorageInfo info(archive_url->url().toLocalFile());
     auto freeSize = static_cast<KIO::filesize_t>(info.bytesAvailable());
     if (freeSize > m_requestedSize) {
-        // everything is ok
-        buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
+        // everything is ok, unless the trimmed archive is still being computed
+        buttonBox->button(QDialogButtonBox::Apply)->setEnabled(!m_planThread.isRunning());
         slotDisplayMessage(QStringLiteral("dialog-ok"), i18n("Available space on drive: %1", KIO::convertSize(freeSize)));
     } else {
         buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
@@ -595,11 +624,14 @@ void ArchiveWidget::slotCheckSpace()
 
 bool ArchiveWidget::slotStartArchiving(bool firstPass)
 {
-    if (firstPass && ((m_copyJob != nullptr) || m_archiveThread.isRunning())) {
+    if (firstPass && ((m_copyJob != nullptr) || m_archiveThread.isRunning() || m_copierRunning)) {
         // archiving in progress, abort
         if (m_copyJob) {
             m_copyJob->kill(KJob::EmitResult);
         }
+        if (m_copier) {
+            m_copier->abort();
+        }
         m_abortArchive = true;
         return true;
     }
@@ -611,6 +643,8 @@ bool ArchiveWidget::slotStartArchiving(bool firstPass)
     compression_type->setEnabled(false);
     proxy_only->setEnabled(false);
     timeline_archive->setEnabled(false);
+    trimmed_archive->setEnabled(false);
+    trim_handles->setEnabled(false);
     buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
     buttonBox->button(QDialogButtonBox::Close)->setEnabled(false);
 
@@ -627,6 +661,31 @@ bool ArchiveWidget::slotStartArchiving(bool firstPass)
         m_processedFiles.clear();
         slotDisplayMessage(QStringLiteral("system-run"), i18n("Archiving…"));
         repaint();
+        if (trimmed_archive->isChecked() && m_copier) {
+            // The media files are written in parallel by the copier, the other categories are then archived as usual
+            for (const PlannedFile &planned : std::as_const(m_planFiles)) {
+                m_processedFiles << planned.item->text(0);
+            }
+            QString folder = archive_url->url().toLocalFile();
+            if (isArchive) {
+                // Only the trimmed files are written, next to the archive
+                m_trimFolder = std::make_unique<QTemporaryDir>(QDir(folder).absoluteFilePath(m_name + QStringLiteral("-XXXXXX")));
+                if (!m_trimFolder->isValid()) {
+                    KMessageBox::error(this, i18n("Cannot create directory %1", folder));
+                    m_trimFolder.reset();
+                    slotJobResult(false, i18n("There was an error while copying the files: %1", i18n("Unknown Error")));
+                    buttonBox->button(QDialogButtonBox::Close)->setEnabled(true);
+                    return false;
+                }
+                folder = m_trimFolder->path();
+            }
+            m_copierRunning = true;
+            progressBar->setValue(0);
+            buttonBox->button(QDialogButtonBox::Apply)->setText(i18n("Abort"));
+            buttonBox->button(QDialogButtonBox::Apply)->setEnabled(true);
+            m_copier->start(folder, isArchive);
+            return true;
+        }
     }
     QList<QUrl> files;
     QDir destUrl;
@@ -1001,6 +1060,8 @@ QString ArchiveWidget::processMltFile(const QDomDocument &doc, const QString &de
                 if (isSlideshow) {
                     dest = QUrl::fromLocalFile(destPrefix + parentItem->data(0, Qt::UserRole).toString() + QLatin1Char('/') +
                                                item->data(0, Qt::UserRole).toString() + QLatin1Char('/') + src.fileName());
+                } else if (!item->data(0, ArchivePathRole).isNull()) {
+                    dest = QUrl::fromLocalFile(destPrefix + item->data(0, ArchivePathRole).toString());
                 } else if (item->data(0, Qt::UserRole).isNull()) {
                     dest = QUrl::fromLocalFile(destPrefix + parentItem->data(0, Qt::UserRole).toString() + QLatin1Char('/') + src.fileName());
                 }
@@ -1034,6 +1095,9 @@ QString ArchiveWidget::processMltFile(const QDomDocument &doc, const QString &de
     for (int i = 0; i < chains.count(); ++i) {
         processElement(chains.item(i).toElement(), root);
     }
+    if (destPrefix.isEmpty() && trimmed_archive->isChecked()) {
+        processTrimmedClips(doc);
+    }
 
     if (!clipsToRemove.isEmpty()) {
         // Find main playlist
@@ -1179,6 +1243,7 @@ void ArchiveWidget::createArchive()
 
 void ArchiveWidget::slotArchivingBoolFinished(bool result, const QString &errorString)
 {
+    m_trimFolder.reset();
     if (result) {
         slotJobResult(true, i18n("Project was successfully archived.\n%1", m_archiveName));
         // buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
@@ -1426,3 +1491,544 @@ void ArchiveWidget::onlyTimelineItems(int onlyTimeline)
                                  KIO::convertSize((onlyTimeline == Qt::Checked) ? m_timelineSize : m_requestedSize)));
     slotCheckSpace();
 }
+
+void ArchiveWidget::collectUsedRanges()
+{
+    m_usedRanges.clear();
+    m_untrimmableClips.clear();
+    const double fps = pCore->getCurrentFps();
+    QDomElement mlt = m_doc.documentElement();
+    QMap<QString, QDomElement> producers;
+    for (const QString &tag : {QStringLiteral("producer"), QStringLiteral("chain")}) {
+        QDomNodeList nodes = mlt.elementsByTagName(tag);
+        for (int i = 0; i < nodes.count(); ++i) {
+            QDomElement e = nodes.item(i).toElement();
+            producers.insert(e.attribute(QStringLiteral("id")), e);
+        }
+    }
+    QDomNodeList entries = mlt.elementsByTagName(QStringLiteral("entry"));
+    for (int i = 0; i < entries.count(); ++i) {
+        QDomElement entry = entries.item(i).toElement();
+        if (entry.parentNode().toElement().attribute(QStringLiteral("id")) == QLatin1String("main_bin")) {
+            continue;
+        }
+        const QDomElement producer = producers.value(entry.attribute(QStringLiteral("producer")));
+        if (producer.isNull()) {
+            continue;
+        }
+        const QString binId = Xml::getXmlProperty(producer, QStringLiteral("kdenlive:id"));
+        if (binId.isEmpty()) {
+            continue;
+        }
+        bool remapped = Xml::getXmlProperty(producer, QStringLiteral("mlt_service")) == QLatin1String("timewarp");
+        QDomNodeList links = producer.elementsByTagName(QStringLiteral("link"));
+        for (int j = 0; j < links.count() && !remapped; ++j) {
+            remapped = Xml::getXmlProperty(links.item(j).toElement(), QStringLiteral("mlt_service")) == QLatin1String("timeremap");
+        }
+        const int in = ArchiveCopier::timeToFrames(entry.attribute(QStringLiteral("in")), fps);
+        const int out = ArchiveCopier::timeToFrames(entry.attribute(QStringLiteral("out")), fps);
+        if (remapped || !entry.hasAttribute(QStringLiteral("out")) || out < in) {
+            // The frames read from the source cannot be deduced from the entry
+            m_untrimmableClips << binId;
+            continue;
+        }
+        m_usedRanges[binId].append({in, out});
+    }
+    m_untrimmableClips.removeDuplicates();
+}
+
+void ArchiveWidget::slotTrimmedArchive(int trimmed)
+{
+    const bool enabled = trimmed == Qt::Checked;
+    if (enabled) {
+        // Only the timeline clips can be trimmed, and the proxies don't match the trimmed files
+        timeline_archive->setChecked(true);
+        proxy_only->setChecked(false);
+    }
+    timeline_archive->setEnabled(!enabled);
+    proxy_only->setEnabled(!enabled);
+    trim_handles->setEnabled(enabled);
+    if (enabled) {
+        startArchivePlan();
+        return;
+    }
+    abortArchivePlan();
+    m_copier.reset();
+    m_trimmedClips.clear();
+    m_trimmedDestinations.clear();
+    for (const PlannedFile &planned : std::as_const(m_planFiles)) {
+        planned.item->setData(0, ArchivePathRole, QVariant());
+    }
+    m_planItems.clear();
+    m_planFiles.clear();
+    // Restore the proxies of the trimmed clips and the default size
+    slotProxyOnly(Qt::Unchecked);
+    onlyTimelineItems(timeline_archive->checkState());
+}
+
+void ArchiveWidget::abortArchivePlan()
+{
+    m_abortPlan = 1;
+    m_planThread.waitForFinished();
+}
+
+void ArchiveWidget::startArchivePlan()
+{
+    if (!trimmed_archive->isChecked()) {
+        return;
+    }
+    abortArchivePlan();
+    m_copier.reset();
+    m_planItems.clear();
+    m_planFiles.clear();
+    m_trimmedClips.clear();
+    m_trimmedDestinations.clear();
+    // Start from the default file list, a previous plan may have excluded some proxies
+    slotProxyOnly(Qt::Unchecked);
+
+    // Files also used by playlists or effects must stay complete
+    QStringList sharedFiles;
+    for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *parentItem = files_list->topLevelItem(i);
+        const QString category = parentItem->data(0, Qt::UserRole).toString();
+        if (category == QLatin1String("videos") || category == QLatin1String("sounds")) {
+            continue;
+        }
+        for (int j = 0; j < parentItem->childCount(); ++j) {
+            sharedFiles << parentItem->child(j)->text(0);
+        }
+    }
+    for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *parentItem = files_list->topLevelItem(i);
+        const QString category = parentItem->data(0, Qt::UserRole).toString();
+        if (category.isEmpty() || category == QLatin1String("slideshows") || category == QLatin1String("playlist")) {
+            // Subtitles, slideshows and playlists keep their own archiving process
+            continue;
+        }
+        const bool isMedia = category == QLatin1String("videos") || category == QLatin1String("sounds");
+        for (int j = 0; j < parentItem->childCount(); ++j) {
+            QTreeWidgetItem *child = parentItem->child(j);
+            if (child->isHidden() || !(child->flags() & Qt::ItemIsEnabled) || child->data(0, SizeRole).toLongLong() <= 0) {
+                continue;
+            }
+            ArchiveCopier::Item fileItem;
+            fileItem.source = child->text(0);
+            fileItem.destination = category + QLatin1Char('/') +
+                                   (child->data(0, Qt::UserRole).isNull() ? QFileInfo(fileItem.source).fileName() : child->data(0, Qt::UserRole).toString());
+            fileItem.size = child->data(0, SizeRole).toLongLong();
+            PlannedFile planned;
+            planned.item = child;
+            planned.clipId = child->data(0, ClipIdRole).toString();
+            if (isMedia && m_usedRanges.contains(planned.clipId) && !m_untrimmableClips.contains(planned.clipId) && !sharedFiles.contains(fileItem.source)) {
+                std::shared_ptr<ProjectClip> clip = pCore->projectItemModel()->getClipByBinID(planned.clipId);
+                if (clip && (clip->clipType() == ClipType::AV || clip->clipType() == ClipType::Video || clip->clipType() == ClipType::Audio)) {
+                    planned.trimmable = true;
+                    fileItem.length = int(clip->frameDuration());
+                    fileItem.segments = m_usedRanges.value(planned.clipId);
+                    if (clip->clipType() != ClipType::Audio) {
+                        planned.keyframes = clip->keyframeIndex();
+                        if (!planned.keyframes) {
+                            planned.keyframesPath = clip->getKeyframeIndexPath();
+                        }
+                    }
+                }
+            }
+            m_planItems << fileItem;
+            m_planFiles << planned;
+        }
+    }
+    buttonBox->button(QDialogButtonBox::Apply)->setEnabled(false);
+    slotDisplayMessage(QStringLiteral("system-run"), i18n("Computing archive size…"));
+    m_abortPlan = 0;
+    m_planThread = QtConcurrent::run(&ArchiveWidget::planArchive, this, pCore->getCurrentFps(), trim_handles->value(), ++m_planId);
+}
+
+void ArchiveWidget::planArchive(double fps, int handles, int planId)
+{
+    ArchiveCopier::findDuplicates(m_planItems, m_abortPlan);
+    // Identical files are copied once, with the frames used by all of them
+    for (int i = 0; i < m_planItems.count(); ++i) {
+        const int copied = m_planItems.at(i).duplicateOf;
+        if (copied < 0) {
+            continue;
+        }
+        if (m_planFiles.at(i).trimmable) {
+            m_planItems[copied].segments << m_planItems.at(i).segments;
+        } else {
+            m_planFiles[copied].trimmable = false;
+        }
+    }
+    for (int i = 0; i < m_planItems.count(); ++i) {
+        if (m_abortPlan.loadRelaxed()) {
+            return;
+        }
+        ArchiveCopier::Item &fileItem = m_planItems[i];
+        PlannedFile &planned = m_planFiles[i];
+        if (fileItem.duplicateOf >= 0) {
+            continue;
+        }
+        if (!planned.trimmable) {
+            fileItem.segments.clear();
+            continue;
+        }
+        const bool isVideo = planned.keyframes || !planned.keyframesPath.isEmpty();
+        std::shared_ptr<const KeyframeIndex> index = planned.keyframes;
+        if (!index && isVideo) {
+            index = KeyframeIndex::load(planned.keyframesPath);
+        }
+        if (!index && isVideo) {
+            std::shared_ptr<KeyframeIndex> built = KeyframeIndex::build(fileItem.source, fps, [](int) {}, m_abortPlan);
+            if (built) {
+                built->save(planned.keyframesPath);
+                index = built;
+            }
+        }
+        if (isVideo && (!index || index->isEmpty())) {
+            // The segments could not start on a keyframe, copy the whole file
+            fileItem.segments.clear();
+        } else {
+            fileItem.segments = ArchiveCopier::mergeSegments(fileItem.segments, handles, fileItem.length, index.get());
+            if (index) {
+                // The segments are cut on keyframes, so the index tells how many bytes they will use
+                fileItem.trimmedSize = 0;
+                for (const ArchiveCopier::Segment &segment : std::as_const(fileItem.segments)) {
+                    const qint64 bytes = index->byteCount(segment.in, segment.out);
+                    if (bytes < 0) {
+                        fileItem.trimmedSize = -1;
+                        break;
+                    }
+                    fileItem.trimmedSize += bytes;
+                }
+            }
+        }
+        planned.trimmable = !fileItem.segments.isEmpty();
+    }
+    for (int i = 0; i < m_planItems.count(); ++i) {
+        const int copied = m_planItems.at(i).duplicateOf;
+        if (copied >= 0) {
+            m_planItems[i].segments = m_planItems.at(copied).segments;
+            m_planItems[i].trimmedSize = m_planItems.at(copied).trimmedSize;
+            m_planFiles[i].trimmable = m_planFiles.at(copied).trimmable;
+        }
+    }
+    if (!m_abortPlan.loadRelaxed()) {
+        Q_EMIT archivePlanReady(planId);
+    }
+}
+
+void ArchiveWidget::slotArchivePlanReady(int planId)
+{
+    if (planId != m_planId || m_abortPlan.loadRelaxed()) {
+        // The plan was restarted
+        return;
+    }
+    m_planThread.waitForFinished();
+    if (!trimmed_archive->isChecked() || m_planItems.isEmpty()) {
+        updateTrimmedSize();
+        return;
+    }
+    for (int i = 0; i < m_planItems.count(); ++i) {
+        const ArchiveCopier::Item &fileItem = m_planItems.at(i);
+        const PlannedFile &planned = m_planFiles.at(i);
+        const int copied = fileItem.duplicateOf >= 0 ? fileItem.duplicateOf : i;
+        const QString destination = m_planItems.at(copied).destination;
+        planned.item->setData(0, ArchivePathRole, destination);
+        if (!fileItem.segments.isEmpty() && !planned.clipId.isEmpty()) {
+            m_trimmedClips.insert(planned.clipId, fileItem.segments);
+            m_trimmedDestinations.insert(planned.clipId, destination);
+        }
+    }
+
+    // The proxies of the trimmed clips don't match the new files, they are not archived
+    QVector<int> copierIndex(m_planItems.count(), -1);
+    QMap<int, int> promoted;
+    QVector<ArchiveCopier::Item> items;
+    for (int i = 0; i < m_planItems.count(); ++i) {
+        QTreeWidgetItem *item = m_planFiles.at(i).item;
+        if (item->parent()->data(0, Qt::UserRole).toString() == QLatin1String("proxy") &&
+            m_trimmedClips.contains(item->data(0, ClipIdRole).toString())) {
+            item->setFlags(Qt::ItemIsSelectable);
+            item->setData(0, ArchivePathRole, QVariant());
+            continue;
+        }
+        ArchiveCopier::Item fileItem = m_planItems.at(i);
+        const int copied = fileItem.duplicateOf;
+        if (copied >= 0 && copierIndex.at(copied) >= 0) {
+            fileItem.duplicateOf = copierIndex.at(copied);
+        } else if (copied >= 0 && promoted.contains(copied)) {
+            fileItem.duplicateOf = promoted.value(copied);
+        } else if (copied >= 0) {
+            // The copied file was excluded, this one replaces it
+            promoted.insert(copied, items.count());
+            fileItem.duplicateOf = -1;
+        }
+        copierIndex[i] = items.count();
+        items << fileItem;
+    }
+    m_copier = std::make_unique<ArchiveCopier>(items, pCore->getCurrentFps());
+    connect(m_copier.get(), &ArchiveCopier::progress, progressBar, &QProgressBar::setValue);
+    connect(m_copier.get(), &ArchiveCopier::finished, this, &ArchiveWidget::slotCopierFinished);
+    updateTrimmedSize();
+}
+
+void ArchiveWidget::updateTrimmedSize()
+{
+    if (!trimmed_archive->isChecked() || m_planThread.isRunning()) {
+        return;
+    }
+    updateRequiredSize();
+    if (!m_copier) {
+        slotCheckSpace();
+        return;
+    }
+    // Replace the size of the planned files with the estimated size of their copy
+    int total = 0;
+    KIO::filesize_t plannedSize = 0;
+    for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
+        QTreeWidgetItem *parentItem = files_list->topLevelItem(i);
+        const bool isSlideshow = parentItem->data(0, Qt::UserRole).toString() == QLatin1String("slideshows");
+        for (int j = 0; j < parentItem->childCount(); ++j) {
+            QTreeWidgetItem *child = parentItem->child(j);
+            if (child->isHidden() || !(child->flags() & Qt::ItemIsEnabled)) {
+                continue;
+            }
+            if (!child->data(0, ArchivePathRole).isNull()) {
+                plannedSize += static_cast<KIO::filesize_t>(child->data(0, SizeRole).toULongLong());
+            } else if (isSlideshow) {
+                total += child->data(0, SlideshowImagesRole).toStringList().count();
+            } else {
+                total++;
+            }
+        }
+    }
+    int duplicates = 0;
+    const QVector<ArchiveCopier::Item> &items = m_copier->items();
+    for (const ArchiveCopier::Item &item : items) {
+        if (item.duplicateOf >= 0) {
+            duplicates++;
+        } else {
+            total += qMax(1, int(item.segments.count()));
+        }
+    }
+    m_requestedSize = m_requestedSize - plannedSize + static_cast<KIO::filesize_t>(m_copier->totalSize(false));
+    if (compressed_archive->isChecked()) {
+        // The trimmed files are written next to the archive before being compressed
+        m_requestedSize += static_cast<KIO::filesize_t>(m_copier->totalSize(true));
+    }
+    m_timelineSize = m_requestedSize;
+    QString text = i18np("%1 file to archive, requires %2", "%1 files to archive, requires %2", total, KIO::convertSize(m_requestedSize));
+    if (duplicates > 0) {
+        text.append(QLatin1Char(' ') + i18np("(%1 duplicate file skipped)", "(%1 duplicate files skipped)", duplicates));
+    }
+    project_files->setText(text);
+    slotCheckSpace();
+}
+
+void ArchiveWidget::slotCopierFinished(bool success, const QString &errorString)
+{
+    m_copierRunning = false;
+    if (!success) {
+        if (m_abortArchive) {
+            slotJobResult(false, i18n("Abort processing"));
+        } else {
+            slotJobResult(false, i18n("There was an error while copying the files: %1", errorString.isEmpty() ? i18n("Unknown Error") : errorString));
+        }
+        for (int i = 0; i < files_list->topLevelItemCount(); ++i) {
+            files_list->topLevelItem(i)->setDisabled(false);
+        }
+        buttonBox->button(QDialogButtonBox::Close)->setEnabled(true);
+        m_trimFolder.reset();
+        return;
+    }
+    if (compressed_archive->isChecked()) {
+        // Add the copied files to the archive, the untrimmed ones are read from their original location
+        const QDir trimFolder(m_trimFolder->path());
+        const QVector<ArchiveCopier::Item> &items = m_copier->items();
+        for (const ArchiveCopier::Item &item : items) {
+            if (item.duplicateOf >= 0) {
+                continue;
+            }
+            const QString folder = QFileInfo(item.destination).path();
+            if (!m_foldersList.contains(folder)) {
+                m_foldersList << folder;
+            }
+            if (item.segments.isEmpty()) {
+                m_filesList.insert(item.source, item.destination);
+                continue;
+            }
+            for (int i = 0; i < item.segments.count(); ++i) {
+                const QString path = ArchiveCopier::segmentPath(item.destination, i);
+                m_filesList.insert(trimFolder.absoluteFilePath(path), path);
+            }
+        }
+    }
+    // Continue with the remaining files (slideshows, playlists, subtitles)
+    slotStartArchiving(false);
+}
+
+void ArchiveWidget::processTrimmedClips(const QDomDocument &doc)
+{
+    if (m_trimmedClips.isEmpty()) {
+        return;
+    }
+    QDomElement mlt = doc.documentElement();
+    const double fps = pCore->getCurrentFps();
+    QDomElement mainBin;
+    QDomNodeList playlists = mlt.elementsByTagName(QStringLiteral("playlist"));
+    for (int i = 0; i < playlists.count(); ++i) {
+        if (playlists.item(i).toElement().attribute(QStringLiteral("id")) == QLatin1String("main_bin")) {
+            mainBin = playlists.item(i).toElement();
+            break;
+        }
+    }
+    if (mainBin.isNull()) {
+        return;
+    }
+    // Find the producers of each clip and the first free id
+    QList<QDomElement> producers;
+    QMap<QString, QDomElement> producersById;
+    int maxId = 0;
+    QDomNodeList tractors = mlt.elementsByTagName(QStringLiteral("tractor"));
+    for (int i = 0; i < tractors.count(); ++i) {
+        maxId = qMax(maxId, Xml::getXmlProperty(tractors.item(i).toElement(), QStringLiteral("kdenlive:id")).toInt());
+    }
+    for (const QString &tag : {QStringLiteral("producer"), QStringLiteral("chain")}) {
+        QDomNodeList nodes = mlt.elementsByTagName(tag);
+        for (int i = 0; i < nodes.count(); ++i) {
+            QDomElement e = nodes.item(i).toElement();
+            producers << e;
+            producersById.insert(e.attribute(QStringLiteral("id")), e);
+            maxId = qMax(maxId, Xml::getXmlProperty(e, QStringLiteral("kdenlive:id")).toInt());
+        }
+    }
+    QDomNodeList binProperties = mainBin.elementsByTagName(QStringLiteral("property"));
+    for (int i = 0; i < binProperties.count(); ++i) {
+        const QString name = binProperties.item(i).toElement().attribute(QStringLiteral("name"));
+        if (name.startsWith(QLatin1String("kdenlive:folder."))) {
+            maxId = qMax(maxId, name.section(QLatin1Char('.'), -1).toInt());
+        }
+    }
+    QMap<QString, QDomElement> binEntries;
+    QList<QDomElement> timelineEntries;
+    QDomNodeList entries = mlt.elementsByTagName(QStringLiteral("entry"));
+    for (int i = 0; i < entries.count(); ++i) {
+        QDomElement entry = entries.item(i).toElement();
+        if (entry.parentNode() == mainBin) {
+            binEntries.insert(entry.attribute(QStringLiteral("producer")), entry);
+        } else {
+            timelineEntries << entry;
+        }
+    }
+
+    QMapIterator<QString, QVector<ArchiveCopier::Segment>> t(m_trimmedClips);
+    while (t.hasNext()) {
+        t.next();
+        const QString &binId = t.key();
+        const QVector<ArchiveCopier::Segment> &segments = t.value();
+        const QString destination = m_trimmedDestinations.value(binId);
+        // The bin id of each segment, the first segment keeps the original clip
+        QStringList segmentIds = {binId};
+        for (int i = 1; i < segments.count(); ++i) {
+            segmentIds << QString::number(++maxId);
+        }
+        // Clone each producer of the clip (bin and timeline producers) for the other segments
+        QMap<QString, QStringList> clonedProducers;
+        for (const QDomElement &producer : std::as_const(producers)) {
+            if (Xml::getXmlProperty(producer, QStringLiteral("kdenlive:id")) != binId) {
+                continue;
+            }
+            const QString producerId = producer.attribute(QStringLiteral("id"));
+            const bool isBinClip = binEntries.contains(producerId);
+            // The segments are cloned from the unmodified producer
+            const QDomElement original = producer.cloneNode().toElement();
+            QStringList ids = {producerId};
+            for (int i = 0; i < segments.count(); ++i) {
+                QDomElement e = producer;
+                if (i > 0) {
+                    e = original.cloneNode().toElement();
+                    const QString cloneId = QStringLiteral("%1_%2").arg(producerId).arg(i);
+                    e.setAttribute(QStringLiteral("id"), cloneId);
+                    producer.parentNode().insertAfter(e, producer);
+                    ids << cloneId;
+                    Xml::setXmlProperty(e, QStringLiteral("kdenlive:id"), segmentIds.at(i));
+                    if (Xml::hasXmlProperty(e, QStringLiteral("kdenlive:control_uuid"))) {
+                        Xml::setXmlProperty(e, QStringLiteral("kdenlive:control_uuid"), QUuid::createUuid().toString());
+                    }
+                    const QString clipName = Xml::getXmlProperty(e, QStringLiteral("kdenlive:clipname"));
+                    Xml::setXmlProperty(e, QStringLiteral("kdenlive:clipname"),
+                                        QStringLiteral("%1 (%2)").arg(clipName.isEmpty() ? QFileInfo(destination).fileName() : clipName).arg(i + 1));
+                    if (isBinClip) {
+                        QDomElement binEntry = binEntries.value(producerId).cloneNode().toElement();
+                        binEntry.setAttribute(QStringLiteral("producer"), cloneId);
+                        mainBin.insertAfter(binEntry, binEntries.value(producerId));
+                    }
+                }
+                const ArchiveCopier::Segment &segment = segments.at(i);
+                const QString path = ArchiveCopier::segmentPath(destination, i);
+                Xml::setXmlProperty(e, QStringLiteral("resource"), path);
+                if (Xml::hasXmlProperty(e, QStringLiteral("kdenlive:originalurl"))) {
+                    Xml::setXmlProperty(e, QStringLiteral("kdenlive:originalurl"), path);
+                }
+                Xml::setXmlProperty(e, QStringLiteral("length"), QString::number(segment.count()));
+                e.setAttribute(QStringLiteral("in"), QStringLiteral("0"));
+                e.setAttribute(QStringLiteral("out"), QString::number(segment.count() - 1));
+                // Clip effects use the source frames
+                ArchiveCopier::rebaseFilters(e, segment, fps);
+                for (const QString &property : {QStringLiteral("kdenlive:duration"), QStringLiteral("kdenlive:proxy"), QStringLiteral("kdenlive:file_hash"),
+                                                QStringLiteral("kdenlive:file_size")}) {
+                    Xml::removeXmlProperty(e, property);
+                }
+                // Move the markers and zones to the segment containing them
+                const QString markers = Xml::getXmlProperty(e, QStringLiteral("kdenlive:markers"));
+                if (!markers.isEmpty()) {
+                    QJsonArray kept;
+                    const QJsonArray list = QJsonDocument::fromJson(markers.toUtf8()).array();
+                    for (const QJsonValue &value : list) {
+                        QJsonObject marker = value.toObject();
+                        const int pos = marker.value(QLatin1String("pos")).toInt();
+                        if (ArchiveCopier::segmentIndex(segments, pos) == i) {
+                            marker.insert(QLatin1String("pos"), pos - segment.in);
+                            kept.append(marker);
+                        }
+                    }
+                    Xml::setXmlProperty(e, QStringLiteral("kdenlive:markers"), QString::fromUtf8(QJsonDocument(kept).toJson()));
+                }
+                const QString zones = Xml::getXmlProperty(e, QStringLiteral("kdenlive:clipzones"));
+                if (!zones.isEmpty()) {
+                    QJsonArray kept;
+                    const QJsonArray list = QJsonDocument::fromJson(zones.toUtf8()).array();
+                    for (const QJsonValue &value : list) {
+                        QJsonObject zone = value.toObject();
+                        const int in = zone.value(QLatin1String("in")).toInt();
+                        const int out = zone.value(QLatin1String("out")).toInt();
+                        if (ArchiveCopier::segmentIndex(segments, in) == i && out <= segment.out) {
+                            zone.insert(QLatin1String("in"), in - segment.in);
+                            zone.insert(QLatin1String("out"), out - segment.in);
+                            kept.append(zone);
+                        }
+                    }
+                    Xml::setXmlProperty(e, QStringLiteral("kdenlive:clipzones"), QString::fromUtf8(QJsonDocument(kept).toJson()));
+                }
+            }
+            clonedProducers.insert(producerId, ids);
+        }
+        // Point the timeline clips to the producer of their segment
+        for (QDomElement &entry : timelineEntries) {
+            const QStringList ids = clonedProducers.value(entry.attribute(QStringLiteral("producer")));
+            if (ids.isEmpty()) {
+                continue;
+            }
+            const int in = ArchiveCopier::timeToFrames(entry.attribute(QStringLiteral("in")), fps);
+            const int out = ArchiveCopier::timeToFrames(entry.attribute(QStringLiteral("out")), fps);
+            const int ix = ArchiveCopier::segmentIndex(segments, in);
+            if (ix < 0) {
+                qCWarning(KDENLIVE_LOG) << "Timeline clip" << binId << "at" << in << "is not in a trimmed segment";
+                continue;
+            }
+            entry.setAttribute(QStringLiteral("producer"), ids.at(ix));
+            entry.setAttribute(QStringLiteral("in"), QString::number(in - segments.at(ix).in));
+            entry.setAttribute(QStringLiteral("out"), QString::number(out - segments.at(ix).in));
+            ArchiveCopier::rebaseFilters(entry, segments.at(ix), fps);
+        }
+    }
+}
@@ -7,6 +7,7 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 
 #pragma once
 
+#include "project/archivecopier.h"
 #include "ui_archivewidget_ui.h"
 #include "timeline2/model/timelinemodel.hpp"
 
@@ -17,10 +18,12 @@ SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
 #include <QDialog>
 #include <QDomDocument>
 #include <QFuture>
+#include <QTemporaryDir>
 #include <memory>
 
 class KJob;
 class KArchive;
+class KeyframeIndex;
 
 class KMessageWidget;
 
@@ -60,6 +63,12 @@ private Q_SLOTS:
     void slotJobResult(bool success, const QString &text);
     void slotProxyOnly(int onlyProxy);
     void onlyTimelineItems(int onlyTimeline);
+    /** @brief Enable/disable the archiving of the used parts of the timeline clips */
+    void slotTrimmedArchive(int trimmed);
+    /** @brief Compute in the background the files to copy and the size of the trimmed archive */
+    void startArchivePlan();
+    void slotArchivePlanReady(int planId);
+    void slotCopierFinished(bool success, const QString &errorString);
 
 protected:
     void closeEvent(QCloseEvent *e) override;
@@ -70,6 +79,8 @@ private:
         SlideshowImagesRole,
         SizeRole,
         IsInTimelineRole,
+        /** @brief The path of the copy relative to the archive folder, when it differs from the default (trimmed or duplicate file) */
+        ArchivePathRole,
     };
     KIO::filesize_t m_requestedSize, m_timelineSize, m_subtitlesSize;
     KIO::CopyJob *m_copyJob;
@@ -91,6 +102,35 @@ private:
     KArchive *m_archive;
     int m_missingClips;
     KMessageWidget *m_infoMessage;
+    /** @brief The source frames used in the timeline, by bin clip id */
+    QMap<QString, QVector<ArchiveCopier::Segment>> m_usedRanges;
+    /** @brief Clips used with a speed effect or time remapping, they cannot be trimmed */
+    QStringList m_untrimmableClips;
+    /** @brief The segments kept for each trimmed bin clip */
+    QMap<QString, QVector<ArchiveCopier::Segment>> m_trimmedClips;
+    /** @brief The path of the trimmed copies of each trimmed bin clip, see ArchiveCopier::segmentPath */
+    QMap<QString, QString> m_trimmedDestinations;
+    struct PlannedFile
+    {
+        QTreeWidgetItem *item{nullptr};
+        QString clipId;
+        bool trimmable{false};
+        /** @brief The keyframes of the video stream, null for audio clips */
+        std::shared_ptr<const KeyframeIndex> keyframes;
+        /** @brief Where the keyframes are cached, for video clips that were not indexed yet */
+        QString keyframesPath;
+    };
+    /** @brief The files written by the copier, planned in the background by planArchive */
+    QVector<ArchiveCopier::Item> m_planItems;
+    QVector<PlannedFile> m_planFiles;
+    QFuture<void> m_planThread;
+    QAtomicInt m_abortPlan;
+    /** @brief Incremented for each plan, to ignore the result of an aborted plan */
+    int m_planId;
+    std::unique_ptr<ArchiveCopier> m_copier;
+    bool m_copierRunning;
+    /** @brief Where the trimmed files are written before being added to a compressed archive */
+    std::unique_ptr<QTemporaryDir> m_trimFolder;
 
     /** @brief Generate tree widget subitems from a string list of urls. */
     void generateItems(QTreeWidgetItem *parentItem, const QStringList &items);
@@ -118,10 +158,21 @@ private:
     void propertyProcessUrl(const QDomElement &e, const QString &propertyName, const QString &root);
     /** @brief Calculate required size for archiving */
     void updateRequiredSize();
+    /** @brief Find the source ranges used by the timeline clips in the project xml */
+    void collectUsedRanges();
+    /** @brief Remove duplicates and compute the segments of the trimmed files, runs in a separate thread */
+    void planArchive(double fps, int handles, int planId);
+    void abortArchivePlan();
+    /** @brief Update the required size from the trimmed archive plan */
+    void updateTrimmedSize();
+    /** @brief Point the trimmed clips to the segment files: each segment becomes a separate bin clip and the timeline clips
+     *  are moved to the clip containing their frames */
+    void processTrimmedClips(const QDomDocument &doc);
 
 Q_SIGNALS:
     void archivingFinished(bool, const QString &);
     void archiveProgress(int);
     void extractingFinished();
     void showMessage(const QString &, const QString &);
+    void archivePlanReady(int planId);
 };
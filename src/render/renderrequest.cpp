@@ -13,7 +13,14 @@
 #include "utils/qstringutils.h"
 #include "xml/xml.hpp"
 
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLockFile>
+#include <QSaveFile>
 #include <QTemporaryFile>
+#include <QThread>
 
 // TODO: remove, see generatePlaylistFile()
 #include <KMessageBox>
@@ -25,7 +32,12 @@
 
 QStringList RenderRequest::argsByJob(const RenderJob &job, bool addPid)
 {
-    QStringList args = {QStringLiteral("delivery"), KdenliveSettings::meltpath(), job.playlistPath};
+    QStringList args;
+    if (job.merge) {
+        args = {QStringLiteral("concat"), KdenliveSettings::ffmpegpath(), job.playlistPath};
+    } else {
+        args = {QStringLiteral("delivery"), KdenliveSettings::meltpath(), job.playlistPath};
+    }
     if (addPid) {
         args << QStringLiteral("--pid");
         args << QString::number(QCoreApplication::applicationPid());
@@ -33,9 +45,60 @@ QStringList RenderRequest::argsByJob(const RenderJob &job, bool addPid)
     if (!job.subtitlePath.isEmpty()) {
         args << QStringLiteral("--subtitle") << job.subtitlePath;
     }
+    if (!job.manifestPath.isEmpty()) {
+        args << QStringLiteral("--manifest") << job.manifestPath;
+    }
+    if (job.merge) {
+        // Allows reporting errors to the right job if the manifest cannot be read
+        args << QStringLiteral("--output") << job.outputPath;
+    }
     return args;
 }
 
+QVector<std::pair<int, int>> RenderRequest::segmentRanges(int in, int out, int segments, int gop)
+{
+    QVector<std::pair<int, int>> ranges;
+    const int length = out - in + 1;
+    gop = qMax(1, gop);
+    if (segments < 2 || length < 2 * gop) {
+        ranges.append({in, out});
+        return ranges;
+    }
+    // Segment length, rounded up to a multiple of the GOP size so that each segment starts on a keyframe
+    int segmentLength = (length + segments - 1) / segments;
+    segmentLength = (segmentLength + gop - 1) / gop * gop;
+    for (int start = in; start <= out; start += segmentLength) {
+        ranges.append({start, qMin(out, start + segmentLength - 1)});
+    }
+    return ranges;
+}
+
+int RenderRequest::segmentCount(int length, int segments, int checkpointLength)
+{
+    if (checkpointLength > 0) {
+        // Long renders always have several parts, so that they can be resumed
+        segments = qMax(segments, length / checkpointLength);
+    }
+    return qMax(1, segments);
+}
+
+int RenderRequest::consumerThreads(const QDomElement &consumer)
+{
+    const int maxThreads = QThread::idealThreadCount();
+    if (consumer.hasAttribute(QLatin1String("vn")) || consumer.hasAttribute(QLatin1String("video_off"))) {
+        // Audio only render
+        return 1;
+    }
+    // A negative real_time value means that many processing threads
+    int processingThreads = qAbs(consumer.attribute(QStringLiteral("real_time"), QStringLiteral("-1")).toInt());
+    int encodingThreads = consumer.attribute(QStringLiteral("threads")).toInt();
+    if (encodingThreads <= 0) {
+        // FFmpeg automatic thread count, most encoders don't scale beyond 16 threads
+        encodingThreads = qMin(16, maxThreads);
+    }
+    return qBound(1, qMax(processingThreads, encodingThreads), maxThreads);
+}
+
 RenderRequest::RenderRequest()
 {
     setBounds(-1, -1);
@@ -124,6 +187,16 @@ void RenderRequest::setAspectRatio(const QString &aspectRatio)
     m_aspectRatio = aspectRatio;
 }
 
+void RenderRequest::setSegmentedRendering(int segments)
+{
+    m_segments = qMax(1, segments);
+}
+
+void RenderRequest::setCheckpointLength(int frames)
+{
+    m_checkpointLength = qMax(0, frames);
+}
+
 std::vector<RenderRequest::RenderJob> RenderRequest::process()
 {
     m_errors.clear();
@@ -284,6 +357,17 @@ void RenderRequest::createRenderJobs(std::vector<RenderJob> &jobs, const QDomDoc
         }
     }
 
+    if ((m_segments > 1 || m_checkpointLength > 0) && !m_twoPass && !m_presetParams.isImageSequence()) {
+        if (m_delayedRendering) {
+            if (m_segments > 1) {
+                addErrorMessage(i18n("Script rendering and segmented rendering can not be used together. Script will be saved without segments."));
+                m_segments = 1;
+            }
+        } else if (createSegmentedJobs(jobs, doc, playlistPath, outputPath, subtitlePath)) {
+            return;
+        }
+    }
+
     int passes = m_twoPass ? 2 : 1;
 
     for (int i = 0; i < passes; i++) {
@@ -298,11 +382,12 @@ void RenderRequest::createRenderJobs(std::vector<RenderJob> &jobs, const QDomDoc
         if (pass == 2) {
             job.playlistPath = QStringUtils::appendToFilename(job.playlistPath, QStringLiteral("-pass%1").arg(2));
         }
-        jobs.push_back(job);
 
         // get the consumer element
         QDomNodeList consumers = final.elementsByTagName(QStringLiteral("consumer"));
         QDomElement consumer = consumers.at(0).toElement();
+        job.threads = consumerThreads(consumer);
+        jobs.push_back(job);
 
         consumer.setAttribute(QStringLiteral("target"), job.outputPath);
 
@@ -316,6 +401,168 @@ void RenderRequest::createRenderJobs(std::vector<RenderJob> &jobs, const QDomDoc
     }
 }
 
+bool RenderRequest::createSegmentedJobs(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistPath, const QString &outputPath,
+                                        const QString &subtitlePath)
+{
+    QDomElement consumer = doc.documentElement().firstChildElement(QStringLiteral("consumer"));
+    if (consumer.hasAttribute(QLatin1String("vn")) || consumer.hasAttribute(QLatin1String("video_off"))) {
+        // Audio only render, nothing to split
+        return false;
+    }
+    int gop = consumer.attribute(QStringLiteral("g")).toInt();
+    if (gop <= 0) {
+        gop = qMax(1, qRound(pCore->getCurrentFps()));
+    }
+    const int in = consumer.attribute(QStringLiteral("in")).toInt();
+    const int out = consumer.attribute(QStringLiteral("out")).toInt();
+    const QVector<std::pair<int, int>> ranges = segmentRanges(in, out, segmentCount(out - in + 1, m_segments, m_checkpointLength), gop);
+    if (ranges.size() < 2) {
+        return false;
+    }
+    QDir segmentsDir(outputPath + QStringLiteral(".segments"));
+    if (!segmentsDir.mkpath(QStringLiteral("."))) {
+        addErrorMessage(i18n("Could not create segments folder:\n %1", segmentsDir.absolutePath()));
+        return false;
+    }
+    const QString extension = QFileInfo(outputPath).suffix();
+    const QString manifestPath = segmentsDir.absoluteFilePath(QStringLiteral("manifest.json"));
+    // The project hash identifies the rendered content, so that an interrupted render can be resumed
+    const QString hash = QString::fromLatin1(QCryptographicHash::hash(doc.toByteArray(), QCryptographicHash::Md5).toHex());
+    // Segments of a previous render that are still running update the manifest under this lock
+    QLockFile lock(manifestPath + QStringLiteral(".lock"));
+    if (!lock.lock()) {
+        addErrorMessage(i18n("Cannot lock file %1", manifestPath));
+        return true;
+    }
+    QJsonObject previous;
+    QFile previousFile(manifestPath);
+    if (previousFile.open(QIODevice::ReadOnly)) {
+        previous = QJsonDocument::fromJson(previousFile.readAll()).object();
+        previousFile.close();
+    }
+    QJsonArray previousSegments = previous.value(QLatin1String("segments")).toArray();
+    if (previous.value(QLatin1String("hash")).toString() != hash || previousSegments.count() != ranges.size()) {
+        // Not the same render, start from scratch
+        previous = QJsonObject();
+        previousSegments = QJsonArray();
+    }
+    // The segments of a render are scheduled together, each one gets its share of the processor cores
+    const int parallelSegments = qBound(1, m_segments, int(ranges.size()));
+    const int segmentThreads = qMax(1, QThread::idealThreadCount() / parallelSegments);
+    int resumed = 0;
+    QStringList dependencies;
+    QJsonArray segments;
+    for (int i = 0; i < ranges.size(); ++i) {
+        QDomDocument segmentDoc = doc.cloneNode(true).toDocument();
+        QDomElement segmentConsumer = segmentDoc.documentElement().firstChildElement(QStringLiteral("consumer"));
+        const QString partName = QStringLiteral("part%1").arg(i + 1, 3, 10, QLatin1Char('0'));
+        RenderJob job;
+        // Playlists are written in the segments folder, which is removed once the segments are joined
+        job.playlistPath = segmentsDir.absoluteFilePath(QStringLiteral("%1.mlt").arg(partName));
+        job.outputPath = segmentsDir.absoluteFilePath(QStringLiteral("%1.%2").arg(partName, extension));
+        job.extraInfo = i18n("Segment %1 of %2", i + 1, ranges.size());
+        job.manifestPath = manifestPath;
+        QJsonObject segment;
+        segment[QLatin1String("file")] = job.outputPath;
+        segment[QLatin1String("in")] = ranges.at(i).first;
+        segment[QLatin1String("out")] = ranges.at(i).second;
+        if (!previousSegments.isEmpty()) {
+            const QJsonObject previousSegment = previousSegments.at(i).toObject();
+            if (previousSegment.value(QLatin1String("done")).toBool() && previousSegment.value(QLatin1String("in")).toInt() == ranges.at(i).first &&
+                previousSegment.value(QLatin1String("out")).toInt() == ranges.at(i).second && QFile::exists(job.outputPath)) {
+                // This segment was completed by a previous render
+                segment[QLatin1String("done")] = true;
+                segments.append(segment);
+                resumed++;
+                continue;
+            }
+        }
+        QFile::remove(job.outputPath);
+        segmentConsumer.setAttribute(QStringLiteral("in"), ranges.at(i).first);
+        segmentConsumer.setAttribute(QStringLiteral("out"), ranges.at(i).second);
+        segmentConsumer.setAttribute(QStringLiteral("target"), job.outputPath);
+        // Audio is rendered in a single pass to avoid seams at segment boundaries
+        segmentConsumer.setAttribute(QStringLiteral("an"), 1);
+        segmentConsumer.setAttribute(QStringLiteral("audio_off"), 1);
+        const int encodingThreads = segmentConsumer.attribute(QStringLiteral("threads")).toInt();
+        if (encodingThreads <= 0 || encodingThreads > segmentThreads) {
+            segmentConsumer.setAttribute(QStringLiteral("threads"), segmentThreads);
+        }
+        const int processingThreads = segmentConsumer.attribute(QStringLiteral("real_time"), QStringLiteral("-1")).toInt();
+        if (processingThreads < -segmentThreads) {
+            segmentConsumer.setAttribute(QStringLiteral("real_time"), -segmentThreads);
+        }
+        job.threads = consumerThreads(segmentConsumer);
+        if (!Xml::docContentToFile(segmentDoc, job.playlistPath)) {
+            addErrorMessage(i18n("Cannot write to file %1", job.playlistPath));
+            return true;
+        }
+        jobs.push_back(job);
+        dependencies << job.outputPath;
+        segments.append(segment);
+    }
+
+    QJsonObject manifest;
+    if (!consumer.hasAttribute(QLatin1String("an")) && !consumer.hasAttribute(QLatin1String("audio_off"))) {
+        const QString audioPath = segmentsDir.absoluteFilePath(QStringLiteral("audio.%1").arg(extension));
+        manifest[QLatin1String("audio")] = audioPath;
+        if (previous.value(QLatin1String("audioDone")).toBool() && QFile::exists(audioPath)) {
+            manifest[QLatin1String("audioDone")] = true;
+        } else {
+            QFile::remove(audioPath);
+            QDomDocument audioDoc = doc.cloneNode(true).toDocument();
+            QDomElement audioConsumer = audioDoc.documentElement().firstChildElement(QStringLiteral("consumer"));
+            RenderJob job;
+            job.playlistPath = segmentsDir.absoluteFilePath(QStringLiteral("audio.mlt"));
+            job.outputPath = audioPath;
+            job.extraInfo = i18n("Audio for segmented render");
+            job.manifestPath = manifestPath;
+            audioConsumer.setAttribute(QStringLiteral("target"), job.outputPath);
+            audioConsumer.setAttribute(QStringLiteral("vn"), 1);
+            audioConsumer.setAttribute(QStringLiteral("video_off"), 1);
+            job.threads = consumerThreads(audioConsumer);
+            if (!Xml::docContentToFile(audioDoc, job.playlistPath)) {
+                addErrorMessage(i18n("Cannot write to file %1", job.playlistPath));
+                return true;
+            }
+            jobs.push_back(job);
+            dependencies << job.outputPath;
+        }
+    }
+
+    // The manifest lists the segments to join, it is read by kdenlive_render in concat mode
+    manifest[QLatin1String("hash")] = hash;
+    manifest[QLatin1String("output")] = outputPath;
+    manifest[QLatin1String("in")] = in;
+    manifest[QLatin1String("out")] = out;
+    manifest[QLatin1String("segments")] = segments;
+    RenderJob mergeJob;
+    mergeJob.playlistPath = manifestPath;
+    mergeJob.outputPath = outputPath;
+    mergeJob.subtitlePath = subtitlePath;
+    mergeJob.merge = true;
+    mergeJob.dependencies = dependencies;
+    if (resumed > 0) {
+        mergeJob.extraInfo = i18n("Join %1 segments (%2 resumed)", ranges.size(), resumed);
+    } else {
+        mergeJob.extraInfo = i18n("Join %1 segments", ranges.size());
+    }
+    QSaveFile file(mergeJob.playlistPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        addErrorMessage(i18n("Cannot write to file %1", mergeJob.playlistPath));
+        return true;
+    }
+    file.write(QJsonDocument(manifest).toJson());
+    if (!file.commit()) {
+        addErrorMessage(i18n("Cannot write to file %1", mergeJob.playlistPath));
+        return true;
+    }
+    // Each segment has its own playlist, the one of the whole render is not used
+    QFile::remove(playlistPath);
+    jobs.push_back(mergeJob);
+    return true;
+}
+
 QString RenderRequest::createEmptyTempFile(const QString &extension)
 {
     QTemporaryFile tmp(QDir::temp().absoluteFilePath(QStringLiteral("kdenlive-XXXXXX.%1").arg(extension)));
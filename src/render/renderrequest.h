@@ -20,6 +20,17 @@ public:
         QString playlistPath;
         QString outputPath;
         QString subtitlePath;
+        /// Estimated number of processor cores used by this job, used to schedule concurrent jobs
+        int threads = 1;
+        /// Output paths of the jobs that have to be finished before this one can start
+        QStringList dependencies;
+        /// If true, this job joins the segments listed in playlistPath (a segment manifest) instead of rendering
+        bool merge = false;
+        /// Information displayed in the render queue
+        QString extraInfo;
+        /// Manifest of the segmented render this job belongs to, the job marks itself as complete in it.
+        /// The jobs of a segmented render are scheduled as a group, see RenderWidget::checkRenderStatus
+        QString manifestPath;
     };
 
     /** @brief Set frame range that should be rendered
@@ -39,12 +50,25 @@ public:
     void setAudioFilePerTrack(bool enabled);
     void setGuideParams(std::weak_ptr<MarkerListModel> model, bool enableMultiExport, int filterCategory);
     void setOverlayData(const QString &data);
+    /** @brief Render video in @param segments parts processed in parallel, joined without re-encoding. 1 disables segmented rendering.
+     *  Resuming an interrupted render relies on the completed segments, see setCheckpointLength() for renders that are not segmented */
+    void setSegmentedRendering(int segments);
+    /** @brief Split renders longer than twice @param frames in parts of about that length, even when segmented rendering is disabled,
+     *  so that an interrupted render can be resumed. 0 disables it */
+    void setCheckpointLength(int frames);
 
     std::vector<RenderJob> process();
 
     QStringList errorMessages();
 
     static QStringList argsByJob(const RenderJob &job, bool addPid = true);
+    /** @brief Estimate the number of processor cores a render will use from its consumer parameters */
+    static int consumerThreads(const QDomElement &consumer);
+    /** @brief Split the @param in / @param out range in at most @param segments ranges, starting on a multiple of @param gop frames */
+    static QVector<std::pair<int, int>> segmentRanges(int in, int out, int segments, int gop);
+    /** @brief The number of segments for a render of @param length frames, with @param segments requested by the user and
+     *  a checkpoint every @param checkpointLength frames (0 for none) */
+    static int segmentCount(int length, int segments, int checkpointLength);
 
     /** @brief Some methods used for tests */
     int guideSectionsCount();
@@ -75,6 +99,8 @@ private:
     bool m_guideMultiExport = false;
     int m_guideCategory = -1; /// category used as filter if @variable guideMultiExport is @value true
     bool m_twoPass = false;
+    int m_segments = 1;
+    int m_checkpointLength = 0;
 
     QStringList m_errors;
 
@@ -100,5 +126,13 @@ private:
     void createRenderJobs(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistPath, QString outputPath, const QString &subtitlePath,
                           const QUuid &uuid);
 
+    /** @brief Create one render job per video segment, one for the continuous audio and the job joining them.
+     *  The segments completed by a previous render of the same project are reused. The segment playlists are written in the segments folder,
+     *  removed after the join, and the processor cores are shared between the segments rendered in parallel.
+     *  @returns false if the render cannot be segmented
+     */
+    bool createSegmentedJobs(std::vector<RenderJob> &jobs, const QDomDocument &doc, const QString &playlistPath, const QString &outputPath,
+                             const QString &subtitlePath);
+
     void addErrorMessage(const QString &error);
 };
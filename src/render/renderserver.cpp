@@ -34,11 +34,31 @@ void RenderServer::jobConnected()
 {
     QLocalSocket *socket = m_server.nextPendingConnection();
     connect(socket, &QLocalSocket::readyRead, this, &RenderServer::jobSent);
+    connect(socket, &QLocalSocket::disconnected, this, &RenderServer::jobDisconnected);
 }
 
 void RenderServer::jobSent()
+{
+    readJson(qobject_cast<QLocalSocket *>(sender()));
+}
+
+void RenderServer::jobDisconnected()
 {
     QLocalSocket *socket = qobject_cast<QLocalSocket *>(sender());
+    // Process pending messages, the job might have sent its status just before exiting
+    readJson(socket);
+    // Several jobs can run concurrently, a job that exited without reporting must not block its queue slot
+    const QStringList urls = m_jobSocket.keys(socket);
+    for (const QString &url : urls) {
+        qWarning() << "Render job exited without sending its status" << url;
+        Q_EMIT setRenderingFinished(url, -2, i18n("Render process exited unexpectedly"));
+        m_jobSocket.remove(url);
+    }
+    socket->deleteLater();
+}
+
+void RenderServer::readJson(QLocalSocket *socket)
+{
     QTextStream text(socket);
     QString block, line;
     while (text.readLineInto(&line)) {
@@ -29,8 +29,11 @@ private Q_SLOTS:
     void jobConnected();
     void handleJson(const QJsonObject &json, QLocalSocket *socket);
     void jobSent();
+    void jobDisconnected();
 
 private:
+    /** @brief Parse the complete json objects available on @param socket */
+    void readJson(QLocalSocket *socket);
     QLocalServer m_server;
     QHash<QString, QLocalSocket*> m_jobSocket;
 };
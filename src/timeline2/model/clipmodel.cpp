@@ -49,14 +49,32 @@ ClipModel::ClipModel(const std::shared_ptr<TimelineModel> &parent, std::shared_p
     } else {
         m_endlessResize = false;
     }
+    refreshRoleSnapshot();
     QObject::connect(m_effectStack.get(), &EffectStackModel::dataChanged, m_effectStack.get(),
                      [&](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) {
                          qDebug() << "// GOT CLIP STACK DATA CHANGE: " << roles;
+                         // The stack reports all the roles it might affect, only forward the cached ones that really changed
+                         QVector<int> changedRoles = refreshRoleSnapshot();
                          if (m_currentTrackId != -1) {
                              if (auto ptr = m_parent.lock()) {
+                                 if (roles.isEmpty()) {
+                                     changedRoles.clear();
+                                 } else {
+                                     for (int role : roles) {
+                                         if (!isSnapshotRole(role) && !changedRoles.contains(role)) {
+                                             changedRoles << role;
+                                         }
+                                     }
+                                     if (changedRoles.isEmpty()) {
+                                         return;
+                                     }
+                                 }
                                  QModelIndex ix = ptr->makeClipIndexFromID(m_id);
-                                 Q_EMIT ptr->dataChanged(ix, ix, roles);
-                                 qDebug() << "// GOT CLIP STACK DATA CHANGE DONE: " << ix << " = " << roles;
+                                 // The snapshot was just refreshed, TimelineItemModel::refreshRoleSnapshots must not do it again
+                                 m_forwardingStackChange = true;
+                                 Q_EMIT ptr->dataChanged(ix, ix, changedRoles);
+                                 m_forwardingStackChange = false;
+                                 qDebug() << "// GOT CLIP STACK DATA CHANGE DONE: " << ix << " = " << changedRoles;
                              }
                          }
                      });
@@ -718,7 +736,7 @@ std::shared_ptr<Mlt::Producer> ClipModel::getProducer()
 
 int ClipModel::getPlaytime() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return m_producer->get_playtime();
 }
 
@@ -926,6 +944,7 @@ void ClipModel::refreshProducerFromBin(int trackId, PlaylistState::ClipState sta
         m_producer->set("kdenlive:activeeffect", activeEffect);
     }
     m_endlessResize = !binClip->hasLimitedDuration();
+    refreshRoleSnapshot();
 }
 
 void ClipModel::refreshProducerFromBin(int trackId)
@@ -1523,6 +1542,111 @@ FileStatus::ClipStatus ClipModel::clipStatus() const
     return binClip->clipStatus();
 }
 
+ClipModel::RoleSnapshot ClipModel::roleSnapshot() const
+{
+    SHARED_READ_LOCK();
+    return m_roleSnapshot;
+}
+
+QVector<int> ClipModel::refreshRoleSnapshot()
+{
+    RoleSnapshot snapshot;
+    snapshot.name = clipName();
+    snapshot.service = getProperty(QStringLiteral("mlt_service"));
+    snapshot.resource = getProperty(QStringLiteral("resource"));
+    if (snapshot.resource == QLatin1String("<producer>")) {
+        snapshot.resource = snapshot.service;
+    }
+    snapshot.effectNames = effectNames();
+    // The timeline tags setting is applied when the role is read, so that toggling it does not require a refresh
+    snapshot.tag = pCore->projectItemModel()->getClipByBinID(m_binClipId)->tags();
+    snapshot.audioChannels = audioChannels();
+    snapshot.audioStream = audioStream();
+    snapshot.audioStreamIndex = audioStreamIndex();
+    snapshot.audioMultiStream = audioMultiStream();
+    snapshot.stackEnabled = stackEnabled();
+    snapshot.showKeyframes = showKeyframes();
+    snapshot.fadeIn = fadeIn();
+    snapshot.fadeOut = fadeOut();
+    snapshot.fadeInMethod = fadeMethod(true);
+    snapshot.fadeOutMethod = fadeMethod(false);
+
+    QWriteLocker locker(&m_lock);
+    QVector<int> roles;
+    const RoleSnapshot &previous = m_roleSnapshot;
+    if (snapshot.name != previous.name) {
+        roles << TimelineModel::NameRole;
+    }
+    if (snapshot.resource != previous.resource) {
+        roles << TimelineModel::ResourceRole;
+    }
+    if (snapshot.service != previous.service) {
+        roles << TimelineModel::ServiceRole;
+    }
+    if (snapshot.effectNames != previous.effectNames) {
+        roles << TimelineModel::EffectNamesRole;
+    }
+    if (snapshot.tag != previous.tag) {
+        roles << TimelineModel::TagRole;
+    }
+    if (snapshot.audioChannels != previous.audioChannels) {
+        roles << TimelineModel::AudioChannelsRole;
+    }
+    if (snapshot.audioStream != previous.audioStream) {
+        roles << TimelineModel::AudioStreamRole;
+    }
+    if (snapshot.audioStreamIndex != previous.audioStreamIndex) {
+        roles << TimelineModel::AudioStreamIndexRole;
+    }
+    if (snapshot.audioMultiStream != previous.audioMultiStream) {
+        roles << TimelineModel::AudioMultiStreamRole;
+    }
+    if (snapshot.stackEnabled != previous.stackEnabled) {
+        roles << TimelineModel::EffectsEnabledRole;
+    }
+    if (snapshot.showKeyframes != previous.showKeyframes) {
+        roles << TimelineModel::ShowKeyframesRole;
+    }
+    if (snapshot.fadeIn != previous.fadeIn) {
+        roles << TimelineModel::FadeInRole;
+    }
+    if (snapshot.fadeOut != previous.fadeOut) {
+        roles << TimelineModel::FadeOutRole;
+    }
+    if (snapshot.fadeInMethod != previous.fadeInMethod) {
+        roles << TimelineModel::FadeInMethodRole;
+    }
+    if (snapshot.fadeOutMethod != previous.fadeOutMethod) {
+        roles << TimelineModel::FadeOutMethodRole;
+    }
+    m_roleSnapshot = std::move(snapshot);
+    return roles;
+}
+
+bool ClipModel::isSnapshotRole(int role)
+{
+    switch (role) {
+    case TimelineModel::NameRole:
+    case TimelineModel::ResourceRole:
+    case TimelineModel::ServiceRole:
+    case TimelineModel::EffectNamesRole:
+    case TimelineModel::TagRole:
+    case TimelineModel::AudioChannelsRole:
+    case TimelineModel::AudioStreamRole:
+    case TimelineModel::AudioStreamIndexRole:
+    case TimelineModel::AudioMultiStreamRole:
+    case TimelineModel::EffectsEnabledRole:
+    case TimelineModel::ShowKeyframesRole:
+    case TimelineModel::FadeInRole:
+    case TimelineModel::FadeOutRole:
+    case TimelineModel::FadeInMethodRole:
+    case TimelineModel::FadeOutMethodRole:
+        return true;
+    default:
+        return false;
+    }
+}
+
 QString ClipModel::clipHash() const
 {
     QDomDocument document;
@@ -244,6 +244,33 @@ protected:
     /** @brief Returns the clip status (normal, proxied, missing, etc)  */
     FileStatus::ClipStatus clipStatus() const;
 
+    /** @brief Values of the timeline roles that are read from MLT properties, the bin clip or the effect stack.
+        They are cached so that the view can rebind its delegates without querying MLT */
+    struct RoleSnapshot
+    {
+        QString name;
+        QString resource;
+        QString service;
+        QString effectNames;
+        QString tag;
+        int audioChannels{0};
+        int audioStream{-1};
+        int audioStreamIndex{0};
+        bool audioMultiStream{false};
+        bool stackEnabled{true};
+        bool showKeyframes{true};
+        int fadeIn{0};
+        int fadeOut{0};
+        int fadeInMethod{0};
+        int fadeOutMethod{0};
+    };
+    /** @brief Returns a copy of the cached role values */
+    RoleSnapshot roleSnapshot() const;
+    /** @brief Read the cached role values again from MLT, returns the roles whose value changed */
+    QVector<int> refreshRoleSnapshot();
+    /** @brief Returns true if the value of this role is served from the role snapshot */
+    static bool isSnapshotRole(int role);
+
     /** @brief This is a debug function to ensure the clip is in a valid state */
     bool checkConsistency();
 
@@ -285,4 +312,8 @@ protected:
     int m_mixCutPos;
     /** @brief True if the clip has a timeremap effect */
     bool m_hasTimeRemap;
+    /** @brief Cached values of the roles queried by the timeline view */
+    RoleSnapshot m_roleSnapshot;
+    /** @brief True while a change of the effect stack is forwarded to the timeline, the snapshot is already up to date */
+    bool m_forwardingStackChange{false};
 };
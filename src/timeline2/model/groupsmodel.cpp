@@ -12,6 +12,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QModelIndex>
+#include <algorithm>
 #include <queue>
 #include <stack>
 #include <utility>
@@ -121,7 +122,7 @@ void GroupsModel::createGroupItem(int id)
     Q_ASSERT(m_upLink.count(id) == 0);
     Q_ASSERT(m_downLink.count(id) == 0);
     m_upLink[id] = -1;
-    m_downLink[id] = std::unordered_set<int>();
+    m_downLink[id] = std::vector<int>();
 }
 
 Fun GroupsModel::destructGroupItem_lambda(int id)
@@ -129,6 +130,7 @@ Fun GroupsModel::destructGroupItem_lambda(int id)
     QWriteLocker locker(&m_lock);
     return [this, id]() {
         removeFromGroup(id);
+        invalidateCaches(id);
         auto ptr = m_parent.lock();
         if (!ptr) Q_ASSERT(false);
         for (int child : m_downLink[id]) {
@@ -160,7 +162,7 @@ bool GroupsModel::destructGroupItem(int id, bool deleteOrphan, Fun &undo, Fun &r
     QWriteLocker locker(&m_lock);
     Q_ASSERT(m_upLink.count(id) > 0);
     int parent = m_upLink[id];
-    auto old_children = m_downLink[id];
+    std::unordered_set<int> old_children(m_downLink[id].begin(), m_downLink[id].end());
     auto old_type = getType(id);
     auto old_parent_type = GroupType::Normal;
     if (parent != -1) {
@@ -195,6 +197,17 @@ bool GroupsModel::destructGroupItem(int id)
 int GroupsModel::getRootId(int id) const
 {
     READ_LOCK();
+    Q_ASSERT(m_upLink.count(id) > 0);
+    if (m_upLink.at(id) == -1) {
+        return id;
+    }
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    auto cached = m_rootCache.find(id);
+    if (cached != m_rootCache.end()) {
+        return cached->second;
+    }
+    cacheLocker.unlock();
+    const int start = id;
     std::unordered_set<int> seen; // we store visited ids to detect cycles
     int father = -1;
     do {
@@ -206,6 +219,8 @@ int GroupsModel::getRootId(int id) const
             id = father;
         }
     } while (father != -1);
+    cacheLocker.relock();
+    m_rootCache[start] = id;
     return id;
 }
 
@@ -249,6 +264,15 @@ int GroupsModel::getSplitPartner(int id) const
 std::unordered_set<int> GroupsModel::getSubtree(int id) const
 {
     READ_LOCK();
+    if (m_downLink.at(id).empty()) {
+        return {id};
+    }
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    auto cached = m_subtreeCache.find(id);
+    if (cached != m_subtreeCache.end()) {
+        return cached->second;
+    }
+    cacheLocker.unlock();
     std::unordered_set<int> result;
     result.insert(id);
     std::queue<int> queue;
@@ -261,12 +285,23 @@ std::unordered_set<int> GroupsModel::getSubtree(int id) const
             queue.push(child);
         }
     }
+    cacheLocker.relock();
+    m_subtreeCache[id] = result;
     return result;
 }
 
 std::unordered_set<int> GroupsModel::getLeaves(int id) const
 {
     READ_LOCK();
+    if (m_downLink.at(id).empty()) {
+        return {id};
+    }
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    auto cached = m_leavesCache.find(id);
+    if (cached != m_leavesCache.end()) {
+        return cached->second;
+    }
+    cacheLocker.unlock();
     std::unordered_set<int> result;
     std::queue<int> queue;
     queue.push(id);
@@ -280,6 +315,8 @@ std::unordered_set<int> GroupsModel::getLeaves(int id) const
             result.insert(current);
         }
     }
+    cacheLocker.relock();
+    m_leavesCache[id] = result;
     return result;
 }
 
@@ -287,7 +324,8 @@ std::unordered_set<int> GroupsModel::getDirectChildren(int id) const
 {
     READ_LOCK();
     Q_ASSERT(m_downLink.count(id) > 0);
-    return m_downLink.at(id);
+    const std::vector<int> &children = m_downLink.at(id);
+    return std::unordered_set<int>(children.begin(), children.end());
 }
 int GroupsModel::getDirectAncestor(int id) const
 {
@@ -305,7 +343,8 @@ void GroupsModel::setGroup(int id, int groupId, bool changeState)
     removeFromGroup(id);
     m_upLink[id] = groupId;
     if (groupId != -1) {
-        m_downLink[groupId].insert(id);
+        m_downLink[groupId].push_back(id);
+        invalidateCaches(id);
         auto ptr = m_parent.lock();
         if (changeState && ptr) {
             QModelIndex ix;
@@ -326,6 +365,36 @@ void GroupsModel::setGroup(int id, int groupId, bool changeState)
     }
 }
 
+void GroupsModel::invalidateCaches(int id)
+{
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    if (m_rootCache.empty() && m_leavesCache.empty() && m_subtreeCache.empty()) {
+        return;
+    }
+    // Roots of the whole subtree are affected
+    std::queue<int> queue;
+    queue.push(id);
+    while (!queue.empty()) {
+        int current = queue.front();
+        queue.pop();
+        m_rootCache.erase(current);
+        auto children = m_downLink.find(current);
+        if (children != m_downLink.end()) {
+            for (int child : children->second) {
+                queue.push(child);
+            }
+        }
+    }
+    // Leaves and subtrees of all ancestors are affected
+    int current = id;
+    while (current != -1) {
+        m_leavesCache.erase(current);
+        m_subtreeCache.erase(current);
+        auto parent = m_upLink.find(current);
+        current = parent == m_upLink.end() ? -1 : parent->second;
+    }
+}
+
 QString GroupsModel::debugString()
 {
     QString string;
@@ -347,7 +416,14 @@ void GroupsModel::removeFromGroup(int id)
     int parent = m_upLink[id];
     if (parent != -1) {
         Q_ASSERT(getType(parent) != GroupType::Leaf);
-        m_downLink[parent].erase(id);
+        invalidateCaches(id);
+        std::vector<int> &siblings = m_downLink[parent];
+        auto it = std::find(siblings.begin(), siblings.end(), id);
+        if (it != siblings.end()) {
+            // Order of children is irrelevant, swap with last to avoid shifting the vector
+            *it = siblings.back();
+            siblings.pop_back();
+        }
         QModelIndex ix;
         auto ptr = m_parent.lock();
         if (!ptr) Q_ASSERT(false);
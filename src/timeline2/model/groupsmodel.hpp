@@ -7,10 +7,12 @@
 
 #include "definitions.h"
 #include "undohelper.hpp"
+#include <QMutex>
 #include <QReadWriteLock>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class TimelineItemModel;
 
@@ -222,10 +224,25 @@ private:
 
     /** @brief edges toward parent */
     std::unordered_map<int, int> m_upLink;
-    /** @brief edges toward children */
-    std::unordered_map<int, std::unordered_set<int>> m_downLink;
+    /** @brief edges toward children. Children are stored in flat vectors, which are much cheaper to iterate than node based sets */
+    std::unordered_map<int, std::vector<int>> m_downLink;
     /** @brief this keeps track of "real" groups (non-leaf elements), and their types */
     std::unordered_map<int, GroupType> m_groupIds;
     /** @brief This is a lock that ensures safety in case of concurrent access */
     mutable QReadWriteLock m_lock;
+
+    /** @brief Cached root of items, filled on query by getRootId */
+    mutable std::unordered_map<int, int> m_rootCache;
+    /** @brief Cached leaves of proper groups, filled on query by getLeaves */
+    mutable std::unordered_map<int, std::unordered_set<int>> m_leavesCache;
+    /** @brief Cached descendants of proper groups, filled on query by getSubtree */
+    mutable std::unordered_map<int, std::unordered_set<int>> m_subtreeCache;
+    /** @brief Protects the caches, which are also filled by concurrent readers */
+    mutable QMutex m_cacheMutex;
+    /** @brief Invalidate the cached data affected by a change of parent of the given item:
+       the roots of all the items of its subtree and the leaves and subtrees of all its ancestors (including itself).
+       Must be called while the item is still attached to the ancestors that should be invalidated.
+       @param id of the groupItem
+    */
+    void invalidateCaches(int id);
 };
@@ -8,6 +8,7 @@
 #include "timelinemodel.hpp"
 #include "undohelper.hpp"
 #include <QReadWriteLock>
+#include <atomic>
 #include <memory>
 
 /** @brief This is the base class for objects that can move, for example clips and compositions
@@ -74,8 +75,8 @@ public:
     /** @brief Set if the item is in grab state */
     bool isGrabbed() const;
 
-    /** @brief True if item is selected in timeline */
-    bool selected{false};
+    /** @brief True if item is selected in timeline. Atomic so that the views can read it without locking the model */
+    std::atomic_bool selected{false};
     /** @brief Set selected status */
     virtual void setSelected(bool sel) = 0;
     /** @brief The fake track is used in insert/overwrite mode.
@@ -21,7 +21,7 @@ MoveableItem<Service>::MoveableItem(std::weak_ptr<TimelineModel> parent, int id)
 
 template <typename Service> int MoveableItem<Service>::getId() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return m_id;
 }
 
@@ -36,19 +36,19 @@ template <typename Service> QUuid MoveableItem<Service>::getUuid() const
 
 template <typename Service> int MoveableItem<Service>::getCurrentTrackId() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return m_currentTrackId;
 }
 
 template <typename Service> int MoveableItem<Service>::getPosition() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return m_position;
 }
 
 template <typename Service> std::pair<int, int> MoveableItem<Service>::getInOut() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return {getIn(), getOut()};
 }
 
@@ -60,13 +60,13 @@ template <typename Service> int MoveableItem<Service>::assetRow(const QString &a
 
 template <typename Service> int MoveableItem<Service>::getIn() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return service()->get_in();
 }
 
 template <typename Service> int MoveableItem<Service>::getOut() const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     return service()->get_out();
 }
 
@@ -203,8 +203,8 @@ bool TimelineFunctions::processClipCut(const std::shared_ptr<TimelineItemModel>
 
     if (durationChanged) {
         // Track length changed, check project duration
-        Fun updateDuration = [timeline]() {
-            timeline->updateDuration();
+        Fun updateDuration = [timeline, trackId]() {
+            timeline->updateDuration(trackId);
             return true;
         };
         updateDuration();
@@ -54,6 +54,27 @@ void TimelineItemModel::finishConstruct(const std::shared_ptr<TimelineItemModel>
 {
     ptr->weak_this_ = ptr;
     ptr->m_groups = std::make_unique<GroupsModel>(ptr);
+    // Connected before any view, so that the clip role snapshots are up to date when the views query the changed roles
+    QObject::connect(ptr.get(), &TimelineItemModel::dataChanged, ptr.get(), &TimelineItemModel::refreshRoleSnapshots, Qt::DirectConnection);
+}
+
+void TimelineItemModel::refreshRoleSnapshots(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles)
+{
+    if (!roles.isEmpty() && std::none_of(roles.cbegin(), roles.cend(), &ClipModel::isSnapshotRole)) {
+        return;
+    }
+    READ_LOCK();
+    const QModelIndex parent = topLeft.parent();
+    if (!parent.isValid()) {
+        // Not a clip index
+        return;
+    }
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const int id = row == topLeft.row() ? int(topLeft.internalId()) : int(index(row, 0, parent).internalId());
+        if (isClip(id) && !m_allClips.at(id)->m_forwardingStackChange) {
+            m_allClips.at(id)->refreshRoleSnapshot();
+        }
+    }
 }
 
 std::shared_ptr<TimelineItemModel> TimelineItemModel::construct(const QUuid &uuid, std::weak_ptr<DocUndoStack> undo_stack)
@@ -322,6 +343,44 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
     if (isClip(id)) {
         // qDebug() << "REQUESTING DATA "<<roleNames()[role]<<index;
         std::shared_ptr<ClipModel> clip = m_allClips.at(id);
+        if (ClipModel::isSnapshotRole(role)) {
+            // These roles are read from MLT or the effect stack, serve the cached values
+            const ClipModel::RoleSnapshot snapshot = clip->roleSnapshot();
+            switch (role) {
+            case NameRole:
+                return snapshot.name;
+            case ResourceRole:
+                return snapshot.resource;
+            case ServiceRole:
+                return snapshot.service;
+            case EffectNamesRole:
+                return snapshot.effectNames;
+            case TagRole:
+                return KdenliveSettings::tagsintimeline() ? snapshot.tag : QString();
+            case AudioChannelsRole:
+                return snapshot.audioChannels;
+            case AudioStreamRole:
+                return snapshot.audioStream;
+            case AudioStreamIndexRole:
+                return snapshot.audioStreamIndex;
+            case AudioMultiStreamRole:
+                return snapshot.audioMultiStream;
+            case EffectsEnabledRole:
+                return snapshot.stackEnabled;
+            case ShowKeyframesRole:
+                return snapshot.showKeyframes;
+            case FadeInRole:
+                return snapshot.fadeIn;
+            case FadeOutRole:
+                return snapshot.fadeOut;
+            case FadeInMethodRole:
+                return snapshot.fadeInMethod;
+            case FadeOutMethodRole:
+                return snapshot.fadeOutMethod;
+            default:
+                break;
+            }
+        }
         // Get data for a clip
         switch (role) {
         // TODO
@@ -329,13 +388,6 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
         case Qt::DisplayRole: {
             return clip->clipName();
         }
-        case ResourceRole: {
-            QString result = clip->getProperty("resource");
-            if (result == QLatin1String("<producer>")) {
-                result = clip->getProperty("mlt_service");
-            }
-            return result;
-        }
         case StatusRole: {
             return clip->clipStatus();
         }
@@ -347,17 +399,6 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
             return clip->binId();
         case TrackIdRole:
             return clip->getCurrentTrackId();
-        case ServiceRole:
-            return clip->getProperty("mlt_service");
-            break;
-        case AudioChannelsRole:
-            return clip->audioChannels();
-        case AudioStreamRole:
-            return clip->audioStream();
-        case AudioMultiStreamRole:
-            return clip->audioMultiStream();
-        case AudioStreamIndexRole:
-            return clip->audioStreamIndex();
         case HasAudio:
             return clip->audioEnabled();
         case IsAudioRole:
@@ -384,24 +425,10 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
             return clip->getMaxDuration();
         case GroupedRole:
             return m_groups->isInGroup(id);
-        case EffectNamesRole:
-            return clip->effectNames();
-        case EffectsEnabledRole:
-            return clip->stackEnabled();
         case InPointRole:
             return clip->getIn();
         case OutPointRole:
             return clip->getOut();
-        case ShowKeyframesRole:
-            return clip->showKeyframes();
-        case FadeInRole:
-            return clip->fadeIn();
-        case FadeOutRole:
-            return clip->fadeOut();
-        case FadeInMethodRole:
-            return clip->fadeMethod(true);
-        case FadeOutMethodRole:
-            return clip->fadeMethod(false);
         case MixRole:
             return clip->getMixDuration();
         case MixCutRole:
@@ -417,9 +444,7 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
         case GrabbedRole:
             return clip->isGrabbed();
         case SelectedRole:
-            return clip->selected;
-        case TagRole:
-            return clip->clipTag();
+            return clip->selected.load();
         case TimeRemapRole:
             return clip->hasTimeRemap();
         default:
@@ -519,7 +544,7 @@ QVariant TimelineItemModel::data(const QModelIndex &index, int role) const
         case GrabbedRole:
             return compo->isGrabbed();
         case SelectedRole:
-            return compo->selected;
+            return compo->selected.load();
         default:
             break;
         }
@@ -563,6 +588,8 @@ void TimelineItemModel::setTrackProperty(int trackId, const QString &name, const
         roles.push_back(IsLockedRole);
     } else if (name == QLatin1String("hide")) {
         roles.push_back(IsDisabledRole);
+        // Hidden and muted tracks don't count in timeline duration
+        updateTrackEnd(trackId);
         if (!track->isAudioTrack() && !isLoading) {
             pCore->invalidateItem(ObjectId(KdenliveObjectType::TimelineTrack, trackId, m_uuid));
             pCore->refreshProjectMonitorOnce();
@@ -124,6 +124,10 @@ protected:
     /** @brief This is an helper function that finishes a construction of a freshly created TimelineItemModel */
     static void finishConstruct(const std::shared_ptr<TimelineItemModel> &ptr);
 
+private:
+    /** @brief Refresh the role snapshot of the clips in the changed range, if one of their cached roles is affected */
+    void refreshRoleSnapshots(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+
 Q_SIGNALS:
     /** @brief Triggered when a video track visibility changed */
     void trackVisibilityChanged();
@@ -34,6 +34,7 @@
 #include <QThread>
 #include <mlt++/MltConsumer.h>
 #include <mlt++/MltField.h>
+#include <mlt++/MltFilter.h>
 #include <mlt++/MltProfile.h>
 #include <mlt++/MltTractor.h>
 #include <mlt++/MltTransition.h>
@@ -289,7 +290,7 @@ int TimelineModel::getCompositionsCount() const
 
 int TimelineModel::getClipTrackId(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(m_allClips.count(clipId) > 0);
     const auto clip = m_allClips.at(clipId);
     return clip->getCurrentTrackId();
@@ -312,7 +313,7 @@ int TimelineModel::getCompositionTrackId(int compoId) const
 
 int TimelineModel::getItemTrackId(int itemId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(isItem(itemId));
     if (isClip(itemId)) {
         return getClipTrackId(itemId);
@@ -338,7 +339,7 @@ bool TimelineModel::hasClipEndMix(int clipId) const
 
 int TimelineModel::getClipPosition(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(m_allClips.count(clipId) > 0);
     const auto clip = m_allClips.at(clipId);
     int pos = clip->getPosition();
@@ -347,7 +348,7 @@ int TimelineModel::getClipPosition(int clipId) const
 
 int TimelineModel::getClipEnd(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(m_allClips.count(clipId) > 0);
     const auto clip = m_allClips.at(clipId);
     int pos = clip->getPosition() + clip->getPlaytime();
@@ -370,7 +371,7 @@ int TimelineModel::getClipSplitPartner(int clipId) const
 
 int TimelineModel::getClipIn(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(m_allClips.count(clipId) > 0);
     const auto clip = m_allClips.at(clipId);
     return clip->getIn();
@@ -378,7 +379,7 @@ int TimelineModel::getClipIn(int clipId) const
 
 QPoint TimelineModel::getClipInDuration(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(m_allClips.count(clipId) > 0);
     const auto clip = m_allClips.at(clipId);
     return {clip->getIn(), clip->getPlaytime()};
@@ -402,7 +403,7 @@ const QString TimelineModel::getClipBinId(int clipId) const
 
 int TimelineModel::getClipPlaytime(int clipId) const
 {
-    READ_LOCK();
+    SHARED_READ_LOCK();
     Q_ASSERT(isClip(clipId));
     const auto clip = m_allClips.at(clipId);
     int playtime = clip->getPlaytime();
@@ -2169,6 +2170,14 @@ bool TimelineModel::requestItemDeletion(int itemId, bool logUndo)
     }
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
+    // The deleted items are kept alive by the undo command
+    size_t memoryCost = 0;
+    const std::unordered_set<int> deletedItems = singleSelectOperation ? m_currentSelection : m_groups->getLeaves(m_groups->getRootId(itemId));
+    for (int id : deletedItems) {
+        memoryCost += itemMemoryCost(id);
+    }
+    // Only check timeline duration once all items are deleted
+    DurationBatch batch(this);
     bool res = true;
     if (singleSelectOperation) {
         // Ungroup all items first
@@ -2186,12 +2195,32 @@ bool TimelineModel::requestItemDeletion(int itemId, bool logUndo)
         res = requestItemDeletion(itemId, undo, redo, logUndo);
     }
     if (res && logUndo) {
-        PUSH_UNDO(undo, redo, actionLabel);
+        undo = durationBatch_lambda(undo);
+        redo = durationBatch_lambda(redo);
+        PUSH_UNDO_WITH_COST(undo, redo, actionLabel, memoryCost);
     }
     TRACE_RES(res);
     return res;
 }
 
+size_t TimelineModel::itemMemoryCost(int itemId) const
+{
+    size_t cost = 0;
+    if (isClip(itemId)) {
+        const std::shared_ptr<Mlt::Producer> &producer = m_allClips.at(itemId)->m_producer;
+        cost += AssetParameterModel::propertiesMemoryCost(*producer.get());
+        for (int i = 0; i < producer->filter_count(); ++i) {
+            std::unique_ptr<Mlt::Filter> filter(producer->filter(i));
+            if (filter && filter->is_valid()) {
+                cost += AssetParameterModel::propertiesMemoryCost(*filter.get());
+            }
+        }
+    } else if (isComposition(itemId)) {
+        cost += AssetParameterModel::propertiesMemoryCost(*m_allCompositions.at(itemId)->getAsset());
+    }
+    return cost;
+}
+
 std::pair<int, int> TimelineModel::extractSelectionFromGroup(int selection, Fun &undo, Fun &redo, bool onDeletion)
 {
     int gid = m_groups->getDirectAncestor(selection);
@@ -2810,7 +2839,8 @@ bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, i
 
     Fun update_model = [this, finalMove]() {
         if (finalMove) {
-            updateDuration();
+            // Track ends were updated by the moves, check duration only once
+            refreshDuration();
         }
         return true;
     };
@@ -2962,7 +2992,7 @@ bool TimelineModel::requestGroupMove(int itemId, int groupId, int delta_track, i
                 }
             }
             if (finalMove) {
-                updateDuration();
+                refreshDuration();
             }
             return true;
         };
@@ -3427,6 +3457,7 @@ int TimelineModel::requestClipResizeAndTimeWarp(int itemId, int size, bool right
     // size = requestItemResizeInfo(itemId, in, out, size, right, snapDistance);
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
+    DurationBatch batch(this);
     std::unordered_set<int> all_items;
     if (!allowSingleResize && m_groups->isInGroup(itemId)) {
         int groupId = m_groups->getRootId(itemId);
@@ -3491,13 +3522,13 @@ int TimelineModel::requestClipResizeAndTimeWarp(int itemId, int size, bool right
         } else {
             invalidateIn = qMin(invalidateIn, invalidateOut - getClipPlaytime(id));
         }
-        Fun view_redo = [this, invalidateIn, invalidateOut, hasVideo, durationChanged]() {
+        Fun view_redo = [this, invalidateIn, invalidateOut, hasVideo, durationChanged, tid]() {
             if (hasVideo) {
                 Q_EMIT invalidateZone(invalidateIn, invalidateOut);
             }
             if (durationChanged) {
                 // last clip in playlist updated
-                updateDuration();
+                updateDuration(tid);
             }
             return true;
         };
@@ -3509,6 +3540,8 @@ int TimelineModel::requestClipResizeAndTimeWarp(int itemId, int size, bool right
         bool undone = undo();
         Q_ASSERT(undone);
     } else {
+        undo = durationBatch_lambda(undo);
+        redo = durationBatch_lambda(redo);
         PUSH_UNDO(undo, redo, i18n("Resize clip speed"));
     }
     int res = result ? size : -1;
@@ -3702,6 +3735,8 @@ int TimelineModel::requestItemResize(int itemId, int size, bool right, bool logU
     }
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
+    // Only check timeline duration once all group items are resized
+    DurationBatch batch(this);
     Fun adjust_mix = []() { return true; };
     Fun sync_end_mix = []() { return true; };
     Fun sync_end_mix_undo = []() { return true; };
@@ -3963,6 +3998,8 @@ int TimelineModel::requestItemResize(int itemId, int size, bool right, bool logU
         bool undone = undo();
         Q_ASSERT(undone);
     } else if (logUndo) {
+        undo = durationBatch_lambda(undo);
+        redo = durationBatch_lambda(redo);
         if (isClip(itemId)) {
             adjust_mix();
             PUSH_LAMBDA(adjust_mix, redo);
@@ -4762,6 +4799,18 @@ bool TimelineModel::requestTrackDeletion(int trackId)
     TRACE(trackId);
     Fun undo = []() { return true; };
     Fun redo = []() { return true; };
+    // The deleted track and its items are kept alive by the undo command
+    size_t memoryCost = 0;
+    for (const auto &clip : m_allClips) {
+        if (clip.second->getCurrentTrackId() == trackId) {
+            memoryCost += itemMemoryCost(clip.first);
+        }
+    }
+    for (const auto &composition : m_allCompositions) {
+        if (composition.second->getCurrentTrackId() == trackId) {
+            memoryCost += itemMemoryCost(composition.first);
+        }
+    }
     bool result = requestTrackDeletion(trackId, undo, redo);
     if (result) {
         if (m_videoTarget == trackId) {
@@ -4770,7 +4819,7 @@ bool TimelineModel::requestTrackDeletion(int trackId)
         if (m_audioTarget.contains(trackId)) {
             m_audioTarget.remove(trackId);
         }
-        PUSH_UNDO(undo, redo, i18n("Delete Track"));
+        PUSH_UNDO_WITH_COST(undo, redo, i18n("Delete Track"), memoryCost);
     }
     TRACE_RES(result);
     return result;
@@ -4915,6 +4964,7 @@ void TimelineModel::registerTrack(std::shared_ptr<TrackModel> track, int pos, bo
     Q_ASSERT(m_iteratorTable.count(id) == 0); // check that id is not used (shouldn't happen)
     m_iteratorTable[id] = it;
     endInsertRows();
+    updateTrackEnd(id);
     int cache = int(QThread::idealThreadCount()) + int(m_allTracks.size() + 1) * 2;
     mlt_service_cache_set_size(nullptr, "producer_avformat", qMax(4, cache));
 }
@@ -4953,6 +5003,11 @@ Fun TimelineModel::deregisterTrack_lambda(int id)
         m_allTracks.erase(it);
         // clean table
         m_iteratorTable.erase(id);
+        auto trackEnd = m_trackEnds.find(id);
+        if (trackEnd != m_trackEnds.end()) {
+            m_sortedTrackEnds.erase(m_sortedTrackEnds.find(trackEnd->second));
+            m_trackEnds.erase(trackEnd);
+        }
         if (!m_closing) {
             // Finish operation
             endRemoveRows();
@@ -5188,25 +5243,59 @@ void TimelineModel::limitBlackTrack(bool limit)
     m_blackClip->unlock();
 }
 
-void TimelineModel::updateDuration()
+void TimelineModel::updateDuration(int trackId)
 {
     if (m_closing) {
         return;
     }
+    if (trackId == -1) {
+        // Recompute all track ends
+        m_trackEnds.clear();
+        m_sortedTrackEnds.clear();
+        for (const auto &tck : m_iteratorTable) {
+            updateTrackEnd(tck.first);
+        }
+    } else {
+        updateTrackEnd(trackId);
+    }
+    refreshDuration();
+}
 
-    int current = m_blackClip->get_playtime() - TimelineModel::seekDuration - 1;
-    int duration = 0;
-    for (const auto &tck : m_iteratorTable) {
-        auto track = (*tck.second);
-        if (track->isAudioTrack()) {
-            if (track->isMute()) {
-                continue;
-            }
-        } else if (track->isHidden()) {
-            continue;
+void TimelineModel::updateTrackEnd(int trackId)
+{
+    int end = 0;
+    auto tck = m_iteratorTable.find(trackId);
+    if (tck != m_iteratorTable.end()) {
+        auto track = (*tck->second);
+        if (track->isAudioTrack() ? !track->isMute() : !track->isHidden()) {
+            end = track->trackDuration();
+        }
+    }
+    auto it = m_trackEnds.find(trackId);
+    if (it != m_trackEnds.end()) {
+        if (it->second == end) {
+            return;
         }
-        duration = qMax(duration, track->trackDuration());
+        m_sortedTrackEnds.erase(m_sortedTrackEnds.find(it->second));
+        it->second = end;
+    } else {
+        m_trackEnds[trackId] = end;
+    }
+    m_sortedTrackEnds.insert(end);
+}
+
+void TimelineModel::refreshDuration()
+{
+    if (m_closing) {
+        return;
     }
+    if (m_durationBatch > 0) {
+        m_durationPending = true;
+        return;
+    }
+    m_durationPending = false;
+    int current = m_blackClip->get_playtime() - TimelineModel::seekDuration - 1;
+    int duration = m_sortedTrackEnds.empty() ? 0 : *m_sortedTrackEnds.rbegin();
     if (m_subtitleModel) {
         duration = qMax(duration, m_subtitleModel->trackDuration());
     }
@@ -5235,6 +5324,27 @@ void TimelineModel::updateDuration()
     }
 }
 
+TimelineModel::DurationBatch::DurationBatch(TimelineModel *model)
+    : m_model(model)
+{
+    m_model->m_durationBatch++;
+}
+
+TimelineModel::DurationBatch::~DurationBatch()
+{
+    if (--m_model->m_durationBatch == 0 && m_model->m_durationPending) {
+        m_model->refreshDuration();
+    }
+}
+
+Fun TimelineModel::durationBatch_lambda(const Fun &operation)
+{
+    return [this, operation]() {
+        DurationBatch batch(this);
+        return operation();
+    };
+}
+
 int TimelineModel::duration() const
 {
     std::pair<int, int> d = durations();
@@ -15,6 +15,7 @@
 #include <memory>
 #include <mlt++/MltTractor.h>
 
+#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -562,6 +563,9 @@ public:
     Q_INVOKABLE bool requestItemDeletion(int itemId, bool logUndo = true);
     /* Same function, but accumulates undo and redo*/
     bool requestItemDeletion(int itemId, Fun &undo, Fun &redo, bool logUndo = false);
+    /** @brief Returns the estimated memory of the producer, effects or parameters of the item @param itemId, in bytes.
+        Used to declare the size of the state captured by the undo command of a deletion */
+    size_t itemMemoryCost(int itemId) const;
 
     /** @brief Move a group to a specific position
        This action is undoable
@@ -1003,8 +1007,31 @@ protected:
     bool requestCompositionDeletion(int compositionId, Fun &undo, Fun &redo);
     bool requestSubtitleDeletion(int clipId, Fun &undo, Fun &redo, bool first, bool last);
 
-    /** @brief Check tracks duration and update black track accordingly */
-    void updateDuration();
+    /** @brief Check tracks duration and update black track accordingly.
+        @param trackId the track whose length changed, only its cached end is refreshed. If -1, all track ends are recomputed
+     */
+    void updateDuration(int trackId = -1);
+    /** @brief Refresh the cached end position of a track, without checking the timeline duration */
+    void updateTrackEnd(int trackId);
+    /** @brief Compute the timeline duration from the cached track ends and update black track if it changed.
+        If a duration batch is running, the check is delayed until the batch ends */
+    void refreshDuration();
+    /** @brief Returns a lambda executing @param operation inside a duration batch, so that the duration is only checked once */
+    Fun durationBatch_lambda(const Fun &operation);
+
+    /** @class DurationBatch
+        @brief While an instance of this class exists, duration changes are not notified. The duration is checked once
+        when the last batch is destroyed. This is used to avoid updating the black track and sequence clip for each clip of a group operation.
+     */
+    class DurationBatch
+    {
+    public:
+        explicit DurationBatch(TimelineModel *model);
+        ~DurationBatch();
+
+    private:
+        TimelineModel *m_model;
+    };
 
     /** @brief Attempt to make a clip move without ever updating the view */
     bool requestClipMoveAttempt(int clipId, int trackId, int position);
@@ -1104,6 +1131,14 @@ protected:
     TimelineMode::EditMode m_editMode;
     bool m_closing;
     bool m_softDelete;
+    /** @brief The cached end position of each track, 0 for hidden or muted tracks */
+    std::unordered_map<int, int> m_trackEnds;
+    /** @brief All cached track ends, sorted so that the timeline length is the last element */
+    std::multiset<int> m_sortedTrackEnds;
+    /** @brief Number of running duration batches */
+    int m_durationBatch{0};
+    /** @brief True if a duration check was requested during a batch */
+    bool m_durationPending{false};
     std::shared_ptr<MarkerSortModel> m_guidesFilterModel;
     std::shared_ptr<MarkerListModel> m_guidesModel;
     QString m_visibleSequenceName;
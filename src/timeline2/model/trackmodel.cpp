@@ -260,7 +260,9 @@ Fun TrackModel::requestClipInsertion_lambda(int clipId, int position, bool updat
                 m_playlists[target_playlist].unlock();
                 field->unblock();
                 if (finalMove && !groupMove) {
-                    ptr->updateDuration();
+                    ptr->updateDuration(m_id);
+                } else {
+                    ptr->updateTrackEnd(m_id);
                 }
                 return index != -1 && end_function(target_playlist);
             }
@@ -448,9 +450,13 @@ Fun TrackModel::requestClipDeletion_lambda(int clipId, bool updateView, bool fin
                     if (!audioOnly && !isAudioTrack()) {
                         Q_EMIT ptr->invalidateZone(old_in, old_out);
                     }
-                    if (!groupMove && target_clip >= m_playlists[target_track].count()) {
-                        // deleted last clip in playlist
-                        ptr->updateDuration();
+                }
+                if (!ptr->m_closing && target_clip >= m_playlists[target_track].count()) {
+                    // deleted last clip in playlist
+                    if (finalMove && !groupMove) {
+                        ptr->updateDuration(m_id);
+                    } else {
+                        ptr->updateTrackEnd(m_id);
                     }
                 }
                 if (!audioOnly && !isHidden() && !isAudioTrack()) {
@@ -717,10 +723,14 @@ Fun TrackModel::requestClipResize_lambda(int clipId, int in, int out, bool right
             m_playlists[target_track].unlock();
             if (err == 0) {
                 update_snaps(m_allClips[clipId]->getPosition(), m_allClips[clipId]->getPosition() + out - in + 1);
-                if (right && finalMove && m_playlists[target_track].count() - 1 == target_clip_mutable) {
+                if (right && m_playlists[target_track].count() - 1 == target_clip_mutable) {
                     // deleted last clip in playlist
                     if (auto ptr = m_parent.lock()) {
-                        ptr->updateDuration();
+                        if (finalMove) {
+                            ptr->updateDuration(m_id);
+                        } else {
+                            ptr->updateTrackEnd(m_id);
+                        }
                     }
                 }
             }
@@ -755,10 +765,14 @@ Fun TrackModel::requestClipResize_lambda(int clipId, int in, int out, bool right
                     update_snaps(m_allClips[clipId]->getPosition(), m_allClips[clipId]->getPosition() + out - in + 1);
                 }
                 m_playlists[target_track].consolidate_blanks();
-                if (finalMove && m_playlists[target_track].count() - 1 == target_clip) {
+                if (m_playlists[target_track].count() - 1 == target_clip) {
                     // Resized last clip in playlist
                     if (auto ptr = m_parent.lock()) {
-                        ptr->updateDuration();
+                        if (finalMove) {
+                            ptr->updateDuration(m_id);
+                        } else {
+                            ptr->updateTrackEnd(m_id);
+                        }
                     }
                 }
                 return err == 0;
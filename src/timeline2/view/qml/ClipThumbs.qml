@@ -18,6 +18,16 @@ Row {
     property bool fixedThumbs: clipRoot.itemType === ProducerType.Image || clipRoot.itemType === ProducerType.Text || clipRoot.itemType === ProducerType.TextTemplate
     property int thumbWidth: container.height * root.dar
     property bool enableCache: clipRoot.itemType === ProducerType.Video || clipRoot.itemType === ProducerType.AV
+    // In all frames mode, only the thumbnails around the visible area are created, and they are reused while scrolling
+    property bool allFrames: parentTrack.trackThumbsFormat === 1
+    property int totalThumbs: allFrames ? Math.ceil(width / thumbWidth) : thumbRepeater.count
+    property int thumbOffset: allFrames ? Math.max(0, Math.min(totalThumbs - thumbRepeater.count, Math.floor(clipRoot.scrollStart / thumbRepeater.imageWidth) - 1)) : 0
+
+    Item {
+        // Placeholder item for the thumbnails before the visible area
+        width: thumbRow.thumbOffset * thumbRepeater.imageWidth
+        height: thumbRow.height
+    }
 
     Repeater {
         id: thumbRepeater
@@ -34,8 +44,8 @@ Row {
                        break;
                    case 1:
                        // All frames
-                       // display as many thumbnails as can fit into the container
-                       Math.ceil(parent.width / thumbRow.thumbWidth)
+                       // display as many thumbnails as can fit into the visible part of the container
+                       Math.min(thumbRow.totalThumbs, Math.ceil(scrollView.width / thumbRow.thumbWidth) + 2)
                        break;
                    case 2:
                        // In frame only
@@ -48,7 +58,7 @@ Row {
                }
         property int startFrame: clipRoot.inPoint
         property int endFrame: clipRoot.outPoint
-        property real imageWidth: Math.max(thumbRow.thumbWidth, parent.width / thumbRepeater.count)
+        property real imageWidth: Math.max(thumbRow.thumbWidth, parent.width / thumbRow.totalThumbs)
         property int thumbStartFrame: fixedThumbs ? 0 :
                                                     (clipRoot.speed >= 0)
                                                     ? Math.round(clipRoot.inPoint * thumbRow.initialSpeed)
@@ -59,6 +69,7 @@ Row {
                                                   : Math.round((clipRoot.maxDuration - clipRoot.outPoint) * -thumbRow.initialSpeed - 1)
 
         Image {
+            property int thumbIndex: index + thumbRow.thumbOffset
             width: thumbRepeater.imageWidth
             height: container.height
             fillMode: Image.PreserveAspectFit
@@ -70,23 +81,25 @@ Row {
                                        ? 0
                                        : thumbRepeater.count < 3
                                          ? (index == 0 ? thumbRepeater.thumbStartFrame : thumbRepeater.thumbEndFrame)
-                                         : Math.floor(clipRoot.inPoint * thumbRow.initialSpeed + Math.round((index) * width / timeline.scaleFactor)* clipRoot.speed)
+                                         : Math.floor(clipRoot.inPoint * thumbRow.initialSpeed + Math.round((thumbIndex) * width / timeline.scaleFactor)* clipRoot.speed)
             horizontalAlignment: thumbRepeater.count < 3
                                  ? (index == 0 ? Image.AlignLeft : Image.AlignRight)
                                  : Image.AlignLeft
             source: thumbRepeater.count < 3
                     ? (clipRoot.baseThumbPath + currentFrame)
-                    : (index * width < clipRoot.scrollStart - width || index * width > clipRoot.scrollStart + scrollView.width) ? '' : clipRoot.baseThumbPath + currentFrame
+                    : (thumbIndex * width < clipRoot.scrollStart - width || thumbIndex * width > clipRoot.scrollStart + scrollView.width) ? '' : clipRoot.baseThumbPath + currentFrame + frameTolerance
+            // Any frame covered by this thumbnail can be displayed, allowing to use the nearest keyframe of the clip
+            property string frameTolerance: (fixedThumbs || thumbIndex == 0) ? '' : '~' + Math.floor(width / timeline.scaleFactor * Math.abs(clipRoot.speed) / 2)
             onStatusChanged: {
-                if (status === Image.Ready && (index == 0  || index == thumbRepeater.count - 1)) {
+                if (status === Image.Ready && (thumbIndex == 0  || thumbIndex == thumbRow.totalThumbs - 1)) {
                     thumbPlaceholder.source = source
                 }
             }
             Image {
                 id: thumbPlaceholder
-                visible: parent.status != Image.Ready && (index == 0  || index == thumbRepeater.count - 1)
+                visible: parent.status != Image.Ready && (thumbIndex == 0  || thumbIndex == thumbRow.totalThumbs - 1)
                 anchors.left: parent.left
-                anchors.leftMargin: index < thumbRepeater.count - 1 ? 0 : parent.width - thumbRow.thumbWidth - 1
+                anchors.leftMargin: thumbIndex < thumbRow.totalThumbs - 1 ? 0 : parent.width - thumbRow.thumbWidth - 1
                 width: parent.width
                 height: parent.height
                 horizontalAlignment: Image.AlignLeft
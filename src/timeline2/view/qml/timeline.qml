@@ -519,7 +519,7 @@ Rectangle {
     readonly property int defaultDeltasPerStep: 120
     property bool seekingFinished : proxy ? proxy.seekFinished : true
     property int scrollMin: scrollView.contentX / root.timeScale
-    property int scrollMax: scrollMin + scrollView.contentItem.width / root.timeScale
+    property int scrollMax: scrollMin + scrollView.width / root.timeScale
     property double dar: 16/9
     property bool paletteUnchanged: true
     property int maxLabelWidth: 20 * root.baseUnit * Math.sqrt(root.timeScale)
@@ -568,6 +568,15 @@ Rectangle {
 
     //onCurrentTrackChanged: timeline.selection = []
 
+    // Only the items around the visible area get a delegate
+    function updateVisibleRange() {
+        if (multitrack) {
+            multitrack.setVisibleRange(root.scrollMin, root.scrollMax)
+        }
+    }
+    onScrollMinChanged: updateVisibleRange()
+    onScrollMaxChanged: updateVisibleRange()
+
     onTimeScaleChanged: {
         if (timeline.fullDuration * root.timeScale < scrollView.width) {
             scrollView.contentX = 0
@@ -10,6 +10,7 @@
 #include "bin/projectitemmodel.h"
 #include "core.h"
 #include "doc/kthumb.h"
+#include "jobs/keyframeindex/keyframeindex.h"
 #include "utils/thumbnailcache.hpp"
 
 #include <QCryptographicHash>
@@ -27,10 +28,12 @@ ThumbnailProvider::~ThumbnailProvider() = default;
 QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
     QImage result;
-    // id is binID/#frameNumber
+    // id is binID/#frameNumber, optionally followed by ~tolerance
     QString binId = id.section('/', 0, 0);
     bool ok;
-    int frameNumber = id.section('#', -1).toInt(&ok);
+    const QString position = id.section('#', -1);
+    int frameNumber = position.section('~', 0, 0).toInt(&ok);
+    const int tolerance = position.section('~', 1, 1).toInt();
     if (ok) {
         std::shared_ptr<ProjectClip> binClip = pCore->projectItemModel()->getClipByBinID(binId);
         if (binClip) {
@@ -39,6 +42,15 @@ QImage ThumbnailProvider::requestImage(const QString &id, QSize *size, const QSi
                 // for endless loopable clips, we rewrite the position
                 frameNumber = frameNumber - ((frameNumber / duration) * duration);
             }
+            if (tolerance > 0 && !binClip->hasProxy()) {
+                // Use the nearest keyframe if it is close enough, it is much faster to decode on long GOP clips
+                if (const auto index = binClip->keyframeIndex()) {
+                    const int keyframe = index->nearestKeyframe(frameNumber);
+                    if (qAbs(keyframe - frameNumber) <= tolerance) {
+                        frameNumber = keyframe;
+                    }
+                }
+            }
             result = ThumbnailCache::get()->getThumbnail(binClip->hashForThumbs(), binId, frameNumber);
             if (!result.isNull()) {
 
@@ -132,6 +132,9 @@ void TimelineController::setModel(std::shared_ptr<TimelineItemModel> model)
     connect(this, &TimelineController::videoTargetChanged, this, &TimelineController::updateVideoTarget);
     connect(this, &TimelineController::audioTargetChanged, this, &TimelineController::updateAudioTarget);
     connect(m_model.get(), &TimelineItemModel::requestMonitorRefresh, [&]() { pCore->refreshProjectMonitorOnce(true); });
+    connect(
+        m_model.get(), &TimelineModel::invalidateZone, this,
+        [this](int in, int out) { pCore->monitorManager()->projectMonitor()->invalidateFrameCache(m_model->uuid(), in, out); }, Qt::DirectConnection);
     connect(m_model.get(), &TimelineModel::durationUpdated, this, &TimelineController::checkDuration);
     connect(m_model.get(), &TimelineModel::selectionChanged, this, &TimelineController::selectionChanged);
     connect(m_model.get(), &TimelineModel::selectedMixChanged, this, &TimelineController::showMixModel);
@@ -2191,6 +2194,7 @@ bool TimelineController::createSplitOverlay(int clipId, std::shared_ptr<Mlt::Fil
         initializePreview();
     }
     m_model->setOverlayTrack(overlay);
+    invalidateFrameCache();
     return true;
 }
 
@@ -2201,6 +2205,7 @@ void TimelineController::removeSplitOverlay()
     }
     // disconnect
     m_model->removeOverlayTrack();
+    invalidateFrameCache();
 }
 
 int TimelineController::requestItemRippleResize(int itemId, int size, bool right, bool logUndo, int snapDistance, bool allowSingleResize)
@@ -2774,7 +2779,7 @@ void TimelineController::removeTrackClips(int trackId, int frame)
 
 void TimelineController::invalidateItem(int cid)
 {
-    if (!m_model->hasTimelinePreview() || !m_model->isItem(cid)) {
+    if (!m_model->isItem(cid)) {
         return;
     }
     const int tid = m_model->getItemTrackId(cid);
@@ -2783,12 +2788,13 @@ void TimelineController::invalidateItem(int cid)
     }
     int start = m_model->getItemPosition(cid);
     int end = start + m_model->getItemPlaytime(cid);
-    m_model->previewManager()->invalidatePreview(start, end);
+    // Reaches the timeline preview and the project monitor frame cache
+    Q_EMIT m_model->invalidateZone(start, end);
 }
 
 void TimelineController::invalidateTrack(int tid)
 {
-    if (!m_model->hasTimelinePreview() || !m_model->isTrack(tid) || m_model->getTrackById_const(tid)->isAudioTrack()) {
+    if (!m_model->isTrack(tid) || m_model->getTrackById_const(tid)->isAudioTrack()) {
         return;
     }
     for (const auto &clp : m_model->getTrackById_const(tid)->m_allClips) {
@@ -2796,6 +2802,11 @@ void TimelineController::invalidateTrack(int tid)
     }
 }
 
+void TimelineController::invalidateFrameCache()
+{
+    pCore->monitorManager()->projectMonitor()->invalidateFrameCache(m_model->uuid(), 0, -1);
+}
+
 void TimelineController::remapItemTime(int clipId)
 {
     if (clipId == -1) {
@@ -4485,6 +4496,7 @@ bool TimelineController::exists(int itemId)
 void TimelineController::slotMultitrackView(bool enable, bool refresh)
 {
     QStringList trackNames = TimelineFunctions::enableMultitrackView(m_model, enable, refresh);
+    invalidateFrameCache();
     if (!refresh) {
         // This is just a temporary state (disable multitrack view for playlist save, don't change scene
         return;
@@ -4531,6 +4543,7 @@ void TimelineController::slotMultitrackView(bool enable, bool refresh)
 void TimelineController::updateMultiTrack()
 {
     QStringList trackNames = TimelineFunctions::enableMultitrackView(m_model, true, true);
+    invalidateFrameCache();
     pCore->monitorManager()->projectMonitor()->slotShowEffectScene(MonitorSplitTrack, false, QVariant(trackNames));
 }
 
@@ -819,6 +819,8 @@ private:
     int getMenuOrTimelinePos() const;
     /** @brief Prepare the preview manager */
     void connectPreviewManager();
+    /** @brief Discard all the frames cached by the project monitor, required when the tractor composition changes without a timeline edit */
+    void invalidateFrameCache();
 
 Q_SIGNALS:
     void selectionChanged();
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "timelineviewportmodel.h"
+#include "timeline2/model/timelinemodel.hpp"
+
+#include <algorithm>
+
+TimelineViewportModel::TimelineViewportModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    // Clips are filtered again when their position changes
+    setDynamicSortFilter(true);
+}
+
+void TimelineViewportModel::setVisibleRange(int start, int end)
+{
+    if (end < start) {
+        return;
+    }
+    // Keep one view width on each side, so that scrolling does not immediately require new delegates
+    const int margin = std::max(1, end - start);
+    if (m_rangeEnd >= m_rangeStart && start >= m_rangeStart && end <= m_rangeEnd && m_rangeEnd - m_rangeStart <= 6 * margin) {
+        // Still inside the margin, and the view was not zoomed in, nothing to do
+        return;
+    }
+    m_rangeStart = std::max(0, start - margin);
+    m_rangeEnd = end + margin;
+    invalidateRowsFilter();
+}
+
+bool TimelineViewportModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!sourceParent.isValid() || m_rangeEnd < m_rangeStart) {
+        // Tracks are always displayed
+        return true;
+    }
+    const QModelIndex ix = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (sourceModel()->data(ix, TimelineModel::SelectedRole).toBool() || sourceModel()->data(ix, TimelineModel::GrabbedRole).toBool()) {
+        return true;
+    }
+    const int start = sourceModel()->data(ix, TimelineModel::StartRole).toInt();
+    const int duration = sourceModel()->data(ix, TimelineModel::DurationRole).toInt();
+    return start <= m_rangeEnd && start + duration >= m_rangeStart;
+}
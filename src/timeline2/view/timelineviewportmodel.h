@@ -0,0 +1,34 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QSortFilterProxyModel>
+
+/** @class TimelineViewportModel
+    @brief Proxy between the timeline model and the QML view. It sorts the tracks, and only lets through the clips and compositions
+    that intersect the visible part of the timeline (plus a margin), so that the view does not create delegates for items that are off screen.
+    Selected and grabbed items are always accepted, so that an ongoing operation never loses its delegate.
+ */
+class TimelineViewportModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit TimelineViewportModel(QObject *parent = nullptr);
+
+    /** @brief Set the frame range currently displayed by the view.
+        The filter is only updated when the range leaves the area covered by the margin, so that small scrolls do not create or destroy delegates */
+    Q_INVOKABLE void setVisibleRange(int start, int end);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    /** @brief First and last frame of the accepted range, including the margin. An empty range accepts everything */
+    int m_rangeStart{0};
+    int m_rangeEnd{-1};
+};
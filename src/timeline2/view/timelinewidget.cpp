@@ -21,6 +21,7 @@
 #include "profiles/profilemodel.hpp"
 #include "qml/timelineitems.h"
 #include "qmltypes/thumbnailprovider.h"
+#include "timelineviewportmodel.h"
 #include "timelinewidget.h"
 #include "utils/clipboardproxy.hpp"
 
@@ -32,7 +33,6 @@
 #include <QQmlContext>
 #include <QQmlEngine>
 #include <QQuickItem>
-#include <QSortFilterProxyModel>
 #include <QUuid>
 
 const int TimelineWidget::comboScale[] = {1, 2, 4, 8, 15, 30, 50, 75, 100, 150, 200, 300, 500, 800, 1000, 1500, 2000, 3000, 6000, 15000, 30000};
@@ -46,7 +46,7 @@ TimelineWidget::TimelineWidget(const QUuid uuid, QWidget *parent)
     engine()->rootContext()->setContextObject(new KLocalizedContext(this));
     setClearColor(palette().window().color());
     registerTimelineItems();
-    m_sortModel = std::make_unique<QSortFilterProxyModel>(this);
+    m_sortModel = std::make_unique<TimelineViewportModel>(this);
     setResizeMode(QQuickWidget::SizeRootObjectToView);
     setVisible(false);
     setFont(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont));
@@ -173,6 +173,8 @@ void TimelineWidget::setModel(const std::shared_ptr<TimelineItemModel> &model, M
     m_sortModel->setSortRole(TimelineItemModel::SortRole);
     m_sortModel->sort(0, Qt::DescendingOrder);
     timelineController.setModel(model);
+    // Until the view reports its scroll position, only create the delegates of the timeline start
+    m_sortModel->setVisibleRange(0, int(width() / std::max(0.01, timelineController.scaleFactor())));
     m_audioRec = pCore->getAudioDevice();
     QList<QQmlContext::PropertyPair> propertyList = {{"controller", QVariant::fromValue(model.get())},
                                                      {"multitrack", QVariant::fromValue(m_sortModel.get())},
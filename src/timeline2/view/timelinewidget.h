@@ -10,7 +10,7 @@
 #include <QQuickWidget>
 
 class ThumbnailProvider;
-class QSortFilterProxyModel;
+class TimelineViewportModel;
 class MonitorProxy;
 class MediaCapture;
 class QMenu;
@@ -102,7 +102,7 @@ private:
     QAction *m_editGuideAcion;
     QMenu *m_timelineSubtitleClipMenu;
     static const int comboScale[];
-    std::unique_ptr<QSortFilterProxyModel> m_sortModel;
+    std::unique_ptr<TimelineViewportModel> m_sortModel;
     /** @brief Keep last scale before fit to restore it on second click */
     double m_prevScale;
     /** @brief Keep last scroll position before fit to restore it on second click */
@@ -7,16 +7,92 @@
 #ifdef CRASH_AUTO_TEST
 #include "logger.hpp"
 #endif
+#include "kdenlivesettings.h"
+#include <KLocalizedString>
 #include <QDebug>
 #include <QTime>
 #include <utility>
+
+// Estimated memory captured by the undo and redo lambdas of an operation, they usually hold a few ids, positions and shared pointers per modified item.
+// Operations capturing large data (xml, producers, parameter values) declare its size with addMemoryCost
+static const size_t operationCostEstimate = 4096;
+
 FunctionalUndoCommand::FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent)
     : QUndoCommand(parent)
     , m_undo(std::move(undo))
     , m_redo(std::move(redo))
     , m_undone(false)
+    , m_name(text)
+    , m_stamp(QTime::currentTime())
+    , m_cost(sizeof(FunctionalUndoCommand) + operationCostEstimate + size_t(text.size()) * sizeof(QChar))
+    , m_mergeable(false)
+    , m_mergeTarget(nullptr)
+    , m_mergeKey(0)
+{
+    setText(QStringLiteral("%1 %2").arg(m_stamp.toString("hh:mm")).arg(text));
+}
+
+int FunctionalUndoCommand::id() const
+{
+    return m_mergeable ? 10 : -1;
+}
+
+void FunctionalUndoCommand::setMergeable(bool mergeable, const void *target, qint64 key)
+{
+    m_mergeable = mergeable;
+    m_mergeTarget = target;
+    m_mergeKey = key;
+}
+
+bool FunctionalUndoCommand::mergeWith(const QUndoCommand *other)
+{
+    const int interval = KdenliveSettings::undomergeinterval();
+    if (interval <= 0 || other->id() != id() || childCount() > 0 || other->childCount() > 0 || m_cost == 0) {
+        return false;
+    }
+    auto *command = static_cast<const FunctionalUndoCommand *>(other);
+    const int elapsed = m_stamp.msecsTo(command->m_stamp);
+    if (command->m_name != m_name || command->m_mergeTarget != m_mergeTarget || command->m_mergeKey != m_mergeKey || command->m_cost == 0 || elapsed < 0 || elapsed > interval) {
+        return false;
+    }
+    // The other command was done after this one: it must be undone first and redone last
+    Fun undo = m_undo;
+    Fun redo = m_redo;
+    Fun otherUndo = command->m_undo;
+    Fun otherRedo = command->m_redo;
+    m_undo = [undo, otherUndo]() {
+        bool v = otherUndo();
+        return undo() && v;
+    };
+    m_redo = [redo, otherRedo]() {
+        bool v = redo();
+        return otherRedo() && v;
+    };
+    m_stamp = command->m_stamp;
+    m_cost += command->m_cost;
+    setText(command->text());
+    return true;
+}
+
+size_t FunctionalUndoCommand::memoryCost() const
+{
+    return m_cost;
+}
+
+void FunctionalUndoCommand::addMemoryCost(size_t bytes)
+{
+    m_cost += bytes;
+}
+
+void FunctionalUndoCommand::discard()
 {
-    setText(QStringLiteral("%1 %2").arg(QTime::currentTime().toString("hh:mm")).arg(text));
+    m_undo = []() { return true; };
+    m_redo = []() { return true; };
+    m_cost = 0;
+    m_mergeable = false;
+    m_mergeTarget = nullptr;
+    setText(i18n("Discarded to save memory"));
+    setObsolete(true);
 }
 
 void FunctionalUndoCommand::undo()
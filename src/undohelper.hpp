@@ -25,12 +25,14 @@ using Fun = std::function<bool(void)>;
         return v && lambda();                                                                                                                                  \
     };
 
+#include <QTime>
 #include <QUndoCommand>
 
 /** @brief this is a generic class that takes fonctors as undo and redo actions. It just executes them when required by Qt
   Note that QUndoStack actually executes redo() when we push the undoCommand to the stack
   This is bad for us because we execute the command as we construct the undo Function. So to prevent it to be executed twice, there is a small hack in this
   command that prevent redoing if it has not been undone before.
+  Fine-grained commands (for example keyframe updates while dragging) can be marked as mergeable, so that consecutive ones are compacted in one undo step.
  */
 class FunctionalUndoCommand : public QUndoCommand
 {
@@ -38,8 +40,29 @@ public:
     FunctionalUndoCommand(Fun undo, Fun redo, const QString &text, QUndoCommand *parent = nullptr);
     void undo() override;
     void redo() override;
+    int id() const override;
+    /** @brief Allows merging this command with the next one, see mergeWith
+        @param target the object modified by the command, only commands on the same target are merged
+        @param key identifies the part of the target that is modified, like a keyframe position. Only commands with the same key are merged */
+    void setMergeable(bool mergeable, const void *target = nullptr, qint64 key = 0);
+    /** @brief Merges a mergeable command pushed right after this one if it has the same text, target and key, and was pushed within the
+     * undomergeinterval setting */
+    bool mergeWith(const QUndoCommand *other) override;
+    /** @brief Returns the estimated memory used by this command, in bytes.
+        The state captured by the lambdas cannot be inspected, so this is a fixed estimate per operation plus the text and any declared payload */
+    size_t memoryCost() const;
+    /** @brief Declares the size of large data (xml, producer state) captured by the lambdas, so that it is taken into account in memoryCost */
+    void addMemoryCost(size_t bytes);
+    /** @brief Releases the lambdas to free their memory. The command then does nothing and is removed from the stack when reached */
+    void discard();
 
 private:
     Fun m_undo, m_redo;
     bool m_undone;
+    QString m_name;
+    QTime m_stamp;
+    size_t m_cost;
+    bool m_mergeable;
+    const void *m_mergeTarget;
+    qint64 m_mergeKey;
 };
@@ -0,0 +1,244 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "filehashcache.hpp"
+#include "kdenlive_debug.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+// Increase when the cache format or the sampling method changes
+static const quint32 cacheVersion = 2;
+// Entries that were not used for this number of days are dropped on save
+static const qint64 maxEntryAge = 90 * 24 * 3600;
+
+std::unique_ptr<FileHashCache> FileHashCache::instance;
+std::once_flag FileHashCache::m_onceFlag;
+
+FileHashCache::FileHashCache()
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    m_cacheFile = dir.absoluteFilePath(QStringLiteral("filehashes.cache"));
+}
+
+FileHashCache::~FileHashCache()
+{
+    save();
+}
+
+std::unique_ptr<FileHashCache> &FileHashCache::get()
+{
+    std::call_once(m_onceFlag, [] { instance.reset(new FileHashCache()); });
+    return instance;
+}
+
+void FileHashCache::loadIfNeeded()
+{
+    // Must be called with m_mutex locked
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    QDataStream in(&file);
+    quint32 version;
+    quint32 count;
+    in >> version >> count;
+    if (version != cacheVersion) {
+        qCDebug(KDENLIVE_LOG) << "Discarding file hash cache with version" << version;
+        return;
+    }
+    m_entries.reserve(count);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString path;
+        Entry entry;
+        in >> path >> entry.size >> entry.mtime >> entry.inode >> entry.md5 >> entry.lastUsed;
+        if (in.status() == QDataStream::Ok) {
+            m_entries[path] = entry;
+        }
+    }
+}
+
+void FileHashCache::save()
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_dirty) {
+        return;
+    }
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (now - it->second.lastUsed > maxEntryAge) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    QDir().mkpath(QFileInfo(m_cacheFile).absolutePath());
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KDENLIVE_LOG) << "Cannot write file hash cache" << m_cacheFile;
+        return;
+    }
+    QDataStream out(&file);
+    out << cacheVersion << quint32(m_entries.size());
+    for (const auto &e : m_entries) {
+        const Entry &entry = e.second;
+        out << e.first << entry.size << entry.mtime << entry.inode << entry.md5 << entry.lastUsed;
+    }
+    if (file.commit()) {
+        m_dirty = false;
+    }
+}
+
+void FileHashCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_entries.clear();
+    m_folders.clear();
+    m_loaded = true;
+    m_dirty = false;
+    QFile::remove(m_cacheFile);
+}
+
+bool FileHashCache::statFile(const QString &path, qint64 &size, qint64 &mtime, quint64 &inode)
+{
+#ifdef Q_OS_UNIX
+    QT_STATBUF statBuf;
+    if (QT_STAT(QFile::encodeName(path).constData(), &statBuf) != 0 || !S_ISREG(statBuf.st_mode)) {
+        return false;
+    }
+    size = qint64(statBuf.st_size);
+    mtime = qint64(statBuf.st_mtime) * 1000;
+#if defined(Q_OS_LINUX)
+    mtime += qint64(statBuf.st_mtim.tv_nsec) / 1000000;
+#endif
+    inode = quint64(statBuf.st_ino);
+    return true;
+#else
+    QFileInfo info(path);
+    if (!info.isFile()) {
+        return false;
+    }
+    size = info.size();
+    mtime = info.lastModified().toMSecsSinceEpoch();
+    inode = 0;
+    return true;
+#endif
+}
+
+QByteArray FileHashCache::sampleFile(const QString &path, qint64 &size)
+{
+    QFile file(path);
+    QByteArray fileData;
+    if (file.open(QIODevice::ReadOnly)) { // write size and hash only if resource points to a file
+        /*
+         * 1 MB = 1 second per 450 files (or faster)
+         * 10 MB = 9 seconds per 450 files (or faster)
+         */
+        size = file.size();
+        if (size > 2000000) {
+            fileData = file.read(1000000);
+            if (file.seek(file.size() - 1000000)) {
+                fileData.append(file.readAll());
+            }
+        } else {
+            fileData = file.readAll();
+        }
+        file.close();
+    } else {
+        size = -1;
+    }
+    return fileData;
+}
+
+QPair<QByteArray, qint64> FileHashCache::fileHash(const QString &path)
+{
+    qint64 size = 0;
+    qint64 mtime = 0;
+    quint64 inode = 0;
+    if (path.isEmpty() || !statFile(path, size, mtime, inode)) {
+        return {QByteArray(), 0};
+    }
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    QMutexLocker lock(&m_mutex);
+    loadIfNeeded();
+    auto it = m_entries.find(path);
+    if (it != m_entries.end()) {
+        Entry &entry = it->second;
+        if (entry.size == size && entry.mtime == mtime && entry.inode == inode) {
+            // File is unchanged, no need to read it
+            if (now - entry.lastUsed > 24 * 3600) {
+                entry.lastUsed = now;
+                m_dirty = true;
+            }
+            return {entry.md5, size};
+        }
+    }
+    // Don't block other threads while reading the file
+    lock.unlock();
+    qint64 fileSize = 0;
+    const QByteArray fileData = sampleFile(path, fileSize);
+    if (fileSize < 0) {
+        return {QByteArray(), 0};
+    }
+    Entry entry;
+    entry.size = fileSize;
+    entry.mtime = mtime;
+    entry.inode = inode;
+    entry.lastUsed = now;
+    entry.md5 = QCryptographicHash::hash(fileData, QCryptographicHash::Md5);
+    lock.relock();
+    m_entries[path] = entry;
+    m_dirty = true;
+    return {entry.md5, fileSize};
+}
+
+QByteArray FileHashCache::folderHash(const QDir &dir, QString fileName)
+{
+    const QString folder = dir.absolutePath();
+    const qint64 mtime = QFileInfo(folder).lastModified().toMSecsSinceEpoch();
+    QStringList files;
+    QMutexLocker lock(&m_mutex);
+    auto it = m_folders.find(folder);
+    // A folder modified shortly before it was listed may have changed again without a new modification time, on file systems with a low time resolution
+    if (it != m_folders.end() && it->second.mtime == mtime && mtime + 2000 < it->second.listed) {
+        files = it->second.files;
+    } else {
+        // Listing a large image sequence is slow, only do it when files were added, removed or renamed
+        lock.unlock();
+        const qint64 listed = QDateTime::currentMSecsSinceEpoch();
+        files = dir.entryList(QDir::Files);
+        lock.relock();
+        m_folders[folder] = {mtime, listed, files};
+    }
+    lock.unlock();
+    fileName.append(files.join(QLatin1Char(',')));
+    // Include file hash info in case we have several folders with same file names (can happen for image sequences)
+    if (!files.isEmpty()) {
+        QPair<QByteArray, qint64> hashData = fileHash(dir.absoluteFilePath(files.first()));
+        fileName.append(hashData.first);
+        fileName.append(QString::number(hashData.second));
+        if (files.size() > 1) {
+            hashData = fileHash(dir.absoluteFilePath(files.at(files.size() / 2)));
+            fileName.append(hashData.first);
+            fileName.append(QString::number(hashData.second));
+        }
+    }
+    return QCryptographicHash::hash(fileName.toUtf8(), QCryptographicHash::Md5);
+}
@@ -0,0 +1,88 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/** @class FileHashCache
+    @brief This class keeps a persistent cache of the file hashes used to identify bin clips.
+    Computing a clip hash requires reading 2MB of data (head and tail of the file), which is slow on network shares.
+    For each file, we store its size, modification time and inode along with the resulting hashes, so that
+    unchanged files never have to be read again, even across sessions.
+    The cached MD5 is kept for compatibility with existing project files and caches.
+    The file lists of slideshow folders are also kept in memory until the folder changes.
+ * Note that this class is a Singleton
+ */
+class FileHashCache
+{
+
+public:
+    friend class KdenliveTests;
+    // Returns the instance of the Singleton
+    static std::unique_ptr<FileHashCache> &get();
+    ~FileHashCache();
+
+    /** @brief Returns the MD5 hash and size of the file at @param path, only reading the file if it changed since last hashing.
+        Returns an empty hash if the file cannot be read. This method is thread safe.
+     */
+    QPair<QByteArray, qint64> fileHash(const QString &path);
+
+    /** @brief Returns the hash identifying the slideshow @param fileName in the folder @param dir, based on the folder's file list
+        and the hash of some of its files. The file list is only read again if the folder was modified. This method is thread safe.
+     */
+    QByteArray folderHash(const QDir &dir, QString fileName);
+
+    /** @brief Write the cache to disk if it was modified */
+    void save();
+
+    /** @brief Discard all cached entries (memory and disk) */
+    void clear();
+
+protected:
+    // Constructor is protected because class is a Singleton
+    FileHashCache();
+
+    struct Entry
+    {
+        qint64 size{0};
+        qint64 mtime{0};
+        quint64 inode{0};
+        QByteArray md5;
+        qint64 lastUsed{0};
+    };
+
+    /** @brief Fetch size, modification time and inode for a file, returns false if the file does not exist */
+    static bool statFile(const QString &path, qint64 &size, qint64 &mtime, quint64 &inode);
+    /** @brief Read the sampled data used to compute the hash (whole file if small, head and tail otherwise) */
+    static QByteArray sampleFile(const QString &path, qint64 &size);
+    void loadIfNeeded();
+
+    struct FolderEntry
+    {
+        qint64 mtime{0};
+        /// When the folder was listed
+        qint64 listed{0};
+        QStringList files;
+    };
+
+    static std::unique_ptr<FileHashCache> instance;
+    static std::once_flag m_onceFlag; // flag to create the repository only once;
+
+    mutable QMutex m_mutex;
+    std::unordered_map<QString, Entry> m_entries;
+    std::unordered_map<QString, FolderEntry> m_folders;
+    QString m_cacheFile;
+    bool m_loaded{false};
+    bool m_dirty{false};
+};
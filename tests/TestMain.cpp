@@ -11,7 +11,10 @@
 #include "mltconnection.h"
 #include "src/effects/effectsrepository.hpp"
 #include "src/mltcontroller/clipcontroller.h"
+#include "test_utils.hpp"
+#include "utils/filehashcache.hpp"
 #include <QApplication>
+#include <QTemporaryDir>
 #include <mlt++/MltFactory.h>
 #include <mlt++/MltRepository.h>
 
@@ -26,6 +29,9 @@ int main(int argc, char *argv[])
     std::unique_ptr<Mlt::Repository> repo(Mlt::Factory::init(nullptr));
     qputenv("MLT_TESTS", QByteArray("1"));
     qSetMessagePattern(QStringLiteral("%{time hh:mm:ss.zzz } %{file}:%{line} -- %{message}"));
+    // Don't write the hashes of the test files in the user's cache
+    QTemporaryDir cacheDir;
+    KdenliveTests::setFileHashCacheFile(cacheDir.filePath(QStringLiteral("filehashes.cache")));
     Core::build(LinuxPackageType::Unknown, true);
     MltConnection::construct(QString());
     pCore->projectItemModel()->buildPlaylist(QUuid());
@@ -40,5 +46,6 @@ int main(int argc, char *argv[])
     // delete repo;
     pCore->projectItemModel()->clean();
     pCore->cleanup();
+    FileHashCache::get().reset();
     return (result < 0xff ? result : 0xff);
 }
@@ -0,0 +1,148 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/keyframeindex/keyframeindex.h"
+#include "project/archivecopier.h"
+
+#include <QDomDocument>
+#include <QFile>
+#include <QTemporaryDir>
+
+using Segment = ArchiveCopier::Segment;
+
+TEST_CASE("Archive segments merging")
+{
+    SECTION("Handles are added and overlapping ranges merged")
+    {
+        const QVector<Segment> used = {{200, 250}, {10, 20}, {30, 40}};
+        const QVector<Segment> merged = ArchiveCopier::mergeSegments(used, 5, 240, nullptr);
+        REQUIRE(merged.count() == 2);
+        REQUIRE(merged.at(0) == Segment{5, 45});
+        // Clamped to the clip duration
+        REQUIRE(merged.at(1) == Segment{195, 239});
+    }
+
+    SECTION("Segments start on a keyframe")
+    {
+        KeyframeIndex index({0, 50, 100, 150});
+        const QVector<Segment> merged = ArchiveCopier::mergeSegments({{120, 130}, {60, 70}}, 0, 0, &index);
+        REQUIRE(merged.count() == 2);
+        REQUIRE(merged.at(0) == Segment{50, 70});
+        REQUIRE(merged.at(1) == Segment{100, 130});
+        // Moving the start back can join two segments
+        REQUIRE(ArchiveCopier::mergeSegments({{60, 99}, {110, 130}}, 0, 0, &index) == QVector<Segment>{{50, 130}});
+    }
+
+    SECTION("Frames are found in their segment")
+    {
+        const QVector<Segment> segments = {{0, 10}, {50, 60}};
+        REQUIRE(ArchiveCopier::segmentIndex(segments, 10) == 0);
+        REQUIRE(ArchiveCopier::segmentIndex(segments, 50) == 1);
+        REQUIRE(ArchiveCopier::segmentIndex(segments, 30) == -1);
+    }
+}
+
+TEST_CASE("Archive items")
+{
+    REQUIRE(ArchiveCopier::segmentPath(QStringLiteral("videos/clip.mp4"), 0) == QStringLiteral("videos/clip_001.mp4"));
+    REQUIRE(ArchiveCopier::segmentPath(QStringLiteral("clip"), 11) == QStringLiteral("clip_012"));
+
+    ArchiveCopier::Item item;
+    item.size = 1000;
+    REQUIRE(ArchiveCopier::estimatedSize(item) == 1000);
+    item.length = 100;
+    item.segments = {{0, 9}, {50, 64}};
+    REQUIRE(ArchiveCopier::estimatedSize(item) == 250);
+    // The size read from the keyframe index is used when known
+    item.trimmedSize = 400;
+    REQUIRE(ArchiveCopier::estimatedSize(item) == 400);
+    item.trimmedSize = 5000;
+    REQUIRE(ArchiveCopier::estimatedSize(item) == 1000);
+}
+
+TEST_CASE("Archive effects of trimmed clips")
+{
+    SECTION("Keyframes are moved to the start of the segment")
+    {
+        REQUIRE(ArchiveCopier::shiftKeyframes(QStringLiteral("100=0;150~=1"), 100, 25.) == QStringLiteral("0=0;50~=1"));
+        // The last keyframe before the segment gives the value at its start
+        REQUIRE(ArchiveCopier::shiftKeyframes(QStringLiteral("20=0;60|=0.5;150=1"), 100, 25.) == QStringLiteral("0|=0.5;50=1"));
+        // Clock values and positions relative to the end
+        REQUIRE(ArchiveCopier::shiftKeyframes(QStringLiteral("00:00:06.000=0 0 1920 1080;-1=0"), 100, 25.) == QStringLiteral("50=0 0 1920 1080;-1=0"));
+        REQUIRE(ArchiveCopier::shiftKeyframes(QStringLiteral("0.5"), 100, 25.).isNull());
+        REQUIRE(ArchiveCopier::shiftKeyframes(QStringLiteral("#ff000000"), 100, 25.).isNull());
+    }
+
+    SECTION("Fade of a timeline clip")
+    {
+        QDomDocument doc;
+        REQUIRE(doc.setContent(QStringLiteral("<entry producer=\"chain0\" in=\"120\" out=\"179\">"
+                                              "<filter id=\"filter0\" in=\"120\" out=\"144\">"
+                                              "<property name=\"kdenlive_id\">fadein</property><property name=\"level\">0=0;24=1</property></filter>"
+                                              "<filter id=\"filter1\"><property name=\"kdenlive:collapsed\">0=1</property>"
+                                              "<property name=\"rect\">110=0 0 100 100;150=10 10 100 100</property></filter>"
+                                              "</entry>")));
+        ArchiveCopier::rebaseFilters(doc.documentElement(), {100, 199}, 25.);
+        const QDomElement fade = doc.documentElement().firstChildElement(QStringLiteral("filter"));
+        REQUIRE(fade.attribute(QStringLiteral("in")) == QStringLiteral("20"));
+        REQUIRE(fade.attribute(QStringLiteral("out")) == QStringLiteral("44"));
+        // Keyframes are relative to the filter start
+        REQUIRE(fade.lastChildElement(QStringLiteral("property")).text() == QStringLiteral("0=0;24=1"));
+        const QDomElement transform = fade.nextSiblingElement(QStringLiteral("filter"));
+        REQUIRE(transform.firstChildElement(QStringLiteral("property")).text() == QStringLiteral("0=1"));
+        REQUIRE(transform.lastChildElement(QStringLiteral("property")).text() == QStringLiteral("10=0 0 100 100;50=10 10 100 100"));
+    }
+
+    SECTION("Effect ranges are clamped to the segment")
+    {
+        QDomDocument doc;
+        REQUIRE(doc.setContent(QStringLiteral("<producer id=\"producer0\"><filter in=\"50\" out=\"400\"/></producer>")));
+        ArchiveCopier::rebaseFilters(doc.documentElement(), {100, 199}, 25.);
+        const QDomElement filter = doc.documentElement().firstChildElement(QStringLiteral("filter"));
+        REQUIRE(filter.attribute(QStringLiteral("in")) == QStringLiteral("0"));
+        REQUIRE(filter.attribute(QStringLiteral("out")) == QStringLiteral("99"));
+    }
+}
+
+TEST_CASE("Archive duplicated files")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto writeFile = [&dir](const QString &name, const QByteArray &data) {
+        QFile file(dir.filePath(name));
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write(data);
+        file.close();
+        ArchiveCopier::Item item;
+        item.source = file.fileName();
+        item.destination = QStringLiteral("videos/") + name;
+        item.size = data.size();
+        return item;
+    };
+    QVector<ArchiveCopier::Item> items;
+    items << writeFile(QStringLiteral("a.mp4"), QByteArrayLiteral("0123456789"));
+    items << writeFile(QStringLiteral("b.mp4"), QByteArrayLiteral("0123456789"));
+    // Same size, different content
+    items << writeFile(QStringLiteral("c.mp4"), QByteArrayLiteral("9876543210"));
+    items << writeFile(QStringLiteral("d.mp4"), QByteArrayLiteral("0123"));
+    // Same file listed twice
+    items << items.at(2);
+
+    QAtomicInt abort;
+    ArchiveCopier::findDuplicates(items, abort);
+    REQUIRE(items.at(0).duplicateOf == -1);
+    REQUIRE(items.at(1).duplicateOf == 0);
+    REQUIRE(items.at(2).duplicateOf == -1);
+    REQUIRE(items.at(3).duplicateOf == -1);
+    REQUIRE(items.at(4).duplicateOf == 2);
+
+    ArchiveCopier copier(items, 25.);
+    REQUIRE(copier.totalSize(false) == 24);
+    REQUIRE(copier.totalSize(true) == 0);
+}
@@ -10,6 +10,12 @@
 #include "jobs/audiolevels/audiolevelstask.h"
 #include "jobs/audiolevels/generators.h"
 
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/frame.h>
+}
+
 void computePeaksTestHelper(const QVector<int16_t> &input, const QVector<int16_t> &expectedOutput, const size_t channels)
 {
     QVector<int16_t> output(expectedOutput.size());
@@ -220,6 +226,88 @@ TEST_CASE("both methods on multiple audio streams")
     }
 }
 
+/** @brief Pass a decoded frame of @param samples samples, all set to @param value, to the accumulator */
+bool addSamples(AudioLevelsAccumulator &accumulator, int channels, int samples, int16_t value, QVector<int> &progress)
+{
+    AVFrame *frame = av_frame_alloc();
+    frame->format = AV_SAMPLE_FMT_S16;
+    frame->sample_rate = 48000;
+    frame->nb_samples = samples;
+    av_channel_layout_default(&frame->ch_layout, channels);
+    REQUIRE(av_frame_get_buffer(frame, 0) >= 0);
+    auto *data = reinterpret_cast<int16_t *>(frame->data[0]);
+    std::fill(data, data + samples * channels, value);
+    const bool result = accumulator.addFrame(frame, [&progress](int p, const QVector<int16_t> &) { progress << p; });
+    av_frame_free(&frame);
+    return result;
+}
+
+/** @brief Returns true if all the levels of MLT frame @param frame are @param value */
+bool frameLevelsEqual(const QVector<int16_t> &levels, int channels, int frame, int16_t value)
+{
+    const int size = AUDIOLEVELS_POINTS_PER_FRAME * channels;
+    for (int i = frame * size; i < (frame + 1) * size; ++i) {
+        if (levels.at(i) != value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("AudioLevelsAccumulator", "[AudioLevels]")
+{
+    // 48kHz stereo s16, which does not need any conversion. One MLT frame is 1920 samples at 25 fps.
+    AVCodecContext *codec_ctx = avcodec_alloc_context3(nullptr);
+    REQUIRE(codec_ctx != nullptr);
+    codec_ctx->sample_fmt = AV_SAMPLE_FMT_S16;
+    codec_ctx->sample_rate = 48000;
+    av_channel_layout_default(&codec_ctx->ch_layout, 2);
+    QVector<int> progress;
+
+    SECTION("Levels are computed for each MLT frame")
+    {
+        AudioLevelsAccumulator accumulator(3, 25);
+        REQUIRE(accumulator.init(codec_ctx));
+        REQUIRE(accumulator.levels().size() == 3 * AUDIOLEVELS_POINTS_PER_FRAME * 2);
+        REQUIRE(addSamples(accumulator, 2, 1920, 1000, progress));
+        REQUIRE(addSamples(accumulator, 2, 1920, -2000, progress));
+        // Not enough samples for the last MLT frame
+        REQUIRE(addSamples(accumulator, 2, 960, 500, progress));
+        const QVector<int16_t> &levels = accumulator.levels();
+        REQUIRE(frameLevelsEqual(levels, 2, 0, 1000));
+        REQUIRE(frameLevelsEqual(levels, 2, 1, 2000));
+        REQUIRE(frameLevelsEqual(levels, 2, 2, 0));
+        REQUIRE(progress == QVector<int>({0, 33}));
+    }
+
+    SECTION("Samples are buffered across decoded frames")
+    {
+        AudioLevelsAccumulator accumulator(2, 25);
+        REQUIRE(accumulator.init(codec_ctx));
+        REQUIRE(addSamples(accumulator, 2, 1200, 100, progress));
+        REQUIRE(progress.isEmpty());
+        REQUIRE(addSamples(accumulator, 2, 1200, 300, progress));
+        REQUIRE(addSamples(accumulator, 2, 1520, 200, progress));
+        REQUIRE(progress.count() == 2);
+        const QVector<int16_t> &levels = accumulator.levels();
+        // The first MLT frame contains 1200 samples at 100 and 720 at 300
+        REQUIRE(levels.at(0) == 100);
+        REQUIRE(levels.at(AUDIOLEVELS_POINTS_PER_FRAME * 2 - 1) == 300);
+        // The second one contains 480 samples at 300 and 1440 at 200
+        REQUIRE(levels.at(AUDIOLEVELS_POINTS_PER_FRAME * 2) == 300);
+        REQUIRE(levels.at(AUDIOLEVELS_POINTS_PER_FRAME * 4 - 1) == 200);
+    }
+
+    SECTION("Audio longer than the clip is rejected")
+    {
+        AudioLevelsAccumulator accumulator(1, 25);
+        REQUIRE(accumulator.init(codec_ctx));
+        REQUIRE_FALSE(addSamples(accumulator, 2, 3 * 1920, 1000, progress));
+        REQUIRE(accumulator.levels().isEmpty());
+    }
+    avcodec_free_context(&codec_ctx);
+}
+
 TEST_CASE("(de)serialize audio levels")
 {
     const auto input = QVector<int16_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
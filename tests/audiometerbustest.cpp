@@ -0,0 +1,113 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "audiomixer/audiometerbus.h"
+
+#include <thread>
+
+static AudioMeterLevels makeLevels(int position, float value)
+{
+    AudioMeterLevels levels;
+    levels.position = position;
+    levels.channels = 2;
+    levels.peak = {value, value - 1};
+    levels.rms = {value - 3, value - 4};
+    return levels;
+}
+
+TEST_CASE("Audio meter ring")
+{
+    auto ring = std::make_unique<AudioMeterRing>();
+    AudioMeterLevels levels;
+    REQUIRE_FALSE(ring->latest(levels));
+    REQUIRE_FALSE(ring->read(0, levels));
+
+    SECTION("Read levels by position")
+    {
+        for (int i = 0; i < 10; i++) {
+            ring->publish(makeLevels(i, -float(i)));
+        }
+        REQUIRE(ring->published() == 10);
+        REQUIRE(ring->read(4, levels));
+        REQUIRE(levels.position == 4);
+        REQUIRE(levels.channels == 2);
+        REQUIRE(levels.peak[0] == -4.f);
+        REQUIRE(levels.rms[1] == -8.f);
+        REQUIRE(levels.peakValues() == QVector<double>({-4., -5.}));
+        REQUIRE(ring->latest(levels));
+        REQUIRE(levels.position == 9);
+        REQUIRE_FALSE(ring->read(10, levels));
+        // The most recent levels are used if a frame was published twice
+        ring->publish(makeLevels(4, -20));
+        REQUIRE(ring->read(4, levels));
+        REQUIRE(levels.peak[0] == -20.f);
+    }
+
+    SECTION("Old levels are overwritten")
+    {
+        for (int i = 0; i < AudioMeterRing::Capacity + 10; i++) {
+            ring->publish(makeLevels(i, 0));
+        }
+        REQUIRE_FALSE(ring->read(5, levels));
+        REQUIRE(ring->read(10, levels));
+        REQUIRE(ring->read(AudioMeterRing::Capacity + 9, levels));
+    }
+
+    SECTION("Clear discards the published levels")
+    {
+        ring->publish(makeLevels(1, 0));
+        ring->clear();
+        REQUIRE_FALSE(ring->read(1, levels));
+        REQUIRE_FALSE(ring->latest(levels));
+        ring->publish(makeLevels(2, 0));
+        REQUIRE(ring->latest(levels));
+        REQUIRE(levels.position == 2);
+    }
+
+    SECTION("Concurrent reads never return torn levels")
+    {
+        std::atomic<bool> done{false};
+        std::thread writer([&ring, &done]() {
+            for (int i = 0; i < 200000; i++) {
+                ring->publish(makeLevels(i, float(i)));
+            }
+            done = true;
+        });
+        bool consistent = true;
+        while (!done) {
+            if (ring->latest(levels)) {
+                consistent = consistent && levels.peak[0] == float(levels.position) && levels.rms[1] == float(levels.position) - 4;
+            }
+        }
+        writer.join();
+        REQUIRE(consistent);
+    }
+}
+
+TEST_CASE("Audio meter bus")
+{
+    AudioMeterBus &bus = AudioMeterBus::get();
+    REQUIRE(bus.ring(AudioMeterBus::MasterMeter) != nullptr);
+    REQUIRE(bus.ring(-1) == nullptr);
+    const int first = bus.acquire();
+    const int second = bus.acquire();
+    REQUIRE(first > AudioMeterBus::MasterMeter);
+    REQUIRE(second != first);
+    AudioMeterRing *ring = bus.ring(first);
+    ring->publish(makeLevels(1, 0));
+    bus.release(first);
+    // A released ring is reused without its previous levels
+    REQUIRE(bus.acquire() == first);
+    REQUIRE(bus.ring(first) == ring);
+    AudioMeterLevels levels;
+    REQUIRE_FALSE(ring->latest(levels));
+    bus.release(first);
+    bus.release(second);
+    REQUIRE(QByteArray(AudioMeterBus::levelProperty(1)) == QByteArray("_audio_level.1"));
+}
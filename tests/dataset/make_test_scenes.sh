@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# SPDX-FileCopyrightText: 2026 Kdenlive contributors
+# SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+
+# This file creates the video used to test scene detection.
+# scenes.y4m: 96 seconds of uncompressed 16x16 video at 1 frame per second, in 3 single color scenes
+# (dark gray, white, red) starting at 0, 32 and 64 seconds. It is long enough to be scanned in several ranges.
+
+output=scenes.y4m
+
+# Write @count times the byte with octal value @value
+bytes() {
+    head -c "$2" /dev/zero | tr '\0' "\\$1"
+}
+
+# Write @frames frames with the Y, U and V octal values
+scene() {
+    for ((i = 0; i < $1; i++)); do
+        printf 'FRAME\n'
+        bytes "$2" 256
+        bytes "$3" 64
+        bytes "$4" 64
+    done
+}
+
+{
+    printf 'YUV4MPEG2 W16 H16 F1:1 Ip A1:1 C420jpeg\n'
+    scene 32 020 200 200
+    scene 32 353 200 200
+    scene 32 122 132 360
+} > $output
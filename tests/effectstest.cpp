@@ -104,6 +104,35 @@ TEST_CASE("Effects stack", "[Effects]")
         REQUIRE(clipModel->rowCount() == 0);
         REQUIRE(splitModel->rowCount() == 1);
     }
+    SECTION("Clip roles follow the effect stack")
+    {
+        auto clipModel = timeline->getClipEffectStackModel(cid1);
+        const QModelIndex ix = timeline->makeClipIndexFromID(cid1);
+        REQUIRE(timeline->data(ix, TimelineModel::EffectNamesRole).toString().isEmpty());
+        QVector<int> changedRoles;
+        auto connection = QObject::connect(timeline.get(), &TimelineModel::dataChanged, timeline.get(),
+                                           [&changedRoles](const QModelIndex &, const QModelIndex &, const QVector<int> &roles) { changedRoles << roles; });
+
+        REQUIRE(clipModel->appendEffect(anEffect));
+        REQUIRE_FALSE(timeline->data(ix, TimelineModel::EffectNamesRole).toString().isEmpty());
+        REQUIRE(changedRoles.contains(TimelineModel::EffectNamesRole));
+        // Only the cached roles that changed are notified
+        REQUIRE_FALSE(changedRoles.contains(TimelineModel::FadeInRole));
+        REQUIRE_FALSE(changedRoles.contains(TimelineModel::FadeOutRole));
+
+        changedRoles.clear();
+        clipModel->appendEffect("fade_from_black");
+        REQUIRE(timeline->data(ix, TimelineModel::FadeInRole).toInt() > 0);
+        REQUIRE(changedRoles.contains(TimelineModel::FadeInRole));
+        REQUIRE_FALSE(changedRoles.contains(TimelineModel::FadeOutRole));
+
+        undoStack->undo();
+        undoStack->undo();
+        REQUIRE(timeline->data(ix, TimelineModel::EffectNamesRole).toString().isEmpty());
+        REQUIRE(timeline->data(ix, TimelineModel::FadeInRole).toInt() == 0);
+        QObject::disconnect(connection);
+    }
+
     timeline.reset();
     clip.reset();
     pCore->projectManager()->closeCurrentDocument(false, false);
@@ -0,0 +1,93 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "bin/filewatcher.hpp"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    REQUIRE(file.write(data) == data.size());
+}
+
+/** @brief Process the events during @param duration milliseconds */
+void processEvents(int duration)
+{
+    waitFor([]() { return false; }, duration);
+}
+} // namespace
+
+TEST_CASE("File watcher", "[FileWatcher]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString first = dir.filePath(QStringLiteral("first.txt"));
+    const QString second = dir.filePath(QStringLiteral("second.txt"));
+    writeFile(first, "first");
+    writeFile(second, "second");
+
+    FileWatcher watcher;
+    QStringList waiting;
+    QStringList missing;
+    QList<QStringList> modified;
+    QObject::connect(&watcher, &FileWatcher::binClipWaiting, [&waiting](const QString &id) { waiting << id; });
+    QObject::connect(&watcher, &FileWatcher::binClipMissing, [&missing](const QString &id) { missing << id; });
+    QObject::connect(&watcher, &FileWatcher::binClipsModified, [&modified](const QStringList &ids) { modified << ids; });
+    // Two clips use the first file
+    watcher.addFile(QStringLiteral("1"), first);
+    watcher.addFile(QStringLiteral("2"), second);
+    watcher.addFile(QStringLiteral("3"), first);
+    // Files are added to the watcher in batches
+    REQUIRE(waitFor([&]() { return watcher.contains(first) && watcher.contains(second); }));
+    processEvents(200);
+
+    SECTION("A file rewritten several times is reloaded once")
+    {
+        writeFile(first, "first, modified");
+        processEvents(300);
+        writeFile(first, "first, modified again");
+        REQUIRE(waitFor([&]() { return !modified.isEmpty(); }));
+        // Check that the reload is not repeated
+        processEvents(2500);
+        REQUIRE(modified.count() == 1);
+        QStringList ids = modified.first();
+        ids.sort();
+        REQUIRE(ids == QStringList({QStringLiteral("1"), QStringLiteral("3")}));
+        REQUIRE(waiting.contains(QStringLiteral("1")));
+        REQUIRE(waiting.contains(QStringLiteral("3")));
+        REQUIRE_FALSE(waiting.contains(QStringLiteral("2")));
+        REQUIRE(missing.isEmpty());
+    }
+
+    SECTION("A deleted file is reported missing")
+    {
+        REQUIRE(QFile::remove(second));
+        REQUIRE(waitFor([&]() { return !missing.isEmpty(); }));
+        processEvents(1500);
+        REQUIRE(missing == QStringList({QStringLiteral("2")}));
+        REQUIRE(modified.isEmpty());
+        REQUIRE(waiting.isEmpty());
+    }
+
+    SECTION("Removed clips are not watched anymore")
+    {
+        watcher.removeFile(QStringLiteral("1"));
+        REQUIRE(watcher.contains(first));
+        watcher.removeFile(QStringLiteral("3"));
+        REQUIRE_FALSE(watcher.contains(first));
+        writeFile(first, "first, modified");
+        processEvents(2500);
+        REQUIRE(modified.isEmpty());
+        REQUIRE(waiting.isEmpty());
+    }
+}
@@ -0,0 +1,86 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "monitor/framecache.h"
+
+static FrameCache::Image makeImage(char value)
+{
+    return {QByteArray(100, value), 10, 5};
+}
+
+TEST_CASE("Frame cache storage")
+{
+    // Room for 4 images
+    auto cache = std::make_shared<FrameCache>(400);
+    FrameCache::Image image;
+
+    SECTION("Fetch requires the same image parameters")
+    {
+        REQUIRE(cache->insert(10, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+        REQUIRE(cache->fetch(10, mlt_image_yuv422, 10, 5, image));
+        REQUIRE(image.data == QByteArray(100, 'a'));
+        REQUIRE(image.width == 10);
+        REQUIRE_FALSE(cache->fetch(11, mlt_image_yuv422, 10, 5, image));
+        REQUIRE_FALSE(cache->fetch(10, mlt_image_rgba, 10, 5, image));
+        REQUIRE_FALSE(cache->fetch(10, mlt_image_yuv422, 20, 10, image));
+        // Storing an image with other parameters discards the cache
+        REQUIRE(cache->insert(11, cache->generation(), mlt_image_rgba, 10, 5, makeImage('b')));
+        REQUIRE(cache->count() == 1);
+        REQUIRE_FALSE(cache->contains(10));
+    }
+
+    SECTION("Outdated renderings are rejected")
+    {
+        const quint64 generation = cache->generation();
+        cache->invalidate(0, 5);
+        REQUIRE_FALSE(cache->insert(10, generation, mlt_image_yuv422, 10, 5, makeImage('a')));
+        REQUIRE(cache->count() == 0);
+    }
+
+    SECTION("Invalidate a range")
+    {
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(cache->insert(i, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+        }
+        REQUIRE(cache->size() == 400);
+        cache->invalidate(1, 2);
+        REQUIRE(cache->count() == 2);
+        REQUIRE(cache->size() == 200);
+        REQUIRE(cache->contains(0));
+        REQUIRE(cache->contains(3));
+        // Negative end means until the end
+        cache->invalidate(3, -1);
+        REQUIRE(cache->count() == 1);
+        cache->clear();
+        REQUIRE(cache->size() == 0);
+    }
+
+    SECTION("Frames farthest from the playhead are discarded first")
+    {
+        cache->setPlayhead(11);
+        for (int i = 8; i < 12; ++i) {
+            REQUIRE(cache->insert(i, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+        }
+        // 12 is closer to the playhead than 8
+        REQUIRE(cache->insert(12, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+        REQUIRE(cache->count() == 4);
+        REQUIRE_FALSE(cache->contains(8));
+        // 20 is farther than all cached frames, it is not stored
+        REQUIRE_FALSE(cache->insert(20, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+        REQUIRE(cache->contains(9));
+        // Lowering the budget discards the farthest frames, 9 then 10 (on a tie, the frame before the playhead goes first)
+        cache->setBudget(200);
+        REQUIRE(cache->count() == 2);
+        REQUIRE(cache->contains(11));
+        REQUIRE(cache->contains(12));
+        cache->setBudget(0);
+        REQUIRE(cache->count() == 0);
+        REQUIRE_FALSE(cache->insert(10, cache->generation(), mlt_image_yuv422, 10, 5, makeImage('a')));
+    }
+}
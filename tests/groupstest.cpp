@@ -111,6 +111,32 @@ TEST_CASE("Functional test of the group hierarchy", "[GroupsModel]")
         }
     }
 
+    SECTION("Test cached roots, leaves and subtrees are invalidated")
+    {
+        // Fill the caches
+        REQUIRE(groups->getRootId(9) == 2);
+        REQUIRE(groups->getLeaves(2) == std::unordered_set<int>({0, 4, 6, 7, 9}));
+        REQUIRE(groups->getLeaves(3) == std::unordered_set<int>({4, 6, 7, 9}));
+        REQUIRE(groups->getSubtree(2) == std::unordered_set<int>({0, 1, 2, 3, 4, 6, 7, 9}));
+        REQUIRE(groups->getSubtree(3) == std::unordered_set<int>({3, 4, 6, 7, 9}));
+        // Move a subtree and query again
+        groups->setGroup(3, 8);
+        REQUIRE(groups->getRootId(9) == 5);
+        REQUIRE(groups->getRootId(3) == 5);
+        REQUIRE(groups->getLeaves(2) == std::unordered_set<int>({0}));
+        REQUIRE(groups->getLeaves(5) == std::unordered_set<int>({4, 6, 7, 9}));
+        REQUIRE(groups->getLeaves(3) == std::unordered_set<int>({4, 6, 7, 9}));
+        REQUIRE(groups->getSubtree(2) == std::unordered_set<int>({0, 1, 2}));
+        REQUIRE(groups->getSubtree(5) == std::unordered_set<int>({3, 4, 5, 6, 7, 8, 9}));
+        groups->removeFromGroup(9);
+        REQUIRE(groups->getRootId(9) == 9);
+        REQUIRE(groups->getLeaves(5) == std::unordered_set<int>({4, 6, 7}));
+        REQUIRE(groups->getLeaves(3) == std::unordered_set<int>({4, 6, 7}));
+        REQUIRE(groups->getSubtree(5) == std::unordered_set<int>({3, 4, 5, 6, 7, 8}));
+        REQUIRE(groups->getSubtree(3) == std::unordered_set<int>({3, 4, 6, 7}));
+        REQUIRE(groups->getSubtree(9) == std::unordered_set<int>({9}));
+    }
+
     groups->setGroup(3, 8);
     SECTION("Test leaf nodes 2")
     {
@@ -83,5 +83,23 @@ TEST_CASE("Show/hide tracks", "[HideTracks]")
         REQUIRE(timeline->duration() == 60);
     }
 
+    SECTION("Black track follows track ends")
+    {
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 110);
+        // Muted track end must be ignored on next duration check
+        timeline->setTrackProperty(tid2, QStringLiteral("hide"), "3");
+        REQUIRE(timeline->requestClipInsertion(binId2, tid4, 200, cid1));
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 250);
+        REQUIRE(timeline->requestItemResize(cid1, 20, true, true) == 20);
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 220);
+        REQUIRE(timeline->requestItemDeletion(cid1));
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 0);
+        timeline->setTrackProperty(tid2, QStringLiteral("hide"), "1");
+        undoStack->undo();
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 220);
+        undoStack->redo();
+        REQUIRE(KdenliveTests::blackTrackDuration(timeline) == 110);
+    }
+
     pCore->projectManager()->closeCurrentDocument(false, false);
 }
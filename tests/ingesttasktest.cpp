@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/audiolevels/generators.h"
+#include "jobs/ingesttask.h"
+
+#include <algorithm>
+
+TEST_CASE("Single pass ingest", "[Ingest]")
+{
+    SECTION("Audio levels of all the streams match the separate generation")
+    {
+        const QString path = sourcesPath + "/dataset/lots_of_audio_streams.mkv";
+        const double fps = pCore->getCurrentFps();
+        auto ignoreProgress = [](int, const QVector<int16_t> &) {};
+        const auto reference = generateMLT(0, "avformat", path, 1, ignoreProgress, 0);
+        REQUIRE(!reference.isEmpty());
+        IngestTask::ScanRequest request;
+        request.lengthInFrames = reference.size() / AUDIOLEVELS_POINTS_PER_FRAME;
+        request.fps = fps;
+        request.audioStreams = {0, 1, 2};
+        QVector<int> progressStreams;
+        bool validProgress = true;
+        request.audioProgress = [&](int streamIdx, int progress, const QVector<int16_t> &) {
+            progressStreams << streamIdx;
+            validProgress = validProgress && progress >= 0 && progress <= 100;
+        };
+        IngestTask::ScanResult result;
+        REQUIRE(IngestTask::scan(path, request, result, 0));
+        REQUIRE(validProgress);
+        REQUIRE(progressStreams.contains(0));
+        REQUIRE(progressStreams.contains(2));
+        REQUIRE(result.levels.keys() == QList<int>({0, 1, 2}));
+        for (int streamIdx = 0; streamIdx < 3; ++streamIdx) {
+            const auto levels = generateLibav(streamIdx, path, request.lengthInFrames, fps, ignoreProgress, 0);
+            REQUIRE(!levels.isEmpty());
+            REQUIRE(result.levels.value(streamIdx) == levels);
+        }
+        REQUIRE(result.levels.value(0) == reference);
+        // No video was requested
+        REQUIRE(result.sceneScores.isEmpty());
+    }
+
+    SECTION("Scene cuts and thumbnails are extracted in the same pass")
+    {
+        // 96 frames at 1 fps, a new scene starts at 32 and 64 seconds
+        const QString path = sourcesPath + "/dataset/scenes.y4m";
+        IngestTask::ScanRequest request;
+        request.lengthInFrames = 96;
+        request.fps = 1.;
+        request.scanScenes = true;
+        request.thumbFrames = {0, 40, 70};
+        request.thumbSize = QSize(16, 16);
+        QMap<int, QRgb> thumbs;
+        request.thumbnailReady = [&thumbs](int frame, const QImage &thumb) { thumbs.insert(frame, thumb.pixel(8, 8)); };
+        QVector<int> progress;
+        request.videoProgress = [&progress](int value) { progress << value; };
+        IngestTask::ScanResult result;
+        REQUIRE(IngestTask::scan(path, request, result, 0));
+        // The first frame has no reference to be compared with
+        REQUIRE(result.sceneScores.count() == 95);
+        REQUIRE(result.sceneScores.scenes(0.3) == QList<double>({32., 64.}));
+        REQUIRE(result.levels.isEmpty());
+
+        REQUIRE(thumbs.keys() == QList<int>({0, 40, 70}));
+        // Black, white, then red
+        REQUIRE(qGray(thumbs.value(0)) < 30);
+        REQUIRE(qGray(thumbs.value(40)) > 220);
+        REQUIRE(qRed(thumbs.value(70)) > 200);
+        REQUIRE(qBlue(thumbs.value(70)) < 50);
+
+        REQUIRE(!progress.isEmpty());
+        REQUIRE(std::is_sorted(progress.cbegin(), progress.cend()));
+        REQUIRE(progress.last() <= 99);
+    }
+
+    SECTION("Canceled scan")
+    {
+        IngestTask::ScanRequest request;
+        request.lengthInFrames = 96;
+        request.fps = 1.;
+        request.scanScenes = true;
+        IngestTask::ScanResult result;
+        REQUIRE(IngestTask::scan(sourcesPath + "/dataset/scenes.y4m", request, result, 1));
+        REQUIRE(result.sceneScores.isEmpty());
+    }
+
+    SECTION("Missing file")
+    {
+        IngestTask::ScanRequest request;
+        request.lengthInFrames = 10;
+        request.audioStreams = {0};
+        IngestTask::ScanResult result;
+        REQUIRE_FALSE(IngestTask::scan(QStringLiteral("i-do-not-exist.mp4"), request, result, 0));
+        REQUIRE(result.levels.isEmpty());
+    }
+}
@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/keyframeindex/keyframeindex.h"
+
+#include <QFileInfo>
+#include <QTemporaryFile>
+
+TEST_CASE("Keyframe index queries")
+{
+    // Unsorted, with a duplicate
+    KeyframeIndex index({50, 0, 20, 20, 110});
+    REQUIRE(index.count() == 4);
+    REQUIRE(index.maxGopLength() == 60);
+    REQUIRE(index.isLongGop(25));
+    REQUIRE_FALSE(index.isLongGop(60));
+
+    REQUIRE(index.previousKeyframe(0) == 0);
+    REQUIRE(index.previousKeyframe(19) == 0);
+    REQUIRE(index.previousKeyframe(20) == 20);
+    REQUIRE(index.previousKeyframe(200) == 110);
+
+    REQUIRE(index.nextKeyframe(0) == 20);
+    REQUIRE(index.nextKeyframe(50) == 110);
+    REQUIRE(index.nextKeyframe(110) == -1);
+
+    REQUIRE(index.nearestKeyframe(34) == 20);
+    // Ties go to the previous keyframe
+    REQUIRE(index.nearestKeyframe(35) == 20);
+    REQUIRE(index.nearestKeyframe(36) == 50);
+    REQUIRE(index.nearestKeyframe(500) == 110);
+
+    // No offsets, the sizes are unknown
+    REQUIRE(index.byteCount(0, 10) == -1);
+
+    // Unsorted with their offset, a duplicate keeps its first position
+    KeyframeIndex sized({50, 0, 20, 20, 110}, {5000, 0, 2000, 2500, 9000}, 12000);
+    REQUIRE(sized.count() == 4);
+    // From the keyframe before the start to the keyframe after the end
+    REQUIRE(sized.byteCount(0, 10) == 2000);
+    REQUIRE(sized.byteCount(25, 50) == 7000);
+    REQUIRE(sized.byteCount(20, 49) == 3000);
+    // Until the end of the file after the last keyframe
+    REQUIRE(sized.byteCount(100, 500) == 7000);
+    REQUIRE(sized.byteCount(10, 5) == -1);
+
+    KeyframeIndex empty(std::vector<int>{});
+    REQUIRE(empty.isEmpty());
+    REQUIRE(empty.previousKeyframe(10) == 0);
+    REQUIRE(empty.nextKeyframe(10) == -1);
+    REQUIRE(empty.nearestKeyframe(10) == 0);
+}
+
+TEST_CASE("Keyframe index with libav")
+{
+    auto progress = [](int value) {
+        REQUIRE(value <= 100);
+        REQUIRE(value >= 0);
+    };
+    QAtomicInt canceled;
+    SECTION("Video file")
+    {
+        const auto index = KeyframeIndex::build(sourcesPath + "/dataset/red.mp4", 25., progress, canceled);
+        REQUIRE(index != nullptr);
+        REQUIRE_FALSE(index->isEmpty());
+        REQUIRE(index->previousKeyframe(0) == 0);
+        REQUIRE(index->nearestKeyframe(0) == 0);
+
+        // Save and reload
+        QTemporaryFile tmp;
+        REQUIRE(tmp.open());
+        REQUIRE(index->save(tmp.fileName()));
+        const auto loaded = KeyframeIndex::load(tmp.fileName());
+        REQUIRE(loaded != nullptr);
+        REQUIRE(loaded->count() == index->count());
+        REQUIRE(loaded->maxGopLength() == index->maxGopLength());
+        // The mp4 demuxer knows where the packets are, the whole file is read from the first keyframe
+        const qint64 fileSize = QFileInfo(sourcesPath + "/dataset/red.mp4").size();
+        REQUIRE(index->byteCount(0, 1000000) > 0);
+        REQUIRE(index->byteCount(0, 1000000) <= fileSize);
+        REQUIRE(loaded->byteCount(0, 1000000) == index->byteCount(0, 1000000));
+    }
+    SECTION("Canceled")
+    {
+        canceled = 1;
+        REQUIRE(KeyframeIndex::build(sourcesPath + "/dataset/red.mp4", 25., progress, canceled) == nullptr);
+    }
+    SECTION("Invalid file")
+    {
+        REQUIRE(KeyframeIndex::build(sourcesPath + "/dataset/missing.mp4", 25., progress, canceled) == nullptr);
+        REQUIRE(KeyframeIndex::load(sourcesPath + "/dataset/missing.dat") == nullptr);
+    }
+    SECTION("Audio only file")
+    {
+        REQUIRE(KeyframeIndex::build(sourcesPath + "/dataset/mono.flac", 25., progress, canceled) == nullptr);
+    }
+}
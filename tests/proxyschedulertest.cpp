@@ -0,0 +1,89 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/keyframeindex/keyframeindex.h"
+#include "jobs/proxyscheduler.h"
+
+TEST_CASE("Proxy segments")
+{
+    using Segments = QVector<std::pair<int, int>>;
+    KeyframeIndex index({0, 100, 240, 260, 400});
+    REQUIRE(ProxyScheduler::splitSegments(500, index, 1) == Segments{{0, 499}});
+    // Ties go to the previous keyframe
+    REQUIRE(ProxyScheduler::splitSegments(500, index, 2) == Segments{{0, 239}, {240, 499}});
+    REQUIRE(ProxyScheduler::splitSegments(500, index, 4) == Segments{{0, 99}, {100, 239}, {240, 399}, {400, 499}});
+    // Segments cannot be split without keyframes
+    KeyframeIndex intraOnly({0});
+    REQUIRE(ProxyScheduler::splitSegments(500, intraOnly, 3) == Segments{{0, 499}});
+    REQUIRE(ProxyScheduler::splitSegments(0, index, 3).isEmpty());
+}
+
+TEST_CASE("Proxy segment times")
+{
+    using Segments = QVector<std::pair<int, int>>;
+    KeyframeIndex index({0, 100, 240, 260, 400});
+    const double projectFps = 25.;
+    const Segments segments = ProxyScheduler::splitSegments(500, index, 4);
+    // Each frame of a source with a different frame rate is encoded in exactly one part
+    for (double sourceFps : {50., 24000. / 1001., 25.}) {
+        const int sourceFrames = int(500 / projectFps * sourceFps);
+        int total = 0;
+        for (int i = 0; i < segments.count(); ++i) {
+            const std::pair<double, double> times = ProxyScheduler::segmentTimes(segments.at(i), projectFps);
+            const bool last = i + 1 == segments.count();
+            int frames = 0;
+            for (int frame = 0; frame < sourceFrames; ++frame) {
+                const double pts = frame / sourceFps;
+                if (pts >= times.first && (last || pts < times.second)) {
+                    frames++;
+                }
+            }
+            const int expected = qRound((segments.at(i).second - segments.at(i).first + 1) / projectFps * sourceFps);
+            REQUIRE(qAbs(frames - expected) <= 1);
+            total += frames;
+        }
+        REQUIRE(total == sourceFrames);
+    }
+    // Consecutive segments are contiguous
+    REQUIRE(ProxyScheduler::segmentTimes(segments.at(0), projectFps).second == ProxyScheduler::segmentTimes(segments.at(1), projectFps).first);
+    REQUIRE(ProxyScheduler::segmentTimes(segments.at(0), projectFps).first == 0.);
+}
+
+TEST_CASE("Proxy encoding slots")
+{
+    ProxyScheduler scheduler;
+    const int limit = scheduler.limit();
+    REQUIRE(limit >= 1);
+    REQUIRE(limit <= ProxyScheduler::maximumConcurrency());
+    for (int i = 0; i < limit; ++i) {
+        REQUIRE(scheduler.tryAcquire(false));
+    }
+    REQUIRE_FALSE(scheduler.tryAcquire(false));
+    QAtomicInt canceled(1);
+    REQUIRE_FALSE(scheduler.acquire(false, canceled));
+    scheduler.release(false);
+    REQUIRE(scheduler.tryAcquire(false));
+    for (int i = 0; i < limit; ++i) {
+        scheduler.release(false);
+    }
+
+    SECTION("The limit follows the throughput")
+    {
+        if (ProxyScheduler::maximumConcurrency() >= limit + 2) {
+            // One more process is tried while it increases the throughput
+            REQUIRE(scheduler.adjustLimit(100) == limit + 1);
+            REQUIRE(scheduler.adjustLimit(150) == limit + 2);
+            // No gain, go back to the previous limit and keep it
+            REQUIRE(scheduler.adjustLimit(150) == limit + 1);
+            REQUIRE(scheduler.adjustLimit(150) == limit + 1);
+            // The throughput dropped below the one measured with more processes
+            REQUIRE(scheduler.adjustLimit(110) == limit + 2);
+        }
+    }
+}
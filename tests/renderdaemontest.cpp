@@ -0,0 +1,179 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "renderer/renderdaemon.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QTemporaryDir>
+#include <map>
+
+namespace {
+/** @brief A local socket keeping the JSON messages it receives */
+class Peer : public QObject
+{
+public:
+    explicit Peer(const QString &serverName)
+    {
+        connect(&socket, &QLocalSocket::readyRead, this, [this]() { RenderDaemon::readJson(&socket, [this](const QJsonObject &json) { messages << json; }); });
+        socket.connectToServer(serverName);
+        REQUIRE(socket.waitForConnected(5000));
+    }
+    /** @brief The arguments of the received @param method messages */
+    QList<QJsonObject> received(const QString &method) const
+    {
+        QList<QJsonObject> result;
+        for (const QJsonObject &message : messages) {
+            if (message.contains(method)) {
+                result << message.value(method).toObject();
+            }
+        }
+        return result;
+    }
+    void send(const QString &method, const QJsonObject &args) { RenderDaemon::send(&socket, method, args); }
+
+    QLocalSocket socket;
+    QList<QJsonObject> messages;
+};
+
+/** @brief Render daemon using in process fake workers */
+class TestDaemon : public RenderDaemon
+{
+public:
+    using RenderDaemon::RenderDaemon;
+    /** @brief The worker which received the render request of @param output */
+    Peer *workerFor(const QString &output) const
+    {
+        for (const auto &worker : workers) {
+            for (const QJsonObject &request : worker.second->received(QStringLiteral("render"))) {
+                if (request.value(QLatin1String("output")).toString() == output) {
+                    return worker.second.get();
+                }
+            }
+        }
+        return nullptr;
+    }
+    std::map<int, std::unique_ptr<Peer>> workers;
+
+protected:
+    void startWorker(int id) override
+    {
+        workers[id] = std::make_unique<Peer>(workerServerName());
+        QJsonObject args;
+        args[QLatin1String("id")] = id;
+        workers[id]->send(QStringLiteral("worker"), args);
+    }
+};
+
+QJsonObject renderRequest(const QString &id, const QString &source, const QString &output)
+{
+    QJsonObject request;
+    request[QLatin1String("id")] = id;
+    request[QLatin1String("source")] = source;
+    request[QLatin1String("output")] = output;
+    return request;
+}
+
+QJsonObject jobResult(const QString &output, int status)
+{
+    QJsonObject args;
+    args[QLatin1String("url")] = output;
+    args[QLatin1String("status")] = status;
+    return args;
+}
+} // namespace
+
+TEST_CASE("Render daemon job dispatch", "[RenderDaemon]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const QString source = dir.filePath(QStringLiteral("project.mlt"));
+    QFile file(source);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.write("<mlt><profile width=\"320\" height=\"240\"/><consumer mlt_service=\"avformat\" target=\"old.mp4\" vcodec=\"libx264\" in=\"5\"/>"
+               "<producer id=\"black\"><property name=\"mlt_service\">color</property></producer></mlt>");
+    file.close();
+    const QString outputA = dir.filePath(QStringLiteral("a.mp4"));
+    const QString outputB = dir.filePath(QStringLiteral("b.mp4"));
+    const QString outputC = dir.filePath(QStringLiteral("c.mp4"));
+
+    TestDaemon daemon(QStringLiteral("kdenlive-renderdaemon-test-%1").arg(QCoreApplication::applicationPid()), 2, false);
+    REQUIRE(daemon.isListening());
+    Peer client(QStringLiteral("kdenlive-renderdaemon-test-%1").arg(QCoreApplication::applicationPid()));
+    QJsonObject request = renderRequest(QStringLiteral("a"), source, outputA);
+    request[QLatin1String("preset")] = QStringLiteral("f=mp4 acodec=aac");
+    request[QLatin1String("out")] = 50;
+    client.send(QStringLiteral("render"), request);
+    client.send(QStringLiteral("render"), renderRequest(QStringLiteral("b"), source, outputB));
+    client.send(QStringLiteral("render"), renderRequest(QStringLiteral("c"), source, outputC));
+
+    // Only two workers for three jobs
+    REQUIRE(waitFor([&]() { return client.received(QStringLiteral("queued")).count() == 3 && daemon.workerFor(outputA) && daemon.workerFor(outputB); }));
+    REQUIRE(daemon.workers.size() == 2);
+    REQUIRE(daemon.workerFor(outputC) == nullptr);
+    Peer *workerA = daemon.workerFor(outputA);
+    Peer *workerB = daemon.workerFor(outputB);
+    REQUIRE(workerA != workerB);
+
+    // The consumer of the playlist is merged with the preset and the request
+    const QJsonObject render = workerA->received(QStringLiteral("render")).first();
+    REQUIRE(render.value(QLatin1String("service")).toString() == QStringLiteral("avformat"));
+    const QJsonObject properties = render.value(QLatin1String("properties")).toObject();
+    REQUIRE(properties.value(QLatin1String("vcodec")).toString() == QStringLiteral("libx264"));
+    REQUIRE(properties.value(QLatin1String("f")).toString() == QStringLiteral("mp4"));
+    REQUIRE_FALSE(properties.contains(QLatin1String("target")));
+    REQUIRE(render.value(QLatin1String("in")).toInt() == 5);
+    REQUIRE(render.value(QLatin1String("out")).toInt() == 50);
+    const QString playlist = render.value(QLatin1String("playlist")).toString();
+    REQUIRE(QFile::exists(playlist));
+
+    // Progress and results are sent to the client, the worker then gets the queued job
+    QJsonObject progress;
+    progress[QLatin1String("url")] = outputA;
+    progress[QLatin1String("progress")] = 50;
+    progress[QLatin1String("frame")] = 25;
+    workerA->send(QStringLiteral("setRenderingProgress"), progress);
+    workerA->send(QStringLiteral("setRenderingFinished"), jobResult(outputA, -1));
+    REQUIRE(waitFor([&]() { return daemon.workerFor(outputC) == workerA; }));
+    REQUIRE(client.received(QStringLiteral("progress")).count() == 1);
+    REQUIRE(client.received(QStringLiteral("progress")).first().value(QLatin1String("id")).toString() == QStringLiteral("a"));
+    REQUIRE(client.received(QStringLiteral("progress")).first().value(QLatin1String("progress")).toInt() == 50);
+    REQUIRE(client.received(QStringLiteral("finished")).first().value(QLatin1String("result")).toString() == QStringLiteral("done"));
+    REQUIRE_FALSE(QFile::exists(playlist));
+    REQUIRE(daemon.workers.size() == 2);
+
+    // Aborting a running job goes through its worker
+    QJsonObject abort;
+    abort[QLatin1String("id")] = QStringLiteral("b");
+    client.send(QStringLiteral("abort"), abort);
+    REQUIRE(waitFor([&]() { return !workerB->received(QStringLiteral("abort")).isEmpty(); }));
+    REQUIRE(workerB->received(QStringLiteral("abort")).first().value(QLatin1String("url")).toString() == outputB);
+    workerB->send(QStringLiteral("setRenderingFinished"), jobResult(outputB, -3));
+    REQUIRE(waitFor([&]() { return client.received(QStringLiteral("finished")).count() == 2; }));
+    REQUIRE(client.received(QStringLiteral("finished")).last().value(QLatin1String("result")).toString() == QStringLiteral("aborted"));
+
+    // A crashing worker only fails its job
+    workerA->socket.abort();
+    REQUIRE(waitFor([&]() { return client.received(QStringLiteral("finished")).count() == 3; }));
+    const QJsonObject failed = client.received(QStringLiteral("finished")).last();
+    REQUIRE(failed.value(QLatin1String("id")).toString() == QStringLiteral("c"));
+    REQUIRE(failed.value(QLatin1String("result")).toString() == QStringLiteral("failed"));
+
+    // The next job uses the idle worker, no new worker is started
+    const QString outputD = dir.filePath(QStringLiteral("d.mp4"));
+    client.send(QStringLiteral("render"), renderRequest(QStringLiteral("d"), source, outputD));
+    REQUIRE(waitFor([&]() { return daemon.workerFor(outputD) == workerB; }));
+    REQUIRE(daemon.workers.size() == 2);
+
+    // Unknown jobs and invalid sources are reported
+    abort[QLatin1String("id")] = QStringLiteral("unknown");
+    client.send(QStringLiteral("abort"), abort);
+    client.send(QStringLiteral("render"), renderRequest(QStringLiteral("e"), dir.filePath(QStringLiteral("missing.mlt")), outputC));
+    REQUIRE(waitFor([&]() { return client.received(QStringLiteral("error")).count() == 2; }));
+}
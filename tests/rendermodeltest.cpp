@@ -9,6 +9,8 @@
 #include "renderpresets/renderpresetmodel.hpp"
 #include "renderpresets/renderpresetrepository.hpp"
 
+#include <QThread>
+
 TEST_CASE("Basic tests of the render preset model", "[RenderPresets]")
 {
 
@@ -279,3 +281,74 @@ TEST_CASE("Tests of the render functions to use guides for sections", "[RenderRe
         CHECK(sections.at(2).second == out);
     }
 }
+
+TEST_CASE("Estimate render job thread usage", "[RenderRequestThreads]")
+{
+    const int maxThreads = QThread::idealThreadCount();
+    QDomDocument doc;
+    QDomElement consumer = doc.createElement(QStringLiteral("consumer"));
+
+    SECTION("Audio only render uses one core")
+    {
+        consumer.setAttribute(QStringLiteral("real_time"), -4);
+        consumer.setAttribute(QStringLiteral("threads"), 8);
+        consumer.setAttribute(QStringLiteral("vn"), 1);
+        CHECK(RenderRequest::consumerThreads(consumer) == 1);
+    }
+
+    SECTION("Processing and encoding threads")
+    {
+        consumer.setAttribute(QStringLiteral("real_time"), -1);
+        consumer.setAttribute(QStringLiteral("threads"), 1);
+        CHECK(RenderRequest::consumerThreads(consumer) == 1);
+        consumer.setAttribute(QStringLiteral("real_time"), -2);
+        CHECK(RenderRequest::consumerThreads(consumer) == qMin(2, maxThreads));
+        consumer.setAttribute(QStringLiteral("threads"), 0);
+        // Automatic encoding threads
+        CHECK(RenderRequest::consumerThreads(consumer) == qMin(16, maxThreads));
+        consumer.setAttribute(QStringLiteral("threads"), 1000);
+        CHECK(RenderRequest::consumerThreads(consumer) == maxThreads);
+    }
+}
+
+TEST_CASE("Split render range in segments", "[RenderRequestSegments]")
+{
+    SECTION("Segments start on GOP boundaries")
+    {
+        QVector<std::pair<int, int>> ranges = RenderRequest::segmentRanges(0, 999, 4, 25);
+        REQUIRE(ranges.size() == 4);
+        CHECK(ranges.at(0) == std::make_pair(0, 249));
+        CHECK(ranges.at(1) == std::make_pair(250, 499));
+        CHECK(ranges.at(3) == std::make_pair(750, 999));
+
+        ranges = RenderRequest::segmentRanges(10, 1009, 3, 25);
+        REQUIRE(ranges.size() == 3);
+        CHECK(ranges.at(0) == std::make_pair(10, 359));
+        CHECK(ranges.at(1) == std::make_pair(360, 709));
+        CHECK(ranges.at(2) == std::make_pair(710, 1009));
+    }
+
+    SECTION("Short ranges are not split below the GOP size")
+    {
+        QVector<std::pair<int, int>> ranges = RenderRequest::segmentRanges(0, 99, 8, 25);
+        REQUIRE(ranges.size() == 4);
+        CHECK(ranges.at(3) == std::make_pair(75, 99));
+        ranges = RenderRequest::segmentRanges(0, 40, 8, 25);
+        REQUIRE(ranges.size() == 1);
+        CHECK(ranges.at(0) == std::make_pair(0, 40));
+        ranges = RenderRequest::segmentRanges(0, 1000, 1, 25);
+        REQUIRE(ranges.size() == 1);
+    }
+
+    SECTION("Long renders are split in checkpoints")
+    {
+        CHECK(RenderRequest::segmentCount(1000, 1, 0) == 1);
+        CHECK(RenderRequest::segmentCount(1000, 4, 0) == 4);
+        // Shorter than two checkpoints
+        CHECK(RenderRequest::segmentCount(1000, 1, 600) == 1);
+        CHECK(RenderRequest::segmentCount(1200, 1, 600) == 2);
+        CHECK(RenderRequest::segmentCount(6100, 1, 600) == 10);
+        // More segments were requested
+        CHECK(RenderRequest::segmentCount(1200, 4, 600) == 4);
+    }
+}
@@ -0,0 +1,174 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/scenedetection/scenedetector.h"
+#include "jobs/scenedetection/scenescores.h"
+
+#include <QFile>
+#include <QMutex>
+#include <QTemporaryDir>
+#include <algorithm>
+
+namespace {
+/** @brief Collects the progress reported by the scanning threads, checked later from the test thread */
+class ProgressRecorder
+{
+public:
+    std::function<void(int)> callback()
+    {
+        return [this](int progress) {
+            QMutexLocker lock(&m_mutex);
+            m_values.append(progress);
+        };
+    }
+    bool isValid()
+    {
+        QMutexLocker lock(&m_mutex);
+        return std::all_of(m_values.cbegin(), m_values.cend(), [](int progress) { return progress >= 0 && progress <= 100; });
+    }
+    int last()
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_values.isEmpty() ? -1 : m_values.last();
+    }
+
+private:
+    QMutex m_mutex;
+    QVector<int> m_values;
+};
+} // namespace
+
+TEST_CASE("planeSad", "[SceneDetection]")
+{
+    // 37 pixels wide, to test both the vectorized and the remaining pixels
+    const int width = 37;
+    const int height = 3;
+    const int stride = 48;
+    std::vector<uint8_t> a(stride * height, 0);
+    std::vector<uint8_t> b(stride * height, 0);
+    uint64_t expected = 0;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            a[y * stride + x] = uint8_t((x * 7 + y * 13) % 256);
+            b[y * stride + x] = uint8_t((x * 11 + y * 3) % 256);
+            expected += uint64_t(std::abs(int(a[y * stride + x]) - int(b[y * stride + x])));
+        }
+        // Padding must be ignored
+        a[y * stride + width] = 255;
+    }
+    REQUIRE(planeSad(a.data(), stride, b.data(), stride, width, height) == expected);
+    REQUIRE(planeSad(a.data(), stride, a.data(), stride, width, height) == 0);
+}
+
+TEST_CASE("sceneScore", "[SceneDetection]")
+{
+    double previousMafd = 0.;
+    // Identical frames
+    REQUIRE(sceneScore(0, 100, previousMafd) == 0.);
+    // Complete change, from black to white
+    REQUIRE(sceneScore(255 * 100, 100, previousMafd) == 1.);
+    REQUIRE(previousMafd == 255.);
+    // Same amount of motion as the previous frame is not a scene change
+    REQUIRE(sceneScore(255 * 100, 100, previousMafd) == 0.);
+    REQUIRE(sceneScore(0, 0, previousMafd) == 0.);
+}
+
+TEST_CASE("Scene detection with libav", "[SceneDetection]")
+{
+    QList<double> results;
+    ProgressRecorder progress;
+    SECTION("Single color clip has no scene change")
+    {
+        REQUIRE(detectScenesLibav(sourcesPath + "/dataset/red.mp4", 0.1, 4, progress.callback(), 0, results));
+        REQUIRE(results.isEmpty());
+        REQUIRE(progress.isValid());
+    }
+    SECTION("Long file scanned in several ranges")
+    {
+        // 96 seconds, scenes start at 32 and 64 seconds, which are also the limits of the 3 scanned ranges
+        REQUIRE(detectScenesLibav(sourcesPath + "/dataset/scenes.y4m", 0.3, 4, progress.callback(), 0, results));
+        REQUIRE(results == QList<double>{32., 64.});
+        REQUIRE(progress.isValid());
+        REQUIRE(progress.last() == 100);
+        // Same result with a single range
+        QList<double> single;
+        REQUIRE(detectScenesLibav(sourcesPath + "/dataset/scenes.y4m", 0.3, 1, progress.callback(), 0, single));
+        REQUIRE(single == results);
+        // Every frame but the first one is scored once, the first frame of the other ranges is compared with the preroll
+        SceneScores scores;
+        REQUIRE(sceneScoresLibav(sourcesPath + "/dataset/scenes.y4m", 4, progress.callback(), 0, scores));
+        REQUIRE(scores.count() == 95);
+    }
+    SECTION("Invalid file")
+    {
+        REQUIRE_FALSE(detectScenesLibav(sourcesPath + "/dataset/missing.mp4", 0.1, 4, progress.callback(), 0, results));
+    }
+    SECTION("Audio only file")
+    {
+        REQUIRE_FALSE(detectScenesLibav(sourcesPath + "/dataset/mono.flac", 0.1, 4, progress.callback(), 0, results));
+    }
+}
+
+TEST_CASE("Scene scores cache", "[SceneDetection]")
+{
+    SceneScores scores;
+    scores.append(0.04, 0.);
+    scores.append(0.08, 0.35);
+    scores.append(0.12, 0.05);
+    scores.append(0.16, 0.8);
+    REQUIRE(scores.count() == 4);
+
+    SECTION("Any threshold can be used")
+    {
+        REQUIRE(scores.scenes(0.3) == QList<double>{0.08, 0.16});
+        REQUIRE(scores.scenes(0.5) == QList<double>{0.16});
+        REQUIRE(scores.scenes(0.9).isEmpty());
+        // Scores are saturated
+        scores.append(0.2, 2.);
+        REQUIRE(scores.scenes(0.99) == QList<double>{0.2});
+    }
+
+    SECTION("Scores of consecutive ranges are joined")
+    {
+        SceneScores next;
+        next.append(0.2, 0.6);
+        scores.append(next);
+        REQUIRE(scores.count() == 5);
+        REQUIRE(scores.scenes(0.5) == QList<double>{0.16, 0.2});
+    }
+
+    SECTION("Save and load")
+    {
+        QTemporaryDir dir;
+        REQUIRE(dir.isValid());
+        const QString path = dir.filePath(QStringLiteral("scenes.dat"));
+        REQUIRE(SceneScores::load(path) == nullptr);
+        REQUIRE(scores.save(path));
+        std::shared_ptr<SceneScores> loaded = SceneScores::load(path);
+        REQUIRE(loaded != nullptr);
+        REQUIRE(loaded->count() == 4);
+        REQUIRE(loaded->scenes(0.3) == scores.scenes(0.3));
+        // Invalid file
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("invalid");
+        file.close();
+        REQUIRE(SceneScores::load(path) == nullptr);
+    }
+
+    SECTION("Scores of a media file")
+    {
+        SceneScores fileScores;
+        ProgressRecorder progress;
+        REQUIRE(sceneScoresLibav(sourcesPath + "/dataset/red.mp4", 4, progress.callback(), 0, fileScores));
+        REQUIRE(progress.isValid());
+        REQUIRE_FALSE(fileScores.isEmpty());
+        REQUIRE(fileScores.scenes(0.1).isEmpty());
+    }
+}
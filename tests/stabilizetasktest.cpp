@@ -0,0 +1,96 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "jobs/stabilizetask.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+void writeMotionFile(const QString &path, int first, int count)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly | QIODevice::Text));
+    file.write("VID.STAB 1\n#      accuracy = 15\n");
+    for (int i = 0; i < count; ++i) {
+        file.write(QStringLiteral("Frame %1 (List 1 [(LM 0 0 %2 0 112 0.5 0.1)])\n").arg(first + i).arg(first + i).toUtf8());
+    }
+}
+} // namespace
+
+TEST_CASE("Segmented stabilization analysis")
+{
+    SECTION("Segments cover the range and overlap by one frame")
+    {
+        const QVector<StabilizeTask::AnalysisSegment> segments = StabilizeTask::analysisSegments(10, 309, 3);
+        REQUIRE(segments.count() == 3);
+        REQUIRE(segments.at(0).in == 10);
+        REQUIRE(segments.at(0).out == 109);
+        REQUIRE(segments.at(0).overlap == 0);
+        REQUIRE(segments.at(1).in == 109);
+        REQUIRE(segments.at(1).out == 209);
+        REQUIRE(segments.at(1).overlap == 1);
+        REQUIRE(segments.at(2).in == 209);
+        REQUIRE(segments.at(2).out == 309);
+        // Never more segments than frames
+        REQUIRE(StabilizeTask::analysisSegments(0, 1, 4).count() == 2);
+        REQUIRE(StabilizeTask::analysisSegments(5, 4, 2).isEmpty());
+    }
+
+    SECTION("Long clips are split unless a tripod frame is used")
+    {
+        std::unordered_map<QString, QVariant> params = {{QStringLiteral("shakiness"), 4}, {QStringLiteral("tripod"), 0}};
+        // 10 minutes at 25 fps
+        REQUIRE(StabilizeTask::analysisSegmentCount(0, 14999, 25., 4, params) == 4);
+        REQUIRE(StabilizeTask::analysisSegmentCount(0, 14999, 25., 16, params) == 10);
+        // Shorter than two minimum segments
+        REQUIRE(StabilizeTask::analysisSegmentCount(0, 2000, 25., 4, params) == 1);
+        params[QStringLiteral("tripod")] = 12;
+        REQUIRE(StabilizeTask::analysisSegmentCount(0, 14999, 25., 4, params) == 1);
+    }
+
+    SECTION("Motion data is merged and renumbered")
+    {
+        QTemporaryDir dir;
+        REQUIRE(dir.isValid());
+        const QVector<StabilizeTask::AnalysisSegment> segments = StabilizeTask::analysisSegments(0, 9, 2);
+        // Each process numbers its frames from 1
+        const QStringList files = {dir.filePath(QStringLiteral("0.trf")), dir.filePath(QStringLiteral("1.trf"))};
+        writeMotionFile(files.at(0), 1, 5);
+        writeMotionFile(files.at(1), 1, 6);
+        const QString merged = dir.filePath(QStringLiteral("merged.trf"));
+        REQUIRE(StabilizeTask::mergeMotionData(files, segments, merged));
+
+        QFile file(merged);
+        REQUIRE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        // Header, settings, 10 frames and the final empty line
+        REQUIRE(lines.count() == 13);
+        REQUIRE(lines.at(0) == QByteArray("VID.STAB 1"));
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(lines.at(i + 2).startsWith(QStringLiteral("Frame %1 (").arg(i + 1).toUtf8()));
+        }
+        // The overlapping frame of the second segment is dropped
+        REQUIRE(lines.at(6).contains("(LM 0 0 5 0"));
+        REQUIRE(lines.at(7).contains("(LM 0 0 2 0"));
+    }
+
+    SECTION("An incomplete analysis is rejected")
+    {
+        QTemporaryDir dir;
+        REQUIRE(dir.isValid());
+        const QVector<StabilizeTask::AnalysisSegment> segments = StabilizeTask::analysisSegments(0, 9, 2);
+        const QStringList files = {dir.filePath(QStringLiteral("0.trf")), dir.filePath(QStringLiteral("1.trf"))};
+        writeMotionFile(files.at(0), 1, 5);
+        writeMotionFile(files.at(1), 1, 3);
+        const QString merged = dir.filePath(QStringLiteral("merged.trf"));
+        REQUIRE_FALSE(StabilizeTask::mergeMotionData(files, segments, merged));
+        REQUIRE_FALSE(QFile::exists(merged));
+    }
+}
@@ -8,8 +8,27 @@
 #include "doc/kdenlivedoc.h"
 #include "src/assets/keyframes/model/keyframemodel.hpp"
 #include "src/renderpresets/renderpresetrepository.hpp"
+#include "src/utils/filehashcache.hpp"
 #include "src/utils/thumbnailcache.hpp"
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+
+bool waitFor(const std::function<bool()> &condition, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeout) {
+            return false;
+        }
+        QCoreApplication::processEvents();
+        QThread::msleep(10);
+    }
+    return true;
+}
+
 QString KdenliveTests::createProducer(Mlt::Profile &prof, std::string color, std::shared_ptr<ProjectItemModel> binModel, int length, bool limited)
 {
     std::shared_ptr<Mlt::Producer> producer = std::make_shared<Mlt::Producer>(prof, "color", color.c_str());
@@ -233,6 +252,11 @@ int KdenliveTests::groupsCount(std::shared_ptr<TimelineItemModel> timeline)
     return timeline->m_allGroups.size();
 }
 
+int KdenliveTests::blackTrackDuration(std::shared_ptr<TimelineItemModel> timeline)
+{
+    return timeline->m_blackClip->get_playtime() - TimelineModel::seekDuration - 1;
+}
+
 std::unordered_map<int, int> KdenliveTests::groupUpLink(std::shared_ptr<TimelineItemModel> timeline)
 {
     return timeline->m_groups->m_upLink;
@@ -292,3 +316,13 @@ bool KdenliveTests::effectFilterName(EffectFilter &filter, std::shared_ptr<TreeI
 {
     return filter.filterName(item);
 }
+
+void KdenliveTests::setFileHashCacheFile(const QString &path)
+{
+    QMutexLocker lock(&FileHashCache::get()->m_mutex);
+    FileHashCache::get()->m_cacheFile = path;
+    FileHashCache::get()->m_entries.clear();
+    FileHashCache::get()->m_folders.clear();
+    FileHashCache::get()->m_loaded = false;
+    FileHashCache::get()->m_dirty = false;
+}
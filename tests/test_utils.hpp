@@ -8,6 +8,7 @@
 #include "catch.hpp"
 #include "tests_definitions.h"
 #include <QString>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <random>
@@ -91,6 +92,9 @@ using namespace fakeit;
         .Exactly(1);                                                                                                                                           \
     NO_OTHERS();
 
+/** @brief Process the events until @param condition is true, returns false after @param timeout milliseconds */
+bool waitFor(const std::function<bool()> &condition, int timeout = 10000);
+
 class KdenliveTests
 {
 public:
@@ -131,6 +135,7 @@ public:
     static bool removeAllKeyframes(std::shared_ptr<KeyframeModel> model);
     static void forceClipAudio(std::shared_ptr<TimelineItemModel> timeline, int clipId);
     static int groupsCount(std::shared_ptr<TimelineItemModel> timeline);
+    static int blackTrackDuration(std::shared_ptr<TimelineItemModel> timeline);
     static std::unordered_map<int, int> groupUpLink(std::shared_ptr<TimelineItemModel> timeline);
     static void setGroupType(std::shared_ptr<TimelineItemModel> timeline, int gid, GroupType type);
     static std::shared_ptr<TimelineItemModel> createTimelineModel(const QUuid uuid, std::shared_ptr<DocUndoStack> undoStack);
@@ -143,4 +148,6 @@ public:
     static bool checkModelConsistency(std::shared_ptr<AbstractTreeModel> model);
     static int modelSize(std::shared_ptr<AbstractTreeModel> model);
     static bool effectFilterName(EffectFilter &filter, std::shared_ptr<TreeItem> item);
+    /** @brief Keep the file hashes in @param path instead of the user's cache */
+    static void setFileHashCacheFile(const QString &path);
 };
@@ -0,0 +1,126 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+// test specific headers
+#include "doc/docundostack.hpp"
+#include "doc/kdenlivedoc.h"
+#ifdef CRASH_AUTO_TEST
+#include "logger.hpp"
+#endif
+
+#include <QElapsedTimer>
+#include <iostream>
+
+/* These test cases are benchmarks, they are hidden by default and are not run as part of the test suite.
+   Run them with: timelinebenchmark "[benchmark]"
+ */
+
+TEST_CASE("Timeline model queries on a large timeline", "[.][benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack, {2, 10});
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    QString binId = KdenliveTests::createProducer(pCore->getProjectProfile(), "red", binModel, 20, false);
+
+    // Build a 10k clips timeline: 10 video tracks of 1000 clips
+    const int clipsPerTrack = 1000;
+    std::vector<int> clips;
+    clips.reserve(size_t(10 * clipsPerTrack));
+    for (int t = 0; t < timeline->getTracksCount(); ++t) {
+        int tid = timeline->getTrackIndexFromPosition(t);
+        if (timeline->isAudioTrack(tid)) {
+            continue;
+        }
+        for (int i = 0; i < clipsPerTrack; ++i) {
+            int cid = -1;
+            REQUIRE(timeline->requestClipInsertion(binId, tid, i * 20, cid, false));
+            clips.push_back(cid);
+        }
+    }
+    REQUIRE(timeline->getClipsCount() == int(clips.size()));
+
+    // Roles queried by the clip delegates when the timeline view is repainted
+    const QVector<int> repaintRoles = {TimelineModel::StartRole,    TimelineModel::DurationRole, TimelineModel::TrackIdRole, TimelineModel::InPointRole,
+                                       TimelineModel::OutPointRole, TimelineModel::NameRole,     TimelineModel::SelectedRole, TimelineModel::GroupedRole,
+                                       TimelineModel::FakePositionRole, TimelineModel::FakeTrackIdRole};
+    const int passes = 10;
+    QElapsedTimer timer;
+
+    timer.start();
+    qint64 checksum = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int cid : clips) {
+            const QModelIndex ix = timeline->makeClipIndexFromID(cid);
+            for (int role : repaintRoles) {
+                checksum += timeline->data(ix, role).toInt();
+            }
+        }
+    }
+    qint64 elapsed = timer.nsecsElapsed();
+    const qint64 queries = qint64(passes) * qint64(clips.size()) * repaintRoles.size();
+    std::cout << "Model data() queries: " << queries << ", " << (elapsed / queries) << " ns per query, " << (elapsed / passes / 1000000)
+              << " ms per repaint (checksum " << checksum << ")" << std::endl;
+
+    timer.restart();
+    checksum = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int cid : clips) {
+            checksum += timeline->getClipPosition(cid) + timeline->getClipPlaytime(cid) + timeline->getClipTrackId(cid) + timeline->getClipIn(cid);
+        }
+    }
+    elapsed = timer.nsecsElapsed();
+    const qint64 getters = qint64(passes) * qint64(clips.size()) * 4;
+    std::cout << "Direct getters: " << getters << ", " << (elapsed / getters) << " ns per call (checksum " << checksum << ")" << std::endl;
+
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
+
+TEST_CASE("Model trace overhead", "[.][benchmark]")
+{
+    auto binModel = pCore->projectItemModel();
+    binModel->clean();
+    std::shared_ptr<DocUndoStack> undoStack = std::make_shared<DocUndoStack>(nullptr);
+
+    KdenliveDoc document(undoStack, {0, 1});
+    pCore->projectManager()->testSetDocument(&document);
+    QDateTime documentDate = QDateTime::currentDateTime();
+    KdenliveTests::updateTimeline(false, QString(), QString(), documentDate, 0);
+    auto timeline = document.getTimeline(document.uuid());
+    pCore->projectManager()->testSetActiveTimeline(timeline);
+
+    // addSnap and removeSnap are traced and do very little work, so their cost is dominated by the trace instrumentation
+    const int calls = 200000;
+    auto measure = [&timeline]() {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < calls; ++i) {
+            timeline->addSnap(i % 1000);
+            timeline->removeSnap(i % 1000);
+        }
+        return timer.nsecsElapsed() / (2 * qint64(calls));
+    };
+
+#ifdef CRASH_AUTO_TEST
+    Logger::setEnabled(false);
+    std::cout << "Traced call, logger disabled: " << measure() << " ns per call" << std::endl;
+    Logger::setEnabled(true);
+    std::cout << "Traced call, logger enabled: " << measure() << " ns per call" << std::endl;
+    Logger::setEnabled(false);
+    Logger::clear();
+#else
+    std::cout << "Traced call, tracing compiled out: " << measure() << " ns per call" << std::endl;
+#endif
+
+    pCore->projectManager()->closeCurrentDocument(false, false);
+}
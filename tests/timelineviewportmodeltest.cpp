@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "timeline2/model/timelinemodel.hpp"
+#include "timeline2/view/timelineviewportmodel.h"
+
+#include <QStandardItemModel>
+
+namespace {
+QStandardItem *addClip(QStandardItem *track, int start, int duration)
+{
+    auto *clip = new QStandardItem();
+    clip->setData(start, TimelineModel::StartRole);
+    clip->setData(duration, TimelineModel::DurationRole);
+    clip->setData(false, TimelineModel::SelectedRole);
+    clip->setData(false, TimelineModel::GrabbedRole);
+    track->appendRow(clip);
+    return clip;
+}
+
+/** @brief The start of the clips of @param track accepted by the @param proxy */
+QList<int> visibleClips(const TimelineViewportModel &proxy, int track)
+{
+    QList<int> starts;
+    const QModelIndex trackIndex = proxy.index(track, 0);
+    for (int i = 0; i < proxy.rowCount(trackIndex); ++i) {
+        starts << proxy.data(proxy.index(i, 0, trackIndex), TimelineModel::StartRole).toInt();
+    }
+    return starts;
+}
+} // namespace
+
+TEST_CASE("Timeline viewport filtering", "[Viewport]")
+{
+    // The model has the same two levels as the timeline: tracks, then clips and compositions
+    QStandardItemModel source;
+    auto *videoTrack = new QStandardItem();
+    auto *audioTrack = new QStandardItem();
+    source.appendRow(videoTrack);
+    source.appendRow(audioTrack);
+    addClip(videoTrack, 0, 50);
+    addClip(videoTrack, 100, 50);
+    QStandardItem *farClip = addClip(videoTrack, 1000, 100);
+    QStandardItem *lastClip = addClip(videoTrack, 5000, 10);
+    addClip(audioTrack, 5000, 10);
+
+    TimelineViewportModel proxy;
+    proxy.setSourceModel(&source);
+
+    // No range was set yet, everything is accepted
+    REQUIRE(proxy.rowCount() == 2);
+    REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100, 1000, 5000}));
+    REQUIRE(visibleClips(proxy, 1) == QList<int>({5000}));
+
+    // One view width of margin on each side, so frames 0 to 300
+    proxy.setVisibleRange(100, 200);
+    // Tracks are never filtered, even when all their clips are
+    REQUIRE(proxy.rowCount() == 2);
+    REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100}));
+    REQUIRE(visibleClips(proxy, 1).isEmpty());
+
+    SECTION("Selected and grabbed clips are always accepted")
+    {
+        lastClip->setData(true, TimelineModel::SelectedRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100, 5000}));
+        farClip->setData(true, TimelineModel::GrabbedRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100, 1000, 5000}));
+        // A moved clip keeps its delegate while grabbed
+        farClip->setData(3000, TimelineModel::StartRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100, 3000, 5000}));
+
+        lastClip->setData(false, TimelineModel::SelectedRole);
+        farClip->setData(false, TimelineModel::GrabbedRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100}));
+    }
+
+    SECTION("Clips are filtered again when the view leaves the margin")
+    {
+        // Small scrolls stay inside the margin
+        proxy.setVisibleRange(150, 250);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100}));
+
+        // Frames 900 to 1200
+        proxy.setVisibleRange(1000, 1100);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({1000}));
+        // A clip ending in the range is accepted
+        lastClip->setData(850, TimelineModel::StartRole);
+        lastClip->setData(50, TimelineModel::DurationRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({1000, 850}));
+        // Clips moved out of the range are removed
+        farClip->setData(2000, TimelineModel::StartRole);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({850}));
+    }
+
+    SECTION("Invalid ranges are ignored")
+    {
+        proxy.setVisibleRange(500, 100);
+        REQUIRE(visibleClips(proxy, 0) == QList<int>({0, 100}));
+    }
+}
@@ -0,0 +1,144 @@
+/*
+    SPDX-FileCopyrightText: 2026 Kdenlive contributors
+    SPDX-License-Identifier: GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+*/
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+#include "doc/docundostack.hpp"
+#include "kdenlivesettings.h"
+#include "undohelper.hpp"
+
+TEST_CASE("Undo history compaction and memory budget", "[UndoStack]")
+{
+    DocUndoStack stack(nullptr);
+    int value = 0;
+    auto pushIncrement = [&stack, &value](bool mergeable) {
+        value++;
+        Fun undo = [&value]() {
+            value--;
+            return true;
+        };
+        Fun redo = [&value]() {
+            value++;
+            return true;
+        };
+        auto *command = new FunctionalUndoCommand(undo, redo, QStringLiteral("Increment"));
+        command->setMergeable(mergeable);
+        stack.push(command);
+    };
+    const int mergeInterval = KdenliveSettings::undomergeinterval();
+    const int budget = KdenliveSettings::undomemorybudget();
+
+    SECTION("Mergeable commands are compacted")
+    {
+        KdenliveSettings::setUndomergeinterval(60000);
+        for (int i = 0; i < 10; ++i) {
+            pushIncrement(true);
+        }
+        REQUIRE(stack.count() == 1);
+        REQUIRE(value == 10);
+        stack.undo();
+        REQUIRE(value == 0);
+        stack.redo();
+        REQUIRE(value == 10);
+        // Regular commands are not merged
+        pushIncrement(false);
+        pushIncrement(false);
+        REQUIRE(stack.count() == 3);
+        stack.undo();
+        REQUIRE(value == 11);
+    }
+
+    SECTION("Only commands on the same target are merged")
+    {
+        KdenliveSettings::setUndomergeinterval(60000);
+        int first = 0;
+        int second = 0;
+        for (int i = 0; i < 4; ++i) {
+            auto *command = new FunctionalUndoCommand([]() { return true; }, []() { return true; }, QStringLiteral("Update keyframe"));
+            command->setMergeable(true, i % 2 == 0 ? &first : &second);
+            stack.push(command);
+        }
+        REQUIRE(stack.count() == 4);
+        auto *command = new FunctionalUndoCommand([]() { return true; }, []() { return true; }, QStringLiteral("Update keyframe"));
+        command->setMergeable(true, &second);
+        stack.push(command);
+        REQUIRE(stack.count() == 4);
+    }
+
+    SECTION("Only commands with the same key are merged")
+    {
+        KdenliveSettings::setUndomergeinterval(60000);
+        int target = 0;
+        // Updates of two keyframes of the same parameter
+        for (int i = 0; i < 4; ++i) {
+            auto *command = new FunctionalUndoCommand([]() { return true; }, []() { return true; }, QStringLiteral("Update keyframe"));
+            command->setMergeable(true, &target, i < 2 ? 0 : 50);
+            stack.push(command);
+        }
+        REQUIRE(stack.count() == 2);
+    }
+
+    SECTION("Merging can be disabled")
+    {
+        KdenliveSettings::setUndomergeinterval(0);
+        for (int i = 0; i < 10; ++i) {
+            pushIncrement(true);
+        }
+        REQUIRE(stack.count() == 10);
+    }
+
+    SECTION("Oldest steps are discarded over budget")
+    {
+        KdenliveSettings::setUndomergeinterval(0);
+        KdenliveSettings::setUndomemorybudget(0);
+        pushIncrement(false);
+        const size_t commandCost = stack.memoryUsage();
+        REQUIRE(commandCost > 0);
+        // A budget of 1MB fits this number of commands
+        const int fitting = int(1024 * 1024 / commandCost);
+        for (int i = 1; i < fitting + 10; ++i) {
+            pushIncrement(false);
+        }
+        REQUIRE(stack.memoryUsage() > 1024 * 1024);
+        KdenliveSettings::setUndomemorybudget(1);
+        pushIncrement(false);
+        REQUIRE(stack.memoryUsage() <= 1024 * 1024);
+        const int total = value;
+        REQUIRE(stack.count() == total);
+        // Undoing all steps only reverts the ones that were kept, discarded steps are removed
+        while (stack.canUndo()) {
+            stack.undo();
+        }
+        REQUIRE(value > 0);
+        REQUIRE(value == total - stack.count());
+        REQUIRE(stack.count() <= fitting);
+    }
+    SECTION("Discarding stops at the first step that cannot be discarded")
+    {
+        KdenliveSettings::setUndomergeinterval(0);
+        KdenliveSettings::setUndomemorybudget(0);
+        for (int i = 0; i < 5; ++i) {
+            pushIncrement(false);
+        }
+        stack.push(new QUndoCommand(QStringLiteral("Other command")));
+        const size_t commandCost = stack.memoryUsage() / 6;
+        const int fitting = int(1024 * 1024 / commandCost);
+        for (int i = 0; i < fitting + 10; ++i) {
+            pushIncrement(false);
+        }
+        KdenliveSettings::setUndomemorybudget(1);
+        pushIncrement(false);
+        // The oldest steps are discarded, but not the ones after the other command even if the history is still over budget
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(stack.command(i)->isObsolete());
+        }
+        REQUIRE_FALSE(stack.command(5)->isObsolete());
+        REQUIRE_FALSE(stack.command(6)->isObsolete());
+        REQUIRE(stack.memoryUsage() > 1024 * 1024);
+    }
+
+    KdenliveSettings::setUndomergeinterval(mergeInterval);
+    KdenliveSettings::setUndomemorybudget(budget);
+}
@@ -6,10 +6,15 @@
 #include "catch.hpp"
 #include "test_utils.hpp"
 // test specific headers
+#include "utils/filehashcache.hpp"
 #include "utils/gentime.h"
 #include "utils/qstringutils.h"
 #include "utils/timecode.h"
 
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
 TEST_CASE("Testing for different utils", "[Utils]")
 {
 
@@ -31,6 +36,49 @@ TEST_CASE("Testing for different utils", "[Utils]")
 
         REQUIRE(names.removeDuplicates() == 0);
     }
+
+    SECTION("File hash cache returns the same hash as a direct MD5")
+    {
+        const QString path = sourcesPath + QStringLiteral("/small.mkv");
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::ReadOnly));
+        const QByteArray md5 = QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5);
+        file.close();
+        QPair<QByteArray, qint64> hashData = FileHashCache::get()->fileHash(path);
+        REQUIRE(hashData.first == md5);
+        REQUIRE(hashData.second == QFileInfo(path).size());
+        // Second call is served from the cache
+        REQUIRE(FileHashCache::get()->fileHash(path).first == md5);
+        REQUIRE(FileHashCache::get()->fileHash(sourcesPath + QStringLiteral("/missing-file.mkv")).first.isEmpty());
+    }
+
+    SECTION("Folder hash follows the files of the folder")
+    {
+        QTemporaryDir dir;
+        REQUIRE(dir.isValid());
+        const QStringList names = {QStringLiteral("img-001.png"), QStringLiteral("img-002.png"), QStringLiteral("img-003.png")};
+        for (const QString &name : names) {
+            QFile file(dir.filePath(name));
+            REQUIRE(file.open(QIODevice::WriteOnly));
+            file.write(name.toUtf8());
+        }
+        const QString pattern = QStringLiteral("img-%03d.png");
+        const QByteArray hash = FileHashCache::get()->folderHash(QDir(dir.path()), pattern);
+        REQUIRE(!hash.isEmpty());
+        REQUIRE(FileHashCache::get()->folderHash(QDir(dir.path()), pattern) == hash);
+        REQUIRE(FileHashCache::get()->folderHash(QDir(dir.path()), QStringLiteral("img-%04d.png")) != hash);
+        // Same file list and hashes as before the cache
+        QString expected = pattern + names.join(QLatin1Char(','));
+        for (const QString &name : {names.at(0), names.at(1)}) {
+            QFile file(dir.filePath(name));
+            REQUIRE(file.open(QIODevice::ReadOnly));
+            expected.append(QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5));
+            expected.append(QString::number(name.size()));
+        }
+        REQUIRE(hash == QCryptographicHash::hash(expected.toUtf8(), QCryptographicHash::Md5));
+        REQUIRE(QFile::remove(dir.filePath(names.at(2))));
+        REQUIRE(FileHashCache::get()->folderHash(QDir(dir.path()), pattern) != hash);
+    }
 }
 
 TEST_CASE("Testing for GenTime", "[GenTime]")